@@ -0,0 +1,1224 @@
+/****************************************************************
+
+	benchmark.c
+
+	=============================================================
+
+    Copyright 1996-2013 Tom Barbalet. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or
+	sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    This software and Noble Ape are a continuing work of Tom Barbalet,
+    begun on 13 June 1996. No apes or cats were harmed in the writing
+    of this software.
+
+****************************************************************/
+
+/*
+    A headless benchmark of the simulation core. Every run starts from a fixed
+    seed so the state hash at the end only changes when the behaviour of the
+    simulation changes.
+
+    nabenchmark [small|medium|max|brain|kernels|braincode|deaths|land|weather|save|load] [-c cycles] [-b beings] [-s seed] [-t threads] [-w worlds] [-f profile]
+
+    With -w the simulation presets run that many separate worlds, seeded from
+    seed upwards, spread over the threads. Each world gives the same hash as a
+    run of its own seed with no threads.
+
+    With -f 1 the simulation presets run the fast fidelity profile, the
+    slowly changing phases and the sleeping beings less often than every
+    minute, which changes the hash. The brains and dialogues of the sleepers
+    are sampled, not integrated: each has its turn once every eight minutes
+    and the minutes between are dropped, while their metabolism and immune
+    response keep the schedule of the awake. The default, 0, is the full
+    profile.
+
+    The brain preset fills the brains of the population from the seed, as a
+    new simulation starts with empty brains that the brain cycle leaves
+    empty, and gives each brain a random input before each cycle so they
+    don't settle. It fails unless the brains have changed after the cycles.
+
+    The kernels preset compares each vector kernel of the brain cycle that
+    the processor supports with the scalar kernel on a new random brain once a
+    cycle, and fails on the first brain where they differ.
+
+    The braincode preset cycles the simulation and after each cycle runs
+    dialogues between random beings, half of them on new random programs,
+    with the steps decoded in the cycles before and again from the same state
+    with none decoded. It fails on the first dialogue where the beings, their
+    cold parts, social graphs or episodic memories end up differently, and
+    after each cycle and dialogue on any decoded step that differs from the
+    decoding of the bytes it was decoded from.
+
+    The deaths preset cycles the simulation and every tenth cycle kills a few
+    random beings and removes them. It fails unless each being that lives keeps
+    its identity, its brain, episodic memory, cold parts and brain rest, and its
+    social graph apart from the familiarity of the beings that died, and unless
+    the selection stays on the same being when that being lives.
+
+    The weather preset cycles the atmosphere alone with the land and time
+    held still, split over the threads the same way as in the simulation.
+
+    The save preset writes the whole simulation as a text file once a cycle,
+    without the disk, so it times the serialiser alone. The load preset reads
+    that text back once a cycle and fails unless saving the loaded simulation
+    gives the same text again.
+
+    On Linux the cache references and misses over the cycles are read from the
+    hardware counters, they are null where the kernel doesn't allow them.
+*/
+
+#define CONSOLE_ONLY
+#define CONSOLE_REQUIRED
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifndef	_WIN32
+#include <sys/resource.h>
+#include <pthread.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include "noble/noble.h"
+#include "universe/universe.h"
+#include "entity/entity.h"
+
+#define BENCHMARK_SEED  (0x5eed1996)
+
+enum
+{
+    BENCHMARK_SIMULATION = 0,
+    BENCHMARK_BRAIN,
+    BENCHMARK_KERNELS,
+    BENCHMARK_BRAINCODE,
+    BENCHMARK_DEATHS,
+    BENCHMARK_LAND,
+    BENCHMARK_WEATHER,
+    BENCHMARK_SAVE,
+    BENCHMARK_LOAD
+};
+
+typedef struct
+{
+    n_string name;
+    n_byte   kind;
+    n_uint   cycles;
+    n_uint   beings;   /* 0 for the population of a new simulation, NO_BEINGS_FOUND for the maximum */
+}
+benchmark_preset;
+
+static const benchmark_preset presets[] =
+{
+    {"small",  BENCHMARK_SIMULATION, 2000, 32},
+    {"medium", BENCHMARK_SIMULATION, 1000, 0},
+    {"max",    BENCHMARK_SIMULATION, 250,  NO_BEINGS_FOUND},
+    {"brain",  BENCHMARK_BRAIN,      2000, 0},
+    {"kernels", BENCHMARK_KERNELS,   200,  0},
+    {"braincode", BENCHMARK_BRAINCODE, 200, 0},
+    {"deaths", BENCHMARK_DEATHS,     200,  0},
+    {"land",   BENCHMARK_LAND,       5000, 0},
+    {"weather", BENCHMARK_WEATHER,   5000, 0},
+    {"save",   BENCHMARK_SAVE,       20,   NO_BEINGS_FOUND},
+    {"load",   BENCHMARK_LOAD,       20,   NO_BEINGS_FOUND},
+    {0L,       0,                    0,    0}
+};
+
+n_int draw_error(n_string error_text)
+{
+    fprintf(stderr, "ERROR: %s\n", (const n_string) error_text);
+    return -1;
+}
+
+static n_uint benchmark_peak_kilobytes(void)
+{
+#ifndef	_WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return (n_uint)usage.ru_maxrss;
+    }
+#endif
+    return 0;
+}
+
+/* the hardware cache counters over the cycles, where the kernel allows them */
+#define BENCHMARK_COUNTERS  (3)
+
+static int benchmark_counter[BENCHMARK_COUNTERS] = {-1, -1, -1};
+
+static const n_string benchmark_counter_name[BENCHMARK_COUNTERS] =
+{
+    "cache_references", "cache_misses", "l1d_read_misses"
+};
+
+static void benchmark_counters_start(void)
+{
+#ifdef __linux__
+    const unsigned long long config[BENCHMARK_COUNTERS] =
+    {
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+    };
+    n_int loop = 0;
+    while (loop < BENCHMARK_COUNTERS)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = (loop == 2) ? PERF_TYPE_HW_CACHE : PERF_TYPE_HARDWARE;
+        attr.config = config[loop];
+        attr.disabled = 1;
+        attr.inherit = 1; /* the simulation threads are counted too */
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        benchmark_counter[loop] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (benchmark_counter[loop] != -1)
+        {
+            ioctl(benchmark_counter[loop], PERF_EVENT_IOC_RESET, 0);
+            ioctl(benchmark_counter[loop], PERF_EVENT_IOC_ENABLE, 0);
+        }
+        loop++;
+    }
+#endif
+}
+
+static void benchmark_counters_stop(void)
+{
+#ifdef __linux__
+    n_int loop = 0;
+    while (loop < BENCHMARK_COUNTERS)
+    {
+        if (benchmark_counter[loop] != -1)
+        {
+            ioctl(benchmark_counter[loop], PERF_EVENT_IOC_DISABLE, 0);
+        }
+        loop++;
+    }
+#endif
+}
+
+/* the counters the kernel gave, null for the others */
+static void benchmark_counters_json(void)
+{
+    n_int loop = 0;
+    printf("  \"cache\": {");
+    while (loop < BENCHMARK_COUNTERS)
+    {
+        unsigned long long value = 0;
+        n_byte             counted = 0;
+#ifdef __linux__
+        if (benchmark_counter[loop] != -1)
+        {
+            counted = (read(benchmark_counter[loop], &value, sizeof(value)) == sizeof(value));
+            close(benchmark_counter[loop]);
+            benchmark_counter[loop] = -1;
+        }
+#endif
+        printf("%s\"%s\": ", (loop == 0) ? "" : ", ", benchmark_counter_name[loop]);
+        if (counted)
+        {
+            printf("%llu", value);
+        }
+        else
+        {
+            printf("null");
+        }
+        loop++;
+    }
+    printf("},\n");
+}
+
+static n_uint benchmark_combine(n_uint hash, n_byte * values, n_uint length)
+{
+    return (hash * 1000003) ^ math_hash(values, length);
+}
+
+/* each being's block of memory gathered in the order of the beings, as the memory stays where the being was born */
+static n_uint benchmark_memory(n_uint hash, noble_simulation * local_sim, n_byte * base, n_uint size)
+{
+    n_uint  loop = 0;
+    n_byte * gathered = io_new(local_sim->num * size);
+    if (gathered == 0L)
+    {
+        return benchmark_combine(hash, base, local_sim->num * size);
+    }
+    while (loop < local_sim->num)
+    {
+        n_uint location = local_sim->beings[loop].brain_memory_location;
+        if (location == NO_BRAIN_MEMORY_LOCATION)
+        {
+            location = loop;
+        }
+        io_copy(&base[location * size], &gathered[loop * size], size);
+        loop++;
+    }
+    hash = benchmark_combine(hash, gathered, local_sim->num * size);
+    io_free(gathered);
+    return hash;
+}
+
+/* each being followed by its cold parts, as the beings are laid out in the files */
+static n_uint benchmark_beings(n_uint hash, noble_simulation * local_sim)
+{
+    n_uint             loop = 0;
+    noble_being_file * gathered = (noble_being_file *)io_new(local_sim->num * sizeof(noble_being_file));
+    if (gathered == 0L)
+    {
+        return benchmark_combine(hash, (n_byte *)local_sim->beings, local_sim->num * sizeof(noble_being));
+    }
+    while (loop < local_sim->num)
+    {
+        noble_being * local = &(local_sim->beings[loop]);
+        io_copy((n_byte *)local, (n_byte *)&(gathered[loop].being), sizeof(noble_being));
+        io_copy((n_byte *)GET_COLD(local_sim, local), (n_byte *)&(gathered[loop].cold), sizeof(noble_being_cold));
+        loop++;
+    }
+    hash = benchmark_combine(hash, (n_byte *)gathered, local_sim->num * sizeof(noble_being_file));
+    io_free(gathered);
+    return hash;
+}
+
+/* the beings, their brains and memories, the time, tide and weather */
+static n_uint benchmark_hash(noble_simulation * local_sim)
+{
+    n_uint hash = 0;
+    n_land * land = local_sim->land;
+
+    hash = benchmark_combine(hash, (n_byte *)&(land->time), sizeof(n_byte2));
+    hash = benchmark_combine(hash, (n_byte *)land->date, sizeof(n_byte2) * 2);
+    hash = benchmark_combine(hash, (n_byte *)land->genetics, sizeof(n_byte2) * 2);
+    hash = benchmark_combine(hash, &(land->tide_level), 1);
+    hash = benchmark_combine(hash, (n_byte *)local_sim->weather, sizeof(n_weather));
+    if (local_sim->num == 0)
+    {
+        return hash;
+    }
+    hash = benchmark_beings(hash, local_sim);
+#ifdef BRAIN_ON
+    hash = benchmark_memory(hash, local_sim, local_sim->brain_base, DOUBLE_BRAIN);
+#endif
+    hash = benchmark_memory(hash, local_sim, (n_byte *)local_sim->social_base, SOCIAL_SIZE * sizeof(social_link));
+    hash = benchmark_memory(hash, local_sim, (n_byte *)local_sim->episodic_base, EPISODIC_SIZE * sizeof(episodic_memory));
+    return hash;
+}
+
+/* grow or shrink the population of a new simulation */
+static void benchmark_population(noble_simulation * local_sim, n_uint beings, n_uint seed)
+{
+    n_byte2 local_random[2];
+
+    local_random[0] = (n_byte2)((seed >> 16) & 0xffff);
+    local_random[1] = (n_byte2)(seed & 0xffff);
+
+    if (beings >= local_sim->max)
+    {
+        beings = local_sim->max - 1;
+    }
+    if (beings < local_sim->num)
+    {
+        local_sim->num = beings;
+        local_sim->space_num = NO_BEINGS_FOUND;
+        local_sim->index_num = NO_BEINGS_FOUND;
+        being_select(local_sim, 0);
+        return;
+    }
+    while (local_sim->num < beings)
+    {
+        n_uint num = local_sim->num;
+        (void)math_random(local_random);
+        (void)being_init(local_sim, 0L, local_random[0], 1);
+        if (local_sim->num == num)
+        {
+            break;
+        }
+    }
+}
+
+/* the brains of the population cycled with their awake constants, each given a random input first as the senses give one */
+static void benchmark_brain(noble_simulation * local_sim, n_byte2 * local_random)
+{
+#ifdef BRAIN_ON
+    n_uint loop = 0;
+    while (loop < local_sim->num)
+    {
+        noble_being * local_being = &(local_sim->beings[loop++]);
+        n_byte      * local_brain = GET_B(local_sim, local_being);
+        n_byte2       local_brain_state[3];
+        n_uint        input;
+        if (local_brain == 0L)
+        {
+            continue;
+        }
+        input = math_random(local_random) & (SINGLE_BRAIN - 1);
+        local_brain[input] = (n_byte)(math_random(local_random) & 255);
+        local_brain_state[0] = GET_BS(local_being, 0);
+        local_brain_state[1] = GET_BS(local_being, 1);
+        local_brain_state[2] = GET_BS(local_being, 2);
+        brain_cycle(local_brain, local_brain_state);
+    }
+#endif
+}
+
+/* a new simulation starts with empty brains, which the brain cycle leaves empty, so they are filled from the random numbers */
+static void benchmark_brain_seed(noble_simulation * local_sim, n_byte2 * local_random)
+{
+#ifdef BRAIN_ON
+    n_uint loop = 0;
+    while (loop < local_sim->num)
+    {
+        n_byte * local_brain = GET_B(local_sim, &(local_sim->beings[loop++]));
+        n_uint   byte = 0;
+        if (local_brain == 0L)
+        {
+            continue;
+        }
+        while (byte < DOUBLE_BRAIN)
+        {
+            local_brain[byte++] = (n_byte)(math_random(local_random) & 255);
+        }
+    }
+#endif
+}
+
+/* the vector kernels of the brain cycle must match the scalar kernel */
+static n_int benchmark_kernels(n_byte2 * local_random)
+{
+    if (brain_cycle_test(local_random) < 0)
+    {
+        fprintf(stderr, "nabenchmark: a vector brain kernel differs from the scalar kernel\n");
+        return -1;
+    }
+    return 0;
+}
+
+#define BENCHMARK_REGIONS   (6)
+#define BENCHMARK_DIALOGUES (16)
+
+/* the memory a dialogue can write, the episodic memories of the two beings apart as they can run past the others */
+typedef struct
+{
+    n_byte * data[BENCHMARK_REGIONS];
+    n_uint   size[BENCHMARK_REGIONS];
+    n_uint   total;
+}
+benchmark_regions;
+
+static void benchmark_regions_find(noble_simulation * local_sim, noble_being * meeter, noble_being * met,
+                                   benchmark_regions * regions)
+{
+    n_int loop = 0;
+    regions->data[0] = (n_byte *)local_sim->beings;
+    regions->size[0] = local_sim->max * sizeof(noble_being);
+    regions->data[1] = (n_byte *)local_sim->cold_base;
+    regions->size[1] = local_sim->max * sizeof(noble_being_cold);
+    regions->data[2] = (n_byte *)local_sim->social_base;
+    regions->size[2] = local_sim->max * SOCIAL_SIZE * sizeof(social_link);
+    regions->data[3] = (n_byte *)local_sim->episodic_base;
+    regions->size[3] = local_sim->max * EPISODIC_SIZE * sizeof(episodic_memory);
+    regions->data[4] = (n_byte *)GET_EPI(local_sim, meeter);
+    regions->size[4] = EPISODIC_SIZE * sizeof(episodic_memory);
+    regions->data[5] = (n_byte *)GET_EPI(local_sim, met);
+    regions->size[5] = EPISODIC_SIZE * sizeof(episodic_memory);
+    regions->total = 0;
+    while (loop < BENCHMARK_REGIONS)
+    {
+        regions->total += regions->size[loop++];
+    }
+}
+
+/* copies the regions into the buffer, or the buffer back into the regions */
+static void benchmark_regions_copy(benchmark_regions * regions, n_byte * buffer, n_byte into_buffer)
+{
+    n_int loop = 0;
+    while (loop < BENCHMARK_REGIONS)
+    {
+        if (into_buffer)
+        {
+            io_copy(regions->data[loop], buffer, regions->size[loop]);
+        }
+        else
+        {
+            io_copy(buffer, regions->data[loop], regions->size[loop]);
+        }
+        buffer += regions->size[loop];
+        loop++;
+    }
+}
+
+#ifdef BRAINCODE_ON
+
+/* each decoded step must be the decoding of the bytes of the braincode as they are now */
+static n_int benchmark_steps_check(noble_simulation * local_sim, n_byte * braincode)
+{
+    noble_braincode_steps * steps = brain_braincode_steps(local_sim, braincode);
+    n_int                   i = 0;
+    if (steps == 0L)
+    {
+        return 0;
+    }
+    while (i <= BRAINCODE_STEPS_CACHED)
+    {
+        noble_braincode_step * step = &(steps->step[i]);
+        n_byte                 value0 = BRAINCODE_VALUE(braincode, i, 0);
+        n_byte                 value1 = BRAINCODE_VALUE(braincode, i, 1);
+        if (BRAINCODE_STEP_DECODED(steps, i) &&
+            ((step->instruction != BRAINCODE_INSTRUCTION(braincode, i)) ||
+             (step->constants != (BRAINCODE_CONSTANT0(braincode, i) | BRAINCODE_CONSTANT1(braincode, i))) ||
+             (step->value[0] != value0) || (step->value[1] != value1) ||
+             (step->address[0] != BRAINCODE_ADDRESS(i + value0)) ||
+             (step->address[1] != BRAINCODE_ADDRESS(i + value1))))
+        {
+            fprintf(stderr, "nabenchmark: a decoded braincode step differs from the bytes it was decoded from\n");
+            return -1;
+        }
+        i++;
+    }
+    return 0;
+}
+
+/* the steps of the braincode of every social link */
+static n_int benchmark_steps_check_all(noble_simulation * local_sim)
+{
+    n_uint link = 0;
+    while (link < (local_sim->max * SOCIAL_SIZE))
+    {
+        if (benchmark_steps_check(local_sim, local_sim->social_base[link++].braincode) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+#endif
+
+/* the dialogue must leave the same state with the steps decoded before as with none decoded */
+static n_int benchmark_braincode(noble_simulation * local_sim, n_byte2 * local_random,
+                                 n_byte * before, n_byte * decoded)
+{
+#ifdef BRAINCODE_ON
+    n_int dialogue = 0;
+    if (benchmark_steps_check_all(local_sim) != 0)
+    {
+        return -1;
+    }
+    if (local_sim->num == 0)
+    {
+        return 0;
+    }
+    while (dialogue < BENCHMARK_DIALOGUES)
+    {
+        noble_being     * meeter = &(local_sim->beings[math_random(local_random) % local_sim->num]);
+        noble_being     * met = meeter;
+        n_byte          * bc0, * bc1;
+        n_byte            awake = (n_byte)(math_random(local_random) & 1);
+        n_int             being_index = (n_int)(math_random(local_random) % SOCIAL_SIZE);
+        benchmark_regions regions;
+
+        if ((math_random(local_random) & 3) != 0)
+        {
+            met = &(local_sim->beings[math_random(local_random) % local_sim->num]);
+        }
+        if ((math_random(local_random) & 7) == 0)
+        {
+            being_index = -1;
+        }
+        if (meeter == met)
+        {
+            bc0 = GET_BRAINCODE_INTERNAL(local_sim, meeter);
+            bc1 = GET_BRAINCODE_EXTERNAL(local_sim, meeter);
+        }
+        else
+        {
+            bc0 = GET_BRAINCODE_EXTERNAL(local_sim, meeter);
+            bc1 = GET_BRAINCODE_EXTERNAL(local_sim, met);
+        }
+        if (math_random(local_random) & 1)
+        {
+            n_byte * registers = GET_BR(local_sim, meeter);
+            n_int    loop = 0;
+            while (loop < BRAINCODE_SIZE)
+            {
+                bc0[loop] = (n_byte)math_random(local_random);
+                bc1[loop] = (n_byte)math_random(local_random);
+                loop++;
+            }
+            loop = 0;
+            while (loop < BRAINCODE_PSPACE_REGISTERS)
+            {
+                registers[loop++] = (n_byte)math_random(local_random);
+            }
+            brain_braincode_changed(local_sim, bc0, 0, BRAINCODE_SIZE);
+            brain_braincode_changed(local_sim, bc1, 0, BRAINCODE_SIZE);
+        }
+
+        benchmark_regions_find(local_sim, meeter, met, &regions);
+        benchmark_regions_copy(&regions, before, 1);
+        brain_dialogue(local_sim, awake, meeter, met, bc0, bc1, being_index);
+        benchmark_regions_copy(&regions, decoded, 1);
+        benchmark_regions_copy(&regions, before, 0);
+        brain_braincode_reset(local_sim);
+        brain_dialogue(local_sim, awake, meeter, met, bc0, bc1, being_index);
+        benchmark_regions_copy(&regions, before, 1);
+        if (io_same(before, decoded, regions.total) == 0)
+        {
+            fprintf(stderr, "nabenchmark: the braincode dialogue differs with the steps decoded before\n");
+            return -1;
+        }
+        if ((benchmark_steps_check(local_sim, bc0) != 0) || (benchmark_steps_check(local_sim, bc1) != 0))
+        {
+            return -1;
+        }
+        dialogue++;
+    }
+#endif
+    return 0;
+}
+
+#define BENCHMARK_DEATH_CYCLES (10)
+
+/* what must stay with a being that lives through the deaths of others */
+typedef struct
+{
+    n_uint id;
+    n_uint location;
+    n_uint memory;
+    n_genetics genetics[CHROMOSOMES];
+}
+benchmark_survivor;
+
+static n_uint benchmark_survivor_memory(noble_simulation * local_sim, noble_being * local)
+{
+    n_uint hash = 0;
+#ifdef BRAIN_ON
+    hash = benchmark_combine(hash, GET_B(local_sim, local), DOUBLE_BRAIN);
+#endif
+    hash = benchmark_combine(hash, (n_byte *)GET_EPI(local_sim, local), EPISODIC_SIZE * sizeof(episodic_memory));
+    hash = benchmark_combine(hash, (n_byte *)GET_COLD(local_sim, local), sizeof(noble_being_cold));
+    if (local_sim->brain_rest != 0L)
+    {
+        hash = benchmark_combine(hash, (n_byte *)&(local_sim->brain_rest[local->brain_memory_location]), sizeof(noble_brain_rest));
+    }
+    return hash;
+}
+
+/* the social graph kept, where the only change allowed is a familiarity cleared */
+static n_int benchmark_survivor_social(social_link * kept, social_link * now)
+{
+    n_uint loop = 0;
+    while (loop < SOCIAL_SIZE)
+    {
+        if (io_same((n_byte *)&kept[loop], (n_byte *)&now[loop], sizeof(social_link)) == 0)
+        {
+            social_link cleared = kept[loop];
+            cleared.familiarity = 0;
+            if (io_same((n_byte *)&cleared, (n_byte *)&now[loop], sizeof(social_link)) == 0)
+            {
+                return -1;
+            }
+        }
+        loop++;
+    }
+    return 0;
+}
+
+/* kills a few random beings and checks what each being that lives keeps */
+static n_int benchmark_deaths(noble_simulation * local_sim, n_byte2 * local_random,
+                              benchmark_survivor * survivors, social_link * social)
+{
+    n_uint      loop = 0, deaths = 1 + (math_random(local_random) % 3);
+    n_uint      num = local_sim->num;
+    n_uint      selected;
+    n_genetics  selected_genetics[CHROMOSOMES];
+
+    if (num <= (deaths + 4))
+    {
+        return 0;
+    }
+    being_select(local_sim, math_random(local_random) % num);
+    selected = being_selected_index(local_sim);
+    io_copy((n_byte *)GET_G(&(local_sim->beings[selected])), (n_byte *)selected_genetics, sizeof(selected_genetics));
+
+    while (loop < num)
+    {
+        noble_being * local = &(local_sim->beings[loop]);
+        survivors[loop].id = being_id(local_sim, local);
+        survivors[loop].location = local->brain_memory_location;
+        survivors[loop].memory = benchmark_survivor_memory(local_sim, local);
+        io_copy((n_byte *)GET_G(local), (n_byte *)survivors[loop].genetics, sizeof(survivors[loop].genetics));
+        io_copy((n_byte *)GET_SOC(local_sim, local), (n_byte *)&social[loop * SOCIAL_SIZE], SOCIAL_SIZE * sizeof(social_link));
+        loop++;
+    }
+    loop = 0;
+    while (loop < deaths)
+    {
+        local_sim->beings[math_random(local_random) % num].energy = 0;
+        loop++;
+    }
+    loop = 0;
+    while (loop < num)
+    {
+        if (local_sim->beings[loop].energy == 0)
+        {
+            survivors[loop].location = NO_BRAIN_MEMORY_LOCATION;
+        }
+        loop++;
+    }
+
+    being_remove(local_sim);
+
+    loop = 0;
+    while (loop < num)
+    {
+        noble_being * local = being_from_id(local_sim, survivors[loop].id);
+        if (survivors[loop].location == NO_BRAIN_MEMORY_LOCATION)
+        {
+            if (local != 0L)
+            {
+                fprintf(stderr, "nabenchmark: a being that died is still found from its identity\n");
+                return -1;
+            }
+        }
+        else if ((local == 0L) ||
+                 (local->brain_memory_location != survivors[loop].location) ||
+                 (io_same((n_byte *)GET_G(local), (n_byte *)survivors[loop].genetics, sizeof(survivors[loop].genetics)) == 0) ||
+                 (benchmark_survivor_memory(local_sim, local) != survivors[loop].memory) ||
+                 (benchmark_survivor_social(&social[loop * SOCIAL_SIZE], GET_SOC(local_sim, local)) != 0))
+        {
+            fprintf(stderr, "nabenchmark: a being that lived did not keep its identity and memory\n");
+            return -1;
+        }
+        loop++;
+    }
+    if ((survivors[selected].location != NO_BRAIN_MEMORY_LOCATION) &&
+        ((being_selected(local_sim) == 0L) ||
+         (io_same((n_byte *)GET_G(being_selected(local_sim)), (n_byte *)selected_genetics, sizeof(selected_genetics)) == 0)))
+    {
+        fprintf(stderr, "nabenchmark: the selection did not stay on the being that lived\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void benchmark_land(noble_simulation * local_sim)
+{
+    land_cycle(local_sim->land);
+#ifdef WEATHER_ON
+    weather_cycle(local_sim->land, local_sim->weather);
+#endif
+}
+
+static void benchmark_weather(noble_simulation * local_sim)
+{
+#ifdef WEATHER_ON
+    sim_weather(local_sim);
+#endif
+}
+
+/* the text file of the whole simulation, as the save command makes it */
+static n_uint benchmark_save(noble_simulation * local_sim)
+{
+    n_file * saved = file_out(local_sim);
+    n_uint   bytes = 0;
+    if (saved != 0L)
+    {
+        bytes = saved->location;
+        io_file_free(saved);
+    }
+    return bytes;
+}
+
+/* reads the saved text back into the simulation, as the open command does */
+static n_int benchmark_load(noble_simulation * local_sim, n_file * saved, n_file * loading)
+{
+    io_copy(saved->data, loading->data, saved->location);
+    loading->location = saved->location;
+    loading->size = saved->location + 1;
+    return file_in(local_sim, loading);
+}
+
+/* the loaded simulation must save as the text it was loaded from */
+static n_int benchmark_round_trip(noble_simulation * local_sim, n_file * saved)
+{
+    n_file * again = file_out(local_sim);
+    n_int    same = 0;
+    if (again != 0L)
+    {
+        same = (again->location == saved->location) &&
+               io_same(again->data, saved->data, saved->location);
+        io_file_free(again);
+    }
+    if (same == 0)
+    {
+        fprintf(stderr, "nabenchmark: the loaded simulation does not save as the same file\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void benchmark_json(const benchmark_preset * preset, noble_simulation * local_sim,
+                           n_uint seed, n_uint threads, n_uint cycles,
+                           n_uint updates, n_uint saved_bytes, n_uint nanoseconds)
+{
+    double seconds = (double)nanoseconds / 1000000000.0;
+    n_int  phase = 0;
+
+    if (seconds <= 0)
+    {
+        seconds = 1.0 / 1000000000.0;
+    }
+    printf("{\n");
+    printf("  \"preset\": \"%s\",\n", preset->name);
+    printf("  \"seed\": %lu,\n", (unsigned long)seed);
+    printf("  \"threads\": %lu,\n", (unsigned long)threads);
+    printf("  \"cycles\": %lu,\n", (unsigned long)cycles);
+    printf("  \"beings\": %lu,\n", (unsigned long)local_sim->num);
+    printf("  \"maximum_beings\": %lu,\n", (unsigned long)local_sim->max);
+    printf("  \"seconds\": %.6f,\n", seconds);
+    printf("  \"cycles_per_second\": %.3f,\n", (double)cycles / seconds);
+    printf("  \"being_updates_per_second\": %.3f,\n", (double)updates / seconds);
+    printf("  \"peak_rss_kilobytes\": %lu,\n", (unsigned long)benchmark_peak_kilobytes());
+    benchmark_counters_json();
+    if ((preset->kind == BENCHMARK_SAVE) || (preset->kind == BENCHMARK_LOAD))
+    {
+        printf("  \"saved_bytes\": %lu,\n", (unsigned long)saved_bytes);
+    }
+    printf("  \"phases\": {");
+    if (preset->kind == BENCHMARK_SIMULATION)
+    {
+        while (phase < PROFILE_PHASES)
+        {
+            n_uint statistics[4];
+            if (sim_profile_statistics(local_sim, phase, statistics) == 0)
+            {
+                statistics[0] = statistics[1] = statistics[2] = statistics[3] = 0;
+            }
+            printf("%s\n    \"%s\": {\"mean_ns\": %lu, \"p50_ns\": %lu, \"p99_ns\": %lu, \"max_ns\": %lu}",
+                   (phase == 0) ? "" : ",", sim_profile_name(phase),
+                   (unsigned long)statistics[0], (unsigned long)statistics[1],
+                   (unsigned long)statistics[2], (unsigned long)statistics[3]);
+            phase++;
+        }
+        printf("\n  ");
+    }
+    printf("},\n");
+    printf("  \"state_hash\": \"%016lx\"\n", (unsigned long)benchmark_hash(local_sim));
+    printf("}\n");
+}
+
+typedef struct
+{
+    noble_simulation ** worlds;
+    n_uint            * updates;
+    n_uint              count;
+    n_uint              cycles;
+    n_uint              next;
+#ifndef	_WIN32
+    pthread_mutex_t     lock;
+#endif
+}
+benchmark_sweep;
+
+/* each thread takes the next world not yet cycled until there are none left */
+static void * benchmark_sweep_thread(void * ptr)
+{
+    benchmark_sweep * sweep = (benchmark_sweep *)ptr;
+    while (1)
+    {
+        noble_simulation * local_sim;
+        n_uint             index, cycle = 0;
+#ifndef	_WIN32
+        pthread_mutex_lock(&sweep->lock);
+#endif
+        index = sweep->next++;
+#ifndef	_WIN32
+        pthread_mutex_unlock(&sweep->lock);
+#endif
+        if (index >= sweep->count)
+        {
+            break;
+        }
+        local_sim = sweep->worlds[index];
+        while (cycle < sweep->cycles)
+        {
+            sim_world_cycle(local_sim);
+            sweep->updates[index] += local_sim->num;
+            cycle++;
+        }
+    }
+    return 0L;
+}
+
+static n_int benchmark_sweep_run(const benchmark_preset * preset, n_uint seed, n_uint threads, n_uint worlds, n_int profile)
+{
+    benchmark_sweep sweep;
+    n_uint          loop = 0, updates = 0, hash = 0, start, nanoseconds;
+    double          seconds;
+#ifndef	_WIN32
+    pthread_t       thread[SIM_THREADS_MAX];
+    n_uint          running = 0;
+#endif
+
+    sweep.worlds = (noble_simulation **)io_new(worlds * sizeof(noble_simulation *));
+    sweep.updates = (n_uint *)io_new(worlds * sizeof(n_uint));
+    if ((sweep.worlds == 0L) || (sweep.updates == 0L))
+    {
+        return SHOW_ERROR("Worlds not allocated");
+    }
+    sweep.count = worlds;
+    sweep.cycles = preset->cycles;
+    sweep.next = 0;
+
+    while (loop < worlds)
+    {
+        sweep.updates[loop] = 0;
+        sweep.worlds[loop] = sim_world_new(seed + loop);
+        if (sweep.worlds[loop] == 0L)
+        {
+            return SHOW_ERROR("World not allocated");
+        }
+        sim_schedule_profile(&(sweep.worlds[loop]->schedule), profile);
+        if (preset->beings != 0)
+        {
+            benchmark_population(sweep.worlds[loop], preset->beings, seed + loop);
+        }
+        loop++;
+    }
+
+    if (threads > SIM_THREADS_MAX)
+    {
+        threads = SIM_THREADS_MAX;
+    }
+
+    start = io_nanoseconds();
+#ifndef	_WIN32
+    pthread_mutex_init(&sweep.lock, NULL);
+    while ((running + 1) < threads)
+    {
+        if (pthread_create(&thread[running], NULL, benchmark_sweep_thread, &sweep) != 0)
+        {
+            break;
+        }
+        running++;
+    }
+#endif
+    (void)benchmark_sweep_thread(&sweep);
+#ifndef	_WIN32
+    while (running > 0)
+    {
+        pthread_join(thread[--running], NULL);
+    }
+    pthread_mutex_destroy(&sweep.lock);
+#endif
+    nanoseconds = io_nanoseconds() - start;
+
+    seconds = (double)nanoseconds / 1000000000.0;
+    if (seconds <= 0)
+    {
+        seconds = 1.0 / 1000000000.0;
+    }
+
+    printf("{\n");
+    printf("  \"preset\": \"%s\",\n", preset->name);
+    printf("  \"seed\": %lu,\n", (unsigned long)seed);
+    printf("  \"threads\": %lu,\n", (unsigned long)threads);
+    printf("  \"worlds\": %lu,\n", (unsigned long)worlds);
+    printf("  \"cycles\": %lu,\n", (unsigned long)preset->cycles);
+    printf("  \"seconds\": %.6f,\n", seconds);
+    printf("  \"world_cycles_per_second\": %.3f,\n", (double)(preset->cycles * worlds) / seconds);
+    loop = 0;
+    while (loop < worlds)
+    {
+        updates += sweep.updates[loop++];
+    }
+    printf("  \"being_updates_per_second\": %.3f,\n", (double)updates / seconds);
+    printf("  \"peak_rss_kilobytes\": %lu,\n", (unsigned long)benchmark_peak_kilobytes());
+    printf("  \"world_hashes\": [");
+    loop = 0;
+    while (loop < worlds)
+    {
+        n_uint world_hash = benchmark_hash(sweep.worlds[loop]);
+        hash = (hash * 1000003) ^ world_hash;
+        printf("%s\"%016lx\"", (loop == 0) ? "" : ", ", (unsigned long)world_hash);
+        sim_world_free(sweep.worlds[loop]);
+        loop++;
+    }
+    printf("],\n");
+    printf("  \"state_hash\": \"%016lx\"\n", (unsigned long)hash);
+    printf("}\n");
+
+    io_free((void *)sweep.worlds);
+    io_free((void *)sweep.updates);
+    return 0;
+}
+
+static void benchmark_usage(void)
+{
+    n_int loop = 0;
+    fprintf(stderr, "usage: nabenchmark [preset] [-c cycles] [-b beings] [-s seed] [-t threads] [-w worlds] [-f profile]\n");
+    fprintf(stderr, "presets:");
+    while (presets[loop].name)
+    {
+        fprintf(stderr, " %s", presets[loop++].name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, n_string argv[])
+{
+    benchmark_preset   preset = presets[1];
+    noble_simulation * local_sim;
+    n_uint             seed = BENCHMARK_SEED, threads = 0, worlds = 0;
+    n_int              profile = SCHEDULE_FULL;
+    n_uint             cycle = 0, updates = 0, saved_bytes = 0, start, brain_hash = 0;
+    n_file           * saved = 0L;
+    n_file             loading;
+    n_byte2            test_random[2];
+    n_byte           * dialogue_state = 0L;
+    benchmark_survivor * survivors = 0L;
+    social_link      * survivor_social = 0L;
+    n_int              arg = 1;
+
+    while (arg < argc)
+    {
+        if ((argv[arg][0] == '-') && ((arg + 1) < argc))
+        {
+            n_uint value = (n_uint)strtoul(argv[arg + 1], 0L, 0);
+            switch (argv[arg][1])
+            {
+            case 'c':
+                preset.cycles = value;
+                break;
+            case 'b':
+                preset.beings = value;
+                break;
+            case 's':
+                seed = value;
+                break;
+            case 't':
+                threads = value;
+                break;
+            case 'w':
+                worlds = value;
+                break;
+            case 'f':
+                if (value >= SCHEDULE_PROFILES)
+                {
+                    benchmark_usage();
+                    return 1;
+                }
+                profile = (n_int)value;
+                break;
+            default:
+                benchmark_usage();
+                return 1;
+            }
+            arg += 2;
+        }
+        else
+        {
+            n_int loop = 0;
+            while (presets[loop].name && strcmp(presets[loop].name, argv[arg]))
+            {
+                loop++;
+            }
+            if (presets[loop].name == 0L)
+            {
+                benchmark_usage();
+                return 1;
+            }
+            preset = presets[loop];
+            arg++;
+        }
+    }
+
+    if ((worlds != 0) && (preset.kind == BENCHMARK_SIMULATION))
+    {
+        return (benchmark_sweep_run(&preset, seed, threads, worlds, profile) == 0) ? 0 : 1;
+    }
+
+    local_sim = sim_sim();
+    (void)sim_init(KIND_START_UP, seed, MAP_AREA, 0);
+
+    if (preset.beings != 0)
+    {
+        benchmark_population(local_sim, preset.beings, seed);
+    }
+    if ((threads != 0) && ((preset.kind == BENCHMARK_SIMULATION) || (preset.kind == BENCHMARK_WEATHER)))
+    {
+        sim_threads(local_sim, threads);
+    }
+    sim_schedule_profile(&(local_sim->schedule), profile);
+    if (preset.kind == BENCHMARK_SIMULATION)
+    {
+        sim_profile(local_sim, 1, 0);
+    }
+    if (preset.kind == BENCHMARK_LOAD)
+    {
+        saved = file_out(local_sim);
+        if (saved == 0L)
+        {
+            return 1;
+        }
+        saved_bytes = saved->location;
+        loading.data = (n_byte *)io_new(saved_bytes + 1);
+        if (loading.data == 0L)
+        {
+            return 1;
+        }
+    }
+
+    if ((preset.kind == BENCHMARK_BRAINCODE) && (local_sim->num != 0))
+    {
+        benchmark_regions regions;
+        benchmark_regions_find(local_sim, local_sim->beings, local_sim->beings, &regions);
+        dialogue_state = (n_byte *)io_new(regions.total * 2);
+        if (dialogue_state == 0L)
+        {
+            return 1;
+        }
+    }
+
+    if (preset.kind == BENCHMARK_DEATHS)
+    {
+        survivors = (benchmark_survivor *)io_new(local_sim->max * sizeof(benchmark_survivor));
+        survivor_social = (social_link *)io_new(local_sim->max * SOCIAL_SIZE * sizeof(social_link));
+        if ((survivors == 0L) || (survivor_social == 0L))
+        {
+            return 1;
+        }
+    }
+
+    test_random[0] = (n_byte2)((seed >> 16) & 0xffff);
+    test_random[1] = (n_byte2)(seed & 0xffff);
+
+    if (preset.kind == BENCHMARK_BRAIN)
+    {
+        benchmark_brain_seed(local_sim, test_random);
+        brain_hash = benchmark_hash(local_sim);
+    }
+
+    benchmark_counters_start();
+    start = io_nanoseconds();
+    while (cycle < preset.cycles)
+    {
+        switch (preset.kind)
+        {
+        case BENCHMARK_BRAIN:
+            benchmark_brain(local_sim, test_random);
+            break;
+        case BENCHMARK_KERNELS:
+            if (benchmark_kernels(test_random) != 0)
+            {
+                sim_close();
+                return 1;
+            }
+            break;
+        case BENCHMARK_LAND:
+            benchmark_land(local_sim);
+            break;
+        case BENCHMARK_WEATHER:
+            benchmark_weather(local_sim);
+            break;
+        case BENCHMARK_SAVE:
+            saved_bytes = benchmark_save(local_sim);
+            break;
+        case BENCHMARK_LOAD:
+            if (benchmark_load(local_sim, saved, &loading) != 0)
+            {
+                return 1;
+            }
+            break;
+        case BENCHMARK_BRAINCODE:
+            sim_cycle();
+            if (dialogue_state != 0L)
+            {
+                benchmark_regions regions;
+                benchmark_regions_find(local_sim, local_sim->beings, local_sim->beings, &regions);
+                if (benchmark_braincode(local_sim, test_random, dialogue_state, &dialogue_state[regions.total]) != 0)
+                {
+                    sim_close();
+                    return 1;
+                }
+            }
+            break;
+        case BENCHMARK_DEATHS:
+            sim_cycle();
+            if (((cycle % BENCHMARK_DEATH_CYCLES) == 0) &&
+                (benchmark_deaths(local_sim, test_random, survivors, survivor_social) != 0))
+            {
+                sim_close();
+                return 1;
+            }
+            break;
+        default:
+            sim_cycle();
+            break;
+        }
+        updates += local_sim->num;
+        cycle++;
+    }
+    benchmark_counters_stop();
+    benchmark_json(&preset, local_sim, seed, threads, cycle, updates, saved_bytes, io_nanoseconds() - start);
+
+    if ((preset.kind == BENCHMARK_BRAIN) && (cycle != 0) && (local_sim->num != 0) &&
+        (benchmark_hash(local_sim) == brain_hash))
+    {
+        fprintf(stderr, "nabenchmark: the brain cycle left the brains as they were\n");
+        sim_close();
+        return 1;
+    }
+
+    if (dialogue_state != 0L)
+    {
+        io_free(dialogue_state);
+    }
+    if (survivors != 0L)
+    {
+        io_free((void *)survivors);
+        io_free((void *)survivor_social);
+    }
+
+    if (saved != 0L)
+    {
+        n_int round_trip = benchmark_round_trip(local_sim, saved);
+        io_free(loading.data);
+        io_file_free(saved);
+        if (round_trip != 0)
+        {
+            sim_close();
+            return 1;
+        }
+    }
+
+    sim_close();
+    return 0;
+}
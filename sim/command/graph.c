@@ -437,7 +437,7 @@ void graph_pathogens(noble_simulation * sim, n_byte * buffer, n_int img_width, n
             for (i=0; i<sim->num; i++)
             {
                 local_being = &(sim->beings[i]);
-                immune = &(local_being->immune_system);
+                immune = GET_IM(sim, local_being);
                 for (j=0; j<IMMUNE_POPULATION; j++)
                 {
                     antibodies[immune->shape_antibody[j]]++;
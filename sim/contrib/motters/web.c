@@ -2464,7 +2464,7 @@ void plot_territory(char * filename, noble_simulation * sim, n_int img_width, n_
                 {
                     local_being = &(sim->beings[n]);
                     idx = y*TERRITORY_DIMENSION+x;
-                    hist[local_being->territory[idx].name]++;
+                    hist[GET_T(sim, local_being)[idx].name]++;
                 }
                 max=5;
                 idx = -1;
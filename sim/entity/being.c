@@ -227,21 +227,20 @@ void being_set_select_name(noble_simulation * sim, n_string name)
         (void)SHOW_ERROR("Ape not found");
         return;
     }
-    sim->select = response;
+    being_select(sim, response);
 }
 
 n_string being_get_select_name(noble_simulation * sim)
 {
     static n_string_block name;
-    noble_being *b;
+    noble_being *b = being_selected(sim);
 
-    if (sim->select == NO_BEINGS_FOUND)
+    if (b == 0L)
     {
         sprintf(name,"*** ALL APES DEAD ***");
     }
     else
     {
-        b = &sim->beings[sim->select];
         being_name((FIND_SEX(GET_I(b)) == SEX_FEMALE), GET_NAME(sim,b), GET_FAMILY_FIRST_NAME(sim,b), GET_FAMILY_SECOND_NAME(sim,b), name);
     }
     return (n_string)name;
@@ -256,7 +255,7 @@ noble_being * being_from_name(noble_simulation * sim, n_string name)
     {
         return 0L;
     }
-    return &(sim->beings[sim->select]);
+    return &(sim->beings[response]);
 }
 
 /**
@@ -334,12 +333,12 @@ n_byte being_los(n_land * land, noble_being * local, n_byte2 lx, n_byte2 ly)
 
 /*NOBLEMAKE END=""*/
 
-static void being_immune_init(noble_being * local)
+static void being_immune_init(noble_simulation * sim, noble_being * local)
 {
 #ifdef IMMUNE_ON
     n_byte i;
     n_byte2 * local_random = local->seed;
-    noble_immune_system * immune = &(local->immune_system);
+    noble_immune_system * immune = GET_IM(sim, local);
 
     for (i = 0; i < IMMUNE_ANTIGENS; i += 2)
     {
@@ -360,12 +359,12 @@ static void being_immune_init(noble_being * local)
 #endif
 }
 
-static void being_immune_seed(noble_being * mother, noble_being * child)
+static void being_immune_seed(noble_simulation * sim, noble_being * mother, noble_being * child)
 {
 #ifdef IMMUNE_ON
     n_byte i;
-    noble_immune_system * immune_mother = &(mother->immune_system);
-    noble_immune_system * immune_child = &(child->immune_system);
+    noble_immune_system * immune_mother = GET_IM(sim, mother);
+    noble_immune_system * immune_child = GET_IM(sim, child);
 
     /* child acquires mother's antibodies */
     for (i=0; i<IMMUNE_POPULATION; i++)
@@ -376,11 +375,11 @@ static void being_immune_seed(noble_being * mother, noble_being * child)
 #endif
 }
 
-static void being_acquire_pathogen(noble_being * local, n_byte transmission_type)
+static void being_acquire_pathogen(noble_simulation * sim, noble_being * local, n_byte transmission_type)
 {
 #ifdef IMMUNE_ON
     n_byte i;
-    noble_immune_system * immune = &(local->immune_system);
+    noble_immune_system * immune = GET_IM(sim, local);
     n_byte2 * local_random = local->seed;
 
     math_random3(local_random);
@@ -397,22 +396,22 @@ static void being_acquire_pathogen(noble_being * local, n_byte transmission_type
 #endif
 }
 
-void being_ingest_pathogen(noble_being * local, n_byte food_type)
+void being_ingest_pathogen(noble_simulation * sim, noble_being * local, n_byte food_type)
 {
     n_byte transmission_type=food_type+PATHOGEN_TRANSMISSION_FOOD_VEGETABLE;
-    being_acquire_pathogen(local,transmission_type);
+    being_acquire_pathogen(sim, local,transmission_type);
 }
 
-void being_immune_transmit(noble_being * meeter_being, noble_being * met_being, n_byte transmission_type)
+void being_immune_transmit(noble_simulation * sim, noble_being * meeter_being, noble_being * met_being, n_byte transmission_type)
 {
 #ifdef IMMUNE_ON
     n_byte i,j;
     n_byte2 * local_random = meeter_being->seed;
-    noble_immune_system * immune0 = &(meeter_being->immune_system);
-    noble_immune_system * immune1 = &(met_being->immune_system);
+    noble_immune_system * immune0 = GET_IM(sim, meeter_being);
+    noble_immune_system * immune1 = GET_IM(sim, met_being);
 
     /* pathogen obtained from environment */
-    being_acquire_pathogen(meeter_being, transmission_type);
+    being_acquire_pathogen(sim, meeter_being, transmission_type);
 
     /* pathogen transmitted between beings */
     math_random3(local_random);
@@ -446,7 +445,7 @@ void being_immune_transmit(noble_being * meeter_being, noble_being * met_being,
 #endif
 }
 
-static void being_immune_response(noble_being * local)
+static void being_immune_response(noble_simulation * sim, noble_being * local)
 {
 #ifdef IMMUNE_ON
     n_int min_antibodies;
@@ -454,7 +453,7 @@ static void being_immune_response(noble_being * local)
     n_byte2 total_antigens,max_severity;
     n_byte i,j,k,match,best_match,bits_matched,bit;
     n_byte2 * local_random = local->seed;
-    noble_immune_system * immune = &(local->immune_system);
+    noble_immune_system * immune = GET_IM(sim, local);
 
     /* antibodies die at some fixed rate */
     math_random3(local_random);
@@ -638,9 +637,185 @@ static noble_being * being_find_child(noble_simulation * sim, n_genetics * genet
     return 0L;
 }
 
+/*
+ *	The name and female indexes are open addressing hash tables of being
+ *	indexes. Beings are added in array order and a key already in a table is
+ *	not added again, so a lookup finds the same being as a scan of the array.
+ *	The later beings with a name already in the name index are chained on from
+ *	the first in array order, through the last being with the name.
+ */
+
+static n_uint being_index_name_key(n_uint first_gender, n_uint family)
+{
+    return ((first_gender & 0xffff) << 16) | (family & 0xffff);
+}
+
+static n_uint being_index_genetics_key(n_genetics * genetics)
+{
+    n_uint key = 0;
+    n_int  loop = 0;
+    while (loop < CHROMOSOMES)
+    {
+        key = (key * 31) + (n_uint)genetics[loop++];
+    }
+    return key;
+}
+
+static n_uint being_index_slot(noble_simulation * sim, n_uint key)
+{
+    return ((key & 0xffffffff) * 2654435761UL) & (sim->index_size - 1);
+}
+
+static n_byte being_index_name_match(noble_simulation * sim, noble_being * local, n_uint key)
+{
+    return being_index_name_key(GET_NAME_GENDER(sim,local), GET_NAME_FAMILY2(sim,local)) == key;
+}
+
+static n_byte being_index_female_match(noble_being * local, n_genetics * genetics)
+{
+    return (genetics_compare(GET_G(local), genetics) && (FIND_SEX(GET_I(local)) == SEX_FEMALE));
+}
+
+static void being_index_add(noble_simulation * sim, n_uint index)
+{
+    noble_being * local = &(sim->beings[index]);
+    n_uint        key = being_index_name_key(GET_NAME_GENDER(sim,local), GET_NAME_FAMILY2(sim,local));
+    n_uint        slot = being_index_slot(sim, key);
+
+    while (sim->name_index[slot] != NO_BEINGS_FOUND)
+    {
+        if (being_index_name_match(sim, &(sim->beings[sim->name_index[slot]]), key))
+        {
+            break;
+        }
+        slot = (slot + 1) & (sim->index_size - 1);
+    }
+    sim->name_next[index] = NO_BEINGS_FOUND;
+    if (sim->name_index[slot] == NO_BEINGS_FOUND)
+    {
+        sim->name_index[slot] = index;
+    }
+    else
+    {
+        sim->name_next[sim->name_last[slot]] = index;
+    }
+    sim->name_last[slot] = index;
+
+    if (FIND_SEX(GET_I(local)) != SEX_FEMALE)
+    {
+        return;
+    }
+    slot = being_index_slot(sim, being_index_genetics_key(GET_G(local)));
+    while (sim->female_index[slot] != NO_BEINGS_FOUND)
+    {
+        if (being_index_female_match(&(sim->beings[sim->female_index[slot]]), GET_G(local)))
+        {
+            return;
+        }
+        slot = (slot + 1) & (sim->index_size - 1);
+    }
+    sim->female_index[slot] = index;
+}
+
+/**
+ * Allocates the name and female indexes
+ * @param sim Pointer to the simulation
+ * @return 0 on success, -1 if the memory could not be allocated
+ */
+n_int being_index_init(noble_simulation * sim)
+{
+    n_uint size = 1;
+    /* at most half full */
+    while (size < (sim->max * 2))
+    {
+        size <<= 1;
+    }
+    sim->index_num = NO_BEINGS_FOUND;
+    sim->index_size = size;
+    sim->name_index = (n_uint *)io_new(size * sizeof(n_uint));
+    sim->female_index = (n_uint *)io_new(size * sizeof(n_uint));
+    sim->name_next = (n_uint *)io_new(sim->max * sizeof(n_uint));
+    sim->name_last = (n_uint *)io_new(size * sizeof(n_uint));
+    if ((sim->name_index == 0L) || (sim->female_index == 0L) || (sim->name_next == 0L) || (sim->name_last == 0L))
+    {
+        being_index_free(sim);
+        return SHOW_ERROR("Name index not allocated");
+    }
+    return 0;
+}
+
+/**
+ * Frees the name and female indexes
+ * @param sim Pointer to the simulation
+ */
+void being_index_free(noble_simulation * sim)
+{
+    io_free((void *)sim->name_index);
+    io_free((void *)sim->female_index);
+    io_free((void *)sim->name_next);
+    io_free((void *)sim->name_last);
+    sim->name_index = 0L;
+    sim->female_index = 0L;
+    sim->name_next = 0L;
+    sim->name_last = 0L;
+    sim->index_size = 0;
+    sim->index_num = NO_BEINGS_FOUND;
+}
+
+/**
+ * Rebuilds the name and female indexes. The indexes are kept up to date
+ * through births until being_remove compacts the beings. Anything else that
+ * changes a name sets index_num to NO_BEINGS_FOUND.
+ * @param sim Pointer to the simulation
+ */
+void being_index_rebuild(noble_simulation * sim)
+{
+    n_uint loop = 0;
+    if (sim->name_index == 0L)
+    {
+        return;
+    }
+    while (loop < sim->index_size)
+    {
+        sim->name_index[loop] = NO_BEINGS_FOUND;
+        sim->female_index[loop] = NO_BEINGS_FOUND;
+        loop++;
+    }
+    loop = 0;
+    while (loop < sim->num)
+    {
+        being_index_add(sim, loop++);
+    }
+    sim->index_num = sim->num;
+}
+
+/* the last being in the array has just been born */
+static void being_index_birth(noble_simulation * sim)
+{
+    if ((sim->index_num + 1) == sim->num)
+    {
+        being_index_add(sim, sim->index_num);
+        sim->index_num++;
+    }
+}
+
 noble_being * being_find_female(noble_simulation * sim, n_genetics * genetics)
 {
     n_uint loop = 0;
+    if (sim->index_num == sim->num)
+    {
+        n_uint slot = being_index_slot(sim, being_index_genetics_key(genetics));
+        while (sim->female_index[slot] != NO_BEINGS_FOUND)
+        {
+            noble_being * local = &(sim->beings[sim->female_index[slot]]);
+            if (being_index_female_match(local, genetics))
+            {
+                return local;
+            }
+            slot = (slot + 1) & (sim->index_size - 1);
+        }
+        return 0L;
+    }
     while ( loop < sim->num )
     {
         noble_being * local = &(sim->beings[loop]);
@@ -657,9 +832,36 @@ noble_being * being_find_female(noble_simulation * sim, n_genetics * genetics)
     return 0L;
 }
 
-noble_being * being_find_name(noble_simulation * sim, n_byte2 first_gender, n_byte2 family)
+/**
+ * Steps through the beings with a name in array order. This only reads the
+ * beings and the index so it can be used while the beings sense.
+ * @param sim Pointer to the simulation
+ * @param first_gender The first name and gender
+ * @param family The family name
+ * @param previous NO_BEINGS_FOUND for the first being with the name, otherwise the index of the last one found
+ * @return The index of the next being with the name or NO_BEINGS_FOUND
+ */
+static n_uint being_named(noble_simulation * sim, n_byte2 first_gender, n_byte2 family, n_uint previous)
 {
-    n_uint loop = 0;
+    n_uint loop = (previous == NO_BEINGS_FOUND) ? 0 : (previous + 1);
+    if (sim->index_num == sim->num)
+    {
+        n_uint key = being_index_name_key(first_gender, family);
+        n_uint slot = being_index_slot(sim, key);
+        if (previous != NO_BEINGS_FOUND)
+        {
+            return sim->name_next[previous];
+        }
+        while (sim->name_index[slot] != NO_BEINGS_FOUND)
+        {
+            if (being_index_name_match(sim, &(sim->beings[sim->name_index[slot]]), key))
+            {
+                return sim->name_index[slot];
+            }
+            slot = (slot + 1) & (sim->index_size - 1);
+        }
+        return NO_BEINGS_FOUND;
+    }
     while ( loop < sim->num )
     {
         noble_being * local = &(sim->beings[loop]);
@@ -667,41 +869,59 @@ noble_being * being_find_name(noble_simulation * sim, n_byte2 first_gender, n_by
         if ( (GET_NAME_GENDER(sim,local) == first_gender) &&
                 (GET_NAME_FAMILY2(sim,local) == family) )
         {
-            return local;
+            return loop;
         }
         loop++;
     }
-    return 0L;
+    return NO_BEINGS_FOUND;
 }
 
-/* returns the total positive and negative affect within memory */
-n_uint being_affect(noble_simulation * local_sim, noble_being * local, n_byte is_positive)
+noble_being * being_find_name(noble_simulation * sim, n_byte2 first_gender, n_byte2 family)
+{
+    n_uint index = being_named(sim, first_gender, family, NO_BEINGS_FOUND);
+    if (index == NO_BEINGS_FOUND)
+    {
+        return 0L;
+    }
+    return &(sim->beings[index]);
+}
+
+/* adds up the positive and the negative affect within memory in one look through it */
+void being_affect_totals(noble_simulation * local_sim, noble_being * local, n_uint * positive, n_uint * negative)
 {
-    n_uint affect = 0;
+    n_uint positive_affect = 0, negative_affect = 0;
 #ifdef EPISODIC_ON
     n_uint i;
     episodic_memory * local_episodic = (episodic_memory*)GET_EPI(local_sim, local);
-    if (!local_episodic) return affect;
-
-    for (i=0; i<EPISODIC_SIZE; i++)
+    if (local_episodic)
     {
-        if (is_positive!=0)
+        for (i=0; i<EPISODIC_SIZE; i++)
         {
             if (local_episodic[i].affect>EPISODIC_AFFECT_ZERO)
             {
-                affect += (n_uint)(local_episodic[i].affect) - EPISODIC_AFFECT_ZERO;
+                positive_affect += (n_uint)(local_episodic[i].affect) - EPISODIC_AFFECT_ZERO;
             }
-        }
-        else
-        {
-            if (local_episodic[i].affect<EPISODIC_AFFECT_ZERO)
+            else if (local_episodic[i].affect<EPISODIC_AFFECT_ZERO)
             {
-                affect += EPISODIC_AFFECT_ZERO - (n_uint)(local_episodic[i].affect);
+                negative_affect += EPISODIC_AFFECT_ZERO - (n_uint)(local_episodic[i].affect);
             }
         }
     }
 #endif
-    return affect;
+    *positive = positive_affect;
+    *negative = negative_affect;
+}
+
+/* returns the total positive and negative affect within memory */
+n_uint being_affect(noble_simulation * local_sim, noble_being * local, n_byte is_positive)
+{
+    n_uint positive, negative;
+    being_affect_totals(local_sim, local, &positive, &negative);
+    if (is_positive!=0)
+    {
+        return positive;
+    }
+    return negative;
 }
 
 const n_string body_inventory_description[INVENTORY_SIZE] =
@@ -1291,11 +1511,12 @@ n_int brain_probe_to_location(n_int position)
 static void update_brain_probes(noble_simulation * sim, noble_being * local)
 {
     n_byte * brain_point = GET_B(sim, local);
+    noble_brain_probe * brainprobe = GET_BP(sim, local);
     n_int    i, inputs = 0, outputs = 0;
 	/* count the inputs and outputs */
     for (i=0; i<BRAINCODE_PROBES; i++)
     {
-        if (local->brainprobe[i].type == INPUT_SENSOR)
+        if (brainprobe[i].type == INPUT_SENSOR)
         {
             inputs++;
         }
@@ -1307,42 +1528,44 @@ static void update_brain_probes(noble_simulation * sim, noble_being * local)
     /* check to ensure that there are a minimum number of sensors and actuators */
     if (inputs < (BRAINCODE_PROBES>>2))
     {
-        local->brainprobe[0].type = INPUT_SENSOR;
+        brainprobe[0].type = INPUT_SENSOR;
     }
 	else
 	{
 		if (outputs < (BRAINCODE_PROBES>>2))
 		{
-			local->brainprobe[0].type = OUTPUT_ACTUATOR;
+			brainprobe[0].type = OUTPUT_ACTUATOR;
 		}
 	}
 	/* update each probe */
     for (i=0; i<BRAINCODE_PROBES; i++)
     {
-		local->brainprobe[i].state++;		
-		if (local->brainprobe[i].state >= local->brainprobe[i].frequency)
+		brainprobe[i].state++;		
+		if (brainprobe[i].state >= brainprobe[i].frequency)
         {
 			/* position within the brain */
-			n_int n1 = brain_probe_to_location(local->brainprobe[i].position);
+			n_int n1 = brain_probe_to_location(brainprobe[i].position);
             
-			local->brainprobe[i].state = 0;
+			brainprobe[i].state = 0;
             
-			if (local->brainprobe[i].type == INPUT_SENSOR)
+			if (brainprobe[i].type == INPUT_SENSOR)
             {
                 n_byte * local_braincode = GET_BRAINCODE_INTERNAL(sim,local);
 				/* address within braincode */
-				n_int n2 = local->brainprobe[i].address % BRAINCODE_SIZE;
-                n_int n3 = (brain_point[n1] + local->brainprobe[i].offset)&255;
-                n_int n4 = (brain_point[n1] + local->brainprobe[i].address)&255;
+				n_int n2 = brainprobe[i].address % BRAINCODE_SIZE;
+                n_int n3 = (brain_point[n1] + brainprobe[i].offset)&255;
+                n_int n4 = (brain_point[n1] + brainprobe[i].address)&255;
 				/* Change address */
-				local->brainprobe[i].address = n4;
+				brainprobe[i].address = n4;
 				/* read from brain */
                 local_braincode[n2] = n3;
+                brain_braincode_changed(sim, local_braincode, n2, 1);
             }
 			else
             {
 				/* write to brain */
 				brain_point[n1] = 255;
+				brain_wake(sim, local);
 			}
 		}
     }
@@ -1350,6 +1573,80 @@ static void update_brain_probes(noble_simulation * sim, noble_being * local)
 
 #endif
 
+/**
+ * Clears the water fields before any are made
+ * @param sim Pointer to the simulation
+ */
+void being_water_init(noble_simulation * sim)
+{
+    n_int loop = 0;
+    while (loop < LAND_TIDE_LEVELS)
+    {
+        sim->water_field[loop] = 0L;
+        loop++;
+    }
+}
+
+/**
+ * Frees the water fields that have been made
+ * @param sim Pointer to the simulation
+ */
+void being_water_free(noble_simulation * sim)
+{
+    n_int loop = 0;
+    while (loop < LAND_TIDE_LEVELS)
+    {
+        io_free((void *)sim->water_field[loop]);
+        sim->water_field[loop] = 0L;
+        loop++;
+    }
+}
+
+/**
+ * Drops the water fields whenever the land is made or loaded. They are made
+ * again from the new land as each tide level is used.
+ * @param sim Pointer to the simulation
+ */
+void being_water_rebuild(noble_simulation * sim)
+{
+    being_water_free(sim);
+}
+
+/**
+ * Returns the water field of a tide level, making it the first time the tide
+ * level is used. There are at most LAND_TIDE_LEVELS of these.
+ * @param sim Pointer to the simulation
+ * @param tide The tide level
+ * @return The field from land_water_field or 0L if it could not be made
+ */
+n_byte * being_water_field(noble_simulation * sim, n_byte tide)
+{
+    n_int    level = tide - TIDE_MIN;
+    n_byte2 * distance;
+
+    if ((level < 0) || (level >= LAND_TIDE_LEVELS))
+    {
+        return 0L;
+    }
+    if (sim->water_field[level] != 0L)
+    {
+        return sim->water_field[level];
+    }
+    distance = (n_byte2 *)io_new(MAP_AREA * sizeof(n_byte2));
+    if (distance == 0L)
+    {
+        return 0L;
+    }
+    sim->water_field[level] = (n_byte *)io_new(2 * MAP_AREA);
+    if (sim->water_field[level] != 0L)
+    {
+        land_water_field(sim->land, tide, sim->water_field[level], distance);
+    }
+    io_free((void *)distance);
+    return sim->water_field[level];
+}
+
+/* used only when there is no water field for the tide */
 static n_int being_turn_away_from_water(n_int loc_f, n_land * land, n_vect2 * location_vector)
 {
     n_int	it_water_turn = 0;
@@ -1395,14 +1692,20 @@ void being_cycle_universal(noble_simulation * sim, noble_being * local, n_byte a
 {
     /* By default return towards a resting state */
 #ifdef METABOLISM_ON
-    metabolism_cycle(sim, local);
+    if (SIM_SCHEDULED(sim, SCHEDULE_METABOLISM))
+    {
+        metabolism_cycle(sim, local);
+    }
 #endif
     
-    being_immune_response(local);
+    if (SIM_SCHEDULED(sim, SCHEDULE_IMMUNE))
+    {
+        being_immune_response(sim, local);
+    }
 
 #ifdef BRAINCODE_ON
-    /* may need to add external probe linking too */
-    if (GET_B(sim,local))
+    /* may need to add external probe linking too, a sleeping being only has its turn at the probes with its brain */
+    if (GET_B(sim,local) && (awake || SIM_SLEEP_TURN(sim, local)))
     {
         update_brain_probes(sim, local);
     }
@@ -1542,6 +1845,259 @@ static void being_create_family_links(noble_being * mother,
 
 }
 
+/**
+ * Called for each being found by a spatial search
+ * @param sim Pointer to the simulation
+ * @param other_index Array index of the being found
+ * @param data Search specific information
+ * @return The squared distance that is still of interest to the search
+ */
+typedef n_uint (being_space_visit)(noble_simulation * sim, n_uint other_index, void * data);
+
+/**
+ * Allocates the spatial index used to find nearby beings
+ * @param sim Pointer to the simulation
+ * @return 0 on success, -1 if the memory could not be allocated
+ */
+n_int being_space_init(noble_simulation * sim)
+{
+    sim->space_num  = NO_BEINGS_FOUND;
+    sim->space_head = (n_uint *)io_new(BEING_SPACE_CELLS * sizeof(n_uint));
+    sim->space_next = (n_uint *)io_new(sim->max * sizeof(n_uint));
+    if ((sim->space_head == 0L) || (sim->space_next == 0L))
+    {
+        being_space_free(sim);
+        return SHOW_ERROR("Spatial index not allocated");
+    }
+    return 0;
+}
+
+/**
+ * Frees the spatial index
+ * @param sim Pointer to the simulation
+ */
+void being_space_free(noble_simulation * sim)
+{
+    io_free((void *)sim->space_head);
+    io_free((void *)sim->space_next);
+    sim->space_head = 0L;
+    sim->space_next = 0L;
+    sim->space_num  = NO_BEINGS_FOUND;
+}
+
+/* cell co-ordinate of an apespace value, anything past the bounds is kept in the edge cell */
+static n_int being_space_cell(n_int value)
+{
+    n_int cell = value >> BEING_SPACE_BITS;
+    if (cell >= BEING_SPACE_DIMENSION)
+    {
+        cell = BEING_SPACE_DIMENSION - 1;
+    }
+    return cell;
+}
+
+static n_uint being_space_location(noble_being * local)
+{
+    return (n_uint)(being_space_cell(GET_X(local)) +
+                    (being_space_cell(GET_Y(local)) * BEING_SPACE_DIMENSION));
+}
+
+static void being_space_link(noble_simulation * sim, n_uint index)
+{
+    n_uint location = being_space_location(&sim->beings[index]);
+    sim->space_next[index] = sim->space_head[location];
+    sim->space_head[location] = index;
+}
+
+static void being_space_unlink(noble_simulation * sim, n_uint index)
+{
+    n_uint * link = &sim->space_head[being_space_location(&sim->beings[index])];
+    while (*link != NO_BEINGS_FOUND)
+    {
+        if (*link == index)
+        {
+            *link = sim->space_next[index];
+            return;
+        }
+        link = &sim->space_next[*link];
+    }
+}
+
+/**
+ * Rebuilds the spatial index from the current being locations. The index is
+ * kept up to date through births and carrying until being_tidy moves the beings
+ * or being_remove compacts them.
+ * @param sim Pointer to the simulation
+ */
+void being_space_rebuild(noble_simulation * sim)
+{
+    n_uint loop = 0;
+    if (sim->space_head == 0L)
+    {
+        return;
+    }
+    while (loop < BEING_SPACE_CELLS)
+    {
+        sim->space_head[loop++] = NO_BEINGS_FOUND;
+    }
+    loop = 0;
+    while (loop < sim->num)
+    {
+        being_space_link(sim, loop++);
+    }
+    sim->space_num = sim->num;
+}
+
+/* the last being in the array has just been born */
+static void being_space_birth(noble_simulation * sim)
+{
+    if ((sim->space_num + 1) == sim->num)
+    {
+        being_space_link(sim, sim->space_num);
+        sim->space_num++;
+    }
+}
+
+/* move a being keeping the spatial index current */
+static void being_space_move(noble_simulation * sim, noble_being * local, n_byte2 x, n_byte2 y)
+{
+    n_uint index = (n_uint)(local - sim->beings);
+    n_byte indexed = (sim->space_num == sim->num);
+
+    if (indexed)
+    {
+        being_space_unlink(sim, index);
+    }
+    GET_X(local) = x;
+    GET_Y(local) = y;
+    if (indexed)
+    {
+        being_space_link(sim, index);
+    }
+}
+
+/* visit every being in the given cell, returning the smallest distance still of interest */
+static n_uint being_space_visit_cell(noble_simulation * sim, n_int px, n_int py,
+                                     being_space_visit * visit, void * data, n_uint need)
+{
+    n_uint index;
+    if ((px < 0) || (py < 0) || (px >= BEING_SPACE_DIMENSION) || (py >= BEING_SPACE_DIMENSION))
+    {
+        return need;
+    }
+    index = sim->space_head[px + (py * BEING_SPACE_DIMENSION)];
+    while (index != NO_BEINGS_FOUND)
+    {
+        need = (visit)(sim, index, data);
+        index = sim->space_next[index];
+    }
+    return need;
+}
+
+/**
+ * Visits the beings around a point in rings of cells moving outwards, stopping
+ * once the nearest possible being in the next ring is further than the squared
+ * distance returned by the visit function. The order of the visits is not the
+ * array order so the visit function needs to break ties by array index.
+ * Without a current index every being is visited in array order.
+ * @param sim Pointer to the simulation
+ * @param x The x location in apespace
+ * @param y The y location in apespace
+ * @param visit The function called for each being found
+ * @param data Search specific information passed to the visit function
+ */
+static void being_space_search(noble_simulation * sim, n_int x, n_int y,
+                               being_space_visit * visit, void * data)
+{
+    n_uint need = 0xffffffff;
+    n_int  cx, cy, ring = 0;
+
+    if (sim->space_num != sim->num)
+    {
+        n_uint loop = 0;
+        while (loop < sim->num)
+        {
+            (void)(visit)(sim, loop++, data);
+        }
+        return;
+    }
+
+    cx = being_space_cell(x);
+    cy = being_space_cell(y);
+
+    while (ring < BEING_SPACE_DIMENSION)
+    {
+        n_int py = cy - ring;
+        if (ring > 1)
+        {
+            n_uint lower = (n_uint)(ring - 1) << BEING_SPACE_BITS;
+            if ((lower * lower) > need)
+            {
+                return;
+            }
+        }
+        while (py <= (cy + ring))
+        {
+            if ((py == (cy - ring)) || (py == (cy + ring)))
+            {
+                n_int px = cx - ring;
+                while (px <= (cx + ring))
+                {
+                    need = being_space_visit_cell(sim, px++, py, visit, data, need);
+                }
+            }
+            else
+            {
+                need = being_space_visit_cell(sim, cx - ring, py, visit, data, need);
+                need = being_space_visit_cell(sim, cx + ring, py, visit, data, need);
+            }
+            py++;
+        }
+        ring++;
+    }
+}
+
+/**
+ * Visits the beings which could be within the squared distance of a point
+ * @param sim Pointer to the simulation
+ * @param x The x location in apespace
+ * @param y The y location in apespace
+ * @param range The squared distance in apespace
+ * @param visit The function called for each being found
+ * @param data Search specific information passed to the visit function
+ */
+static void being_space_range(noble_simulation * sim, n_int x, n_int y, n_uint range,
+                              being_space_visit * visit, void * data)
+{
+    n_int radius = (n_int)math_root(range) + 1;
+    n_int px_start, px_end, py, py_end;
+
+    if (sim->space_num != sim->num)
+    {
+        n_uint loop = 0;
+        while (loop < sim->num)
+        {
+            (void)(visit)(sim, loop++, data);
+        }
+        return;
+    }
+
+    px_start = being_space_cell((x < radius) ? 0 : (x - radius));
+    px_end   = being_space_cell(x + radius);
+    py       = being_space_cell((y < radius) ? 0 : (y - radius));
+    py_end   = being_space_cell(y + radius);
+
+    while (py <= py_end)
+    {
+        n_int px = px_start;
+        while (px <= px_end)
+        {
+            (void)being_space_visit_cell(sim, px++, py, visit, data, 0);
+        }
+        py++;
+    }
+}
+
 /**
  * Follow a being to which we are paying attention
  * @param sim Pointer to the simulation
@@ -1575,18 +2131,15 @@ static int being_follow(noble_simulation * sim,
     /* is a mate in view? */
     if (local->goal[0]==GOAL_MATE)
     {
-        for (i = 0; i < sim->num; i++)
+        /** the beings with the name of the mate sought, in array order */
+        for (i = being_named(sim, local->goal[1], local->goal[2], NO_BEINGS_FOUND);
+                i != NO_BEINGS_FOUND;
+                i = being_named(sim, local->goal[1], local->goal[2], i))
         {
             if (i != current_being_index)
             {
-                /** get the name of the other being */
                 noble_being * other = &being_buffer[i];
-                n_byte2 other_first_name = GET_NAME_GENDER(sim,other);
-                n_byte2 other_family_name = GET_NAME_FAMILY2(sim,other);
-                /** is this the same as the name of the being to which we are paying attention? */
-                if ((FIND_SEX(GET_I(other))!=FIND_SEX(GET_I(local))) &&
-                        (local->goal[1]==other_first_name) &&
-                        (local->goal[2]==other_family_name))
+                if (FIND_SEX(GET_I(other))!=FIND_SEX(GET_I(local)))
                 {
                     vect2_byte2(&difference_vector, (n_byte2 *)&GET_X(other));
                     vect2_subtract(&difference_vector, &location_vector, &difference_vector);
@@ -1613,38 +2166,35 @@ static int being_follow(noble_simulation * sim,
             (local_social_graph[social_graph_index].entity_type==ENTITY_BEING) &&
             (!SOCIAL_GRAPH_ENTRY_EMPTY(local_social_graph, social_graph_index)))
     {
-        /** search for the other being */
-        for (i = 0; i < sim->num; i++)
+        n_byte2 met_first_name = local_social_graph[social_graph_index].first_name[BEING_MET];
+        n_byte2 met_family_name = local_social_graph[social_graph_index].family_name[BEING_MET];
+
+        /** search for the other being, the beings with its name in array order */
+        for (i = being_named(sim, met_first_name, met_family_name, NO_BEINGS_FOUND);
+                i != NO_BEINGS_FOUND;
+                i = being_named(sim, met_first_name, met_family_name, i))
         {
             if (i != current_being_index)
             {
-                /** get the name of the other being */
                 noble_being * other = &being_buffer[i];
-                n_byte2 other_first_name = GET_NAME_GENDER(sim,other);
-                n_byte2 other_family_name = GET_NAME_FAMILY2(sim,other);
-                /** is this the same as the name of the being to which we are paying attention? */
-                if ((local_social_graph[social_graph_index].first_name[BEING_MET]==other_first_name) &&
-                        (local_social_graph[social_graph_index].family_name[BEING_MET]==other_family_name))
+                /** Is this being within sight? */
+                vect2_byte2(&difference_vector, (n_byte2 *)&GET_X(other));
+                vect2_subtract(&difference_vector, &location_vector, &difference_vector);
+                result_los = being_los(sim->land, local, (n_byte2)difference_vector.x, (n_byte2)difference_vector.y);
+                if (result_los)
                 {
-                    /** Is this being within sight? */
-                    vect2_byte2(&difference_vector, (n_byte2 *)&GET_X(other));
-                    vect2_subtract(&difference_vector, &location_vector, &difference_vector);
-                    result_los = being_los(sim->land, local, (n_byte2)difference_vector.x, (n_byte2)difference_vector.y);
-                    if (result_los)
+                    n_uint compare_distance = vect2_dot(&difference_vector, &difference_vector, 1, 1);
+                    if (FIND_SEX(GET_I(other))!=FIND_SEX(GET_I(local)))
                     {
-                        n_uint compare_distance = vect2_dot(&difference_vector, &difference_vector, 1, 1);
-                        if (FIND_SEX(GET_I(other))!=FIND_SEX(GET_I(local)))
-                        {
-                            *opposite_sex = i;
-                            *opposite_sex_distance = compare_distance;
-                        }
-                        else
-                        {
-                            *same_sex = i;
-                            *same_sex_distance = compare_distance;
-                        }
-                        return 1;
+                        *opposite_sex = i;
+                        *opposite_sex_distance = compare_distance;
+                    }
+                    else
+                    {
+                        *same_sex = i;
+                        *same_sex_distance = compare_distance;
                     }
+                    return 1;
                 }
             }
         }
@@ -1652,6 +2202,59 @@ static int being_follow(noble_simulation * sim,
     return 0;
 }
 
+typedef struct
+{
+    n_uint        current_being_index;
+    n_vect2       location_vector;
+    n_int         max_shout_volume;
+    n_uint        heard;
+}
+being_heard;
+
+static n_uint being_listen_visit(noble_simulation * sim, n_uint other_index, void * data)
+{
+    being_heard * listen = (being_heard *) data;
+
+    if (other_index != listen->current_being_index)
+    {
+        noble_being	* other = &sim->beings[other_index];
+        n_vect2       difference_vector;
+        n_uint        compare_distance;
+
+        vect2_byte2(&difference_vector, (n_byte2 *)&GET_X(other));
+        vect2_subtract(&difference_vector, &listen->location_vector, &difference_vector);
+        compare_distance = vect2_dot(&difference_vector, &difference_vector, 1, 1);
+
+        /* listen for the nearest shout out, the lowest index wins a tie */
+        if ((other->state&BEING_STATE_SHOUTING) &&
+                (compare_distance < SHOUT_RANGE) &&
+                ((other->shout[SHOUT_VOLUME] > listen->max_shout_volume) ||
+                 ((other->shout[SHOUT_VOLUME] == listen->max_shout_volume) &&
+                  (listen->heard != NO_BEINGS_FOUND) && (other_index < listen->heard))))
+        {
+            listen->max_shout_volume = other->shout[SHOUT_VOLUME];
+            listen->heard = other_index;
+        }
+    }
+    return SHOUT_RANGE;
+}
+
+/* the loudest shout within range, this only reads the other beings */
+static n_uint being_loudest(noble_simulation * sim, n_uint current_being_index)
+{
+    noble_being * local = &sim->beings[current_being_index];
+    being_heard   listen;
+
+    listen.current_being_index = current_being_index;
+    listen.max_shout_volume = 127;
+    listen.heard = NO_BEINGS_FOUND;
+    vect2_byte2(&listen.location_vector, (n_byte2 *)&GET_X(local));
+
+    being_space_range(sim, GET_X(local), GET_Y(local), SHOUT_RANGE, &being_listen_visit, &listen);
+
+    return listen.heard;
+}
+
 /**
  * Listen for shouts
  * @param sim Pointer to the simulation
@@ -1660,12 +2263,7 @@ static int being_follow(noble_simulation * sim,
 static void being_listen(noble_simulation * sim,
                          n_uint current_being_index)
 {
-    n_int i;
-    noble_being * being_buffer = sim->beings;
-    noble_being * local        = &being_buffer[current_being_index];
-    n_int         max_shout_volume = 127;
-    n_vect2       location_vector, difference_vector;
-    n_uint        compare_distance;
+    noble_being * local = &sim->beings[current_being_index];
 
     /* clear shout values */
     local->shout[SHOUT_CONTENT] = 0;
@@ -1675,29 +2273,100 @@ static void being_listen(noble_simulation * sim,
         local->shout[SHOUT_CTR]--;
     }
 
-    vect2_byte2(&location_vector, (n_byte2 *)&GET_X(local));
-    for (i = 0; i < sim->num; i++)
+    if (current_being_index < sim->senses_num)
+    {
+        noble_senses * senses = &sim->senses[current_being_index];
+        if (senses->heard)
+        {
+            local->shout[SHOUT_HEARD] = senses->shout[0];
+            local->shout[SHOUT_FAMILY0] = senses->shout[1];
+            local->shout[SHOUT_FAMILY1] = senses->shout[2];
+        }
+    }
+    else
     {
-        if (i != current_being_index)
+        n_uint heard = being_loudest(sim, current_being_index);
+        if (heard != NO_BEINGS_FOUND)
         {
-            noble_being	* other = &being_buffer[i];
+            noble_being * other = &sim->beings[heard];
+            local->shout[SHOUT_HEARD] = other->shout[SHOUT_CONTENT];
+            local->shout[SHOUT_FAMILY0] = GET_FAMILY_FIRST_NAME(sim,other);
+            local->shout[SHOUT_FAMILY1] = GET_FAMILY_SECOND_NAME(sim,other);
+        }
+    }
+}
+
+typedef struct
+{
+    n_uint        current_being_index;
+    noble_being * local;
+    n_vect2       location_vector;
+    n_uint        local_is_female;
+    n_uint        opposite_sex;
+    n_uint        same_sex;
+    n_uint        opposite_sex_distance;
+    n_uint        same_sex_distance;
+    n_byte        beings_in_vicinity;
+}
+being_nearest;
+
+static n_uint being_closest_visit(noble_simulation * sim, n_uint other_index, void * data)
+{
+    being_nearest * nearest = (being_nearest *) data;
+    n_uint          need = SOCIAL_RANGE - 1;
 
-            vect2_byte2(&difference_vector, (n_byte2 *)&GET_X(other));
-            vect2_subtract(&difference_vector, &location_vector, &difference_vector);
-            compare_distance = vect2_dot(&difference_vector, &difference_vector, 1, 1);
+    if (other_index != nearest->current_being_index)
+    {
+        noble_being	* test_being = &sim->beings[other_index];
+        /* check distance before line of sight */
+        n_vect2       difference_vector;
+        n_uint        compare_distance;
+
+        vect2_byte2(&difference_vector, (n_byte2 *)&GET_X(test_being));
+        vect2_subtract(&difference_vector, &nearest->location_vector, &difference_vector);
+        compare_distance = vect2_dot(&difference_vector, &difference_vector, 1, 1);
+
+        if ( compare_distance < SOCIAL_RANGE )
+        {
+            nearest->beings_in_vicinity++;
+        }
 
-            /* listen for the nearest shout out */
-            if ((other->state&BEING_STATE_SHOUTING) &&
-                    (compare_distance < SHOUT_RANGE) &&
-                    (other->shout[SHOUT_VOLUME] > max_shout_volume))
+        /* the closest being in sight is kept, the lowest index wins a tie */
+        if (FIND_SEX(GET_I(test_being)) != nearest->local_is_female)
+        {
+            if (( compare_distance < nearest->opposite_sex_distance ) ||
+                    (( compare_distance == nearest->opposite_sex_distance ) && (other_index < nearest->opposite_sex)))
+            {
+                /* 'function' : conversion from 'n_int' to 'n_byte2', possible loss of data x 2 */
+                if (being_los(sim->land, nearest->local, (n_byte2)difference_vector.x, (n_byte2)difference_vector.y))
+                {
+                    nearest->opposite_sex_distance = compare_distance;
+                    nearest->opposite_sex = other_index;
+                }
+            }
+        }
+        else
+        {
+            if (( compare_distance < nearest->same_sex_distance ) ||
+                    (( compare_distance == nearest->same_sex_distance ) && (other_index < nearest->same_sex)))
             {
-                max_shout_volume = other->shout[SHOUT_VOLUME];
-                local->shout[SHOUT_HEARD] = other->shout[SHOUT_CONTENT];
-                local->shout[SHOUT_FAMILY0] = GET_FAMILY_FIRST_NAME(sim,other);
-                local->shout[SHOUT_FAMILY1] = GET_FAMILY_SECOND_NAME(sim,other);
+                if (being_los(sim->land, nearest->local, (n_byte2)difference_vector.x, (n_byte2)difference_vector.y))
+                {
+                    nearest->same_sex_distance = compare_distance;
+                    nearest->same_sex = other_index;
+                }
             }
         }
     }
+    if (nearest->opposite_sex_distance > need)
+    {
+        need = nearest->opposite_sex_distance;
+    }
+    if (nearest->same_sex_distance > need)
+    {
+        need = nearest->same_sex_distance;
+    }
+    return need;
 }
 
 /**
@@ -1715,78 +2384,68 @@ static int being_closest(noble_simulation * sim,
                          n_uint	* opposite_sex, n_uint * same_sex,
                          n_uint * opposite_sex_distance, n_uint * same_sex_distance)
 {
-    n_byte        opposite_sex_seen = 0;
-    n_uint	      loop = 0;
-    noble_being * being_buffer = sim->beings;
-    n_uint        number       = sim->num;
-    noble_being * local        = &being_buffer[current_being_index];
-    n_vect2       location_vector;
-    n_byte        beings_in_vicinity = 0;
-    n_uint        local_is_female = FIND_SEX(GET_I(local));
-
-    *opposite_sex_distance = 0xffffffff;
-    *same_sex_distance = 0xffffffff;
-    *opposite_sex = NO_BEINGS_FOUND;
-    *same_sex = NO_BEINGS_FOUND;
-
-    vect2_byte2(&location_vector, (n_byte2 *)&GET_X(local));
+    noble_being * local = &sim->beings[current_being_index];
+    being_nearest nearest;
+
+    nearest.current_being_index = current_being_index;
+    nearest.local = local;
+    nearest.local_is_female = FIND_SEX(GET_I(local));
+    nearest.opposite_sex_distance = 0xffffffff;
+    nearest.same_sex_distance = 0xffffffff;
+    nearest.opposite_sex = NO_BEINGS_FOUND;
+    nearest.same_sex = NO_BEINGS_FOUND;
+    nearest.beings_in_vicinity = 0;
+    vect2_byte2(&nearest.location_vector, (n_byte2 *)&GET_X(local));
+
+    being_space_search(sim, GET_X(local), GET_Y(local), &being_closest_visit, &nearest);
+
+    *opposite_sex_distance = nearest.opposite_sex_distance;
+    *same_sex_distance = nearest.same_sex_distance;
+    *opposite_sex = nearest.opposite_sex;
+    *same_sex = nearest.same_sex;
+    return nearest.beings_in_vicinity;
+}
 
-    while (loop < number)
+/* the being paid attention to if it is in sight, otherwise the closest beings */
+static n_byte being_nearby(noble_simulation * sim,
+                           n_uint current_being_index,
+                           n_uint * opposite_sex, n_uint * same_sex,
+                           n_uint * opposite_sex_distance, n_uint * same_sex_distance)
+{
+    n_byte beings_in_vicinity = (n_byte)being_follow(sim, current_being_index,
+                                opposite_sex, same_sex,
+                                opposite_sex_distance, same_sex_distance);
+    if (beings_in_vicinity == 0)
     {
-        if (loop != current_being_index)
-        {
-            noble_being	* test_being = &being_buffer[loop];
-            n_int         los_previously_calculated = 0;
-            n_int         result_los = 0;
-            /* check distance before line of sight */
-            n_vect2       difference_vector;
-            n_uint         compare_distance;
-
-            vect2_byte2(&difference_vector, (n_byte2 *)&GET_X(test_being));
-
-            vect2_subtract(&difference_vector, &location_vector, &difference_vector);
+        beings_in_vicinity = (n_byte)being_closest(sim, current_being_index,
+                             opposite_sex, same_sex,
+                             opposite_sex_distance, same_sex_distance);
+    }
+    return beings_in_vicinity;
+}
 
-            compare_distance = vect2_dot(&difference_vector, &difference_vector, 1, 1);
+/**
+ * Records what a being senses of the other beings. This only reads the beings
+ * so it can be run for all the beings at once at the start of the being cycle.
+ * @param sim Pointer to the simulation
+ * @param current_being_index Array index of the current being
+ */
+void being_sense(noble_simulation * sim, n_uint current_being_index)
+{
+    noble_senses * senses = &sim->senses[current_being_index];
+    n_uint         heard  = being_loudest(sim, current_being_index);
 
-            if ( compare_distance < SOCIAL_RANGE )
-            {
-                beings_in_vicinity++;
-            }
-            /* '<' : signed/unsigned mismatch */
-            if ((opposite_sex_seen==0) && ( compare_distance < *opposite_sex_distance ))
-            {
-                if (FIND_SEX(GET_I(test_being)) != local_is_female)
-                {
-                    /* 'function' : conversion from 'n_int' to 'n_byte2', possible loss of data x 2 */
-                    los_previously_calculated = 1;
-                    result_los = being_los(sim->land, local, (n_byte2)difference_vector.x, (n_byte2)difference_vector.y);
-                    if (result_los)
-                    {
-                        *opposite_sex_distance = compare_distance;
-                        *opposite_sex = loop;
-                    }
-                }
-            }
-            /* '<' : signed/unsigned mismatch */
-            if ( compare_distance < *same_sex_distance )
-            {
-                if (FIND_SEX(GET_I(test_being)) == local_is_female)
-                {
-                    if (los_previously_calculated == 0)
-                    {
-                        result_los = being_los(sim->land, local, (n_byte2)difference_vector.x,  (n_byte2)difference_vector.y);
-                    }
-                    if (result_los)
-                    {
-                        *same_sex_distance = compare_distance;
-                        *same_sex = loop;
-                    }
-                }
-            }
-        }
-        loop++;
+    senses->heard = (heard != NO_BEINGS_FOUND);
+    if (senses->heard)
+    {
+        noble_being * other = &sim->beings[heard];
+        senses->shout[0] = other->shout[SHOUT_CONTENT];
+        senses->shout[1] = (n_byte)GET_FAMILY_FIRST_NAME(sim,other);
+        senses->shout[2] = (n_byte)GET_FAMILY_SECOND_NAME(sim,other);
     }
-    return beings_in_vicinity;
+    senses->beings_in_vicinity = being_nearby(sim, current_being_index,
+                                 &senses->opposite_sex, &senses->same_sex,
+                                 &senses->opposite_sex_distance, &senses->same_sex_distance);
 }
 
 /**
@@ -1932,7 +2591,10 @@ void being_cycle_awake(noble_simulation * sim, n_uint current_being_index)
     being_listen(sim,current_being_index);
     
 #ifdef EPISODIC_ON
-    episodic_cycle(sim,local);
+    if (SIM_SCHEDULED(sim, SCHEDULE_EPISODIC))
+    {
+        episodic_cycle(sim,local);
+    }
 #endif
 
     vect2_byte2(&location_vector, (n_byte2 *)&GET_X(local));
@@ -1997,7 +2659,18 @@ void being_cycle_awake(noble_simulation * sim, n_uint current_being_index)
     if ((loc_state & BEING_STATE_SWIMMING) != 0)
 #endif
     {
-        loc_f = being_turn_away_from_water(loc_f, land, &location_vector);
+        n_byte * water_field = being_water_field(sim, land->tide_level);
+        if (water_field != 0L)
+        {
+            n_int  loc = POSITIVE_LAND_COORD(APESPACE_TO_MAPSPACE(location_vector.x)) |
+                         (POSITIVE_LAND_COORD(APESPACE_TO_MAPSPACE(location_vector.y)) << MAP_BITS);
+            n_byte heading = water_field[(loc << 1) | 1];
+            loc_f = math_turn_towards(VECT_X(heading), VECT_Y(heading), (n_byte)loc_f, 4);
+        }
+        else
+        {
+            loc_f = being_turn_away_from_water(loc_f, land, &location_vector);
+        }
         /** horizontally oriented posture */
         local->posture=0;
         /** When swimming drop everything except what's on your head or back.
@@ -2032,17 +2705,22 @@ void being_cycle_awake(noble_simulation * sim, n_uint current_being_index)
         /** adjust speed using genetics */
         tmp_speed = (tmp_speed * (GENE_SPEED(GET_G(local))+8)) >> 3;
 
-        /** is the being to which we are paying attention within view? */
-        beings_in_vicinity = being_follow(sim,current_being_index,
-                                          &opposite_sex, &same_sex,
-                                          &opposite_sex_distance, &same_sex_distance);
-        if (beings_in_vicinity==0)
+        /** is the being to which we are paying attention within view,
+            otherwise find the closest beings */
+        if (current_being_index < sim->senses_num)
         {
-            /** Find the closest beings */
-            beings_in_vicinity =
-                being_closest(sim, current_being_index,
-                              &opposite_sex, &same_sex,
-                              &opposite_sex_distance, &same_sex_distance);
+            noble_senses * senses = &sim->senses[current_being_index];
+            opposite_sex = senses->opposite_sex;
+            same_sex = senses->same_sex;
+            opposite_sex_distance = senses->opposite_sex_distance;
+            same_sex_distance = senses->same_sex_distance;
+            beings_in_vicinity = senses->beings_in_vicinity;
+        }
+        else
+        {
+            beings_in_vicinity = being_nearby(sim, current_being_index,
+                                              &opposite_sex, &same_sex,
+                                              &opposite_sex_distance, &same_sex_distance);
         }
 
         if (local->drives[DRIVE_SOCIAL] > SOCIAL_THRESHOLD(local))
@@ -2069,7 +2747,7 @@ void being_cycle_awake(noble_simulation * sim, n_uint current_being_index)
             {
                 /** eating when stopped */
                 n_byte  food_type;
-                n_int energy = food_eat(sim->land, sim->weather, location_vector.x, location_vector.y, az, &food_type, local);
+                n_int energy = food_eat(sim, location_vector.x, location_vector.y, az, &food_type, local);
 
                 GET_IN(sim).food[food_type]++;
 
@@ -2195,8 +2873,7 @@ void being_cycle_awake(noble_simulation * sim, n_uint current_being_index)
                             GET_A(local,ATTENTION_BODY) = BODY_BACK;
                         }
                         carrying_child = 1;
-                        GET_X(being_child) = GET_X(local);
-                        GET_Y(being_child) = GET_Y(local);
+                        being_space_move(sim, being_child, GET_X(local), GET_Y(local));
                         child_mass = GET_M(being_child);
                         episodic_close(sim, local, being_child, EVENT_CARRIED, AFFECT_CARRYING, 0);
                         episodic_close(sim, being_child, local, EVENT_CARRIED_BY, AFFECT_CARRIED, 0);
@@ -2259,7 +2936,7 @@ void being_cycle_awake(noble_simulation * sim, n_uint current_being_index)
                             /** set child state to suckling */
                             loc_state |= BEING_STATE_SUCKLING;
                             /** child acquires immunity from mother */
-                            being_immune_seed(mother, local);
+                            being_immune_seed(sim, mother, local);
                             
                             episodic_close(sim, mother, local, EVENT_SUCKLED, AFFECT_SUCKLING, 0);
                             episodic_close(sim, local, mother, EVENT_SUCKLED_BY, AFFECT_SUCKLING, 0);
@@ -2288,16 +2965,16 @@ void being_cycle_awake(noble_simulation * sim, n_uint current_being_index)
         APESPACE_TO_TERRITORY(local->y)*TERRITORY_DIMENSION +
         APESPACE_TO_TERRITORY(local->x);
 
-    if (local->territory[territory_index].familiarity<65534)
+    if (GET_T(sim, local)[territory_index].familiarity<65534)
     {
-        local->territory[territory_index].familiarity++;
+        GET_T(sim, local)[territory_index].familiarity++;
     }
     else
     {
         /** rescale familiarity values */
         for (territory_index=0; territory_index<TERRITORY_AREA; territory_index++)
         {
-            local->territory[territory_index].familiarity>>=2;
+            GET_T(sim, local)[territory_index].familiarity>>=2;
         }
     }
 #endif
@@ -2356,6 +3033,10 @@ void being_init_braincode(noble_simulation * sim,
                 GET_BRAINCODE_EXTERNAL(sim,local)[ch+2] = math_random(local_random) & 255;
             }
         }
+#ifdef BRAINCODE_ON
+        brain_braincode_changed(sim, GET_BRAINCODE_INTERNAL(sim,local), 0, BRAINCODE_SIZE);
+        brain_braincode_changed(sim, GET_BRAINCODE_EXTERNAL(sim,local), 0, BRAINCODE_SIZE);
+#endif
     }
     else
     {
@@ -2398,6 +3079,9 @@ void being_init_braincode(noble_simulation * sim,
 
         /* Copy braincode for the most similar individual */
         io_copy(graph[most_similar_index].braincode, graph[actor_index].braincode, BRAINCODE_SIZE);
+#ifdef BRAINCODE_ON
+        brain_braincode_changed(sim, graph[actor_index].braincode, 0, BRAINCODE_SIZE);
+#endif
     }
 }
 
@@ -2469,15 +3153,26 @@ static n_int being_set_unique_name(noble_simulation * sim,
 
         /* does the name already exist in the population */
         found = 1;
-        for (i = 0; i < sim->num; i++)
+        if (sim->index_num == sim->num)
         {
-            noble_being * other_being = &sim->beings[i];
-            if (other_being == local_being) continue;
-            if ((GET_NAME_GENDER(sim,other_being) == possible_first_name) &&
-                    (GET_NAME_FAMILY2(sim,other_being) == possible_family_name))
+            noble_being * other_being = being_find_name(sim, possible_first_name, possible_family_name);
+            if ((other_being != 0L) && (other_being != local_being))
             {
                 found = 0;
-                break;
+            }
+        }
+        else
+        {
+            for (i = 0; i < sim->num; i++)
+            {
+                noble_being * other_being = &sim->beings[i];
+                if (other_being == local_being) continue;
+                if ((GET_NAME_GENDER(sim,other_being) == possible_first_name) &&
+                        (GET_NAME_FAMILY2(sim,other_being) == possible_family_name))
+                {
+                    found = 0;
+                    break;
+                }
             }
         }
         if (found == 1)
@@ -2511,7 +3206,7 @@ n_int being_init(noble_simulation * sim, noble_being * mother,
 		/** this is the being to be born */
         noble_being * local = &(sim->beings[sim->num]);
         n_land  * land  = sim->land;
-        n_byte2	      local_random[2];
+        n_byte2	      local_random[2] = {0, 0};
         n_int	      loc_x;
         n_int         loc_y;
         n_byte	      loc_facing;
@@ -2533,11 +3228,14 @@ n_int being_init(noble_simulation * sim, noble_being * mother,
 
         local->brain_memory_location = numerical_brain_location;
 
+        io_erase((n_byte *) GET_COLD(sim, local), sizeof(noble_being_cold));
+
         brain_memory = GET_B(sim, local);
 
         if (brain_memory != 0L)
         {
             io_erase(brain_memory, DOUBLE_BRAIN);
+            brain_wake(sim, local);
         }
 
         local->goal[0]=GOAL_NONE;
@@ -2551,7 +3249,7 @@ n_int being_init(noble_simulation * sim, noble_being * mother,
             local->learned_preference[ch]=127;
         }
 
-        being_immune_init(local);
+        being_immune_init(sim, local);
 
         for (ch = 0; ch < ATTENTION_SIZE; ch++)
         {
@@ -2601,7 +3299,7 @@ n_int being_init(noble_simulation * sim, noble_being * mother,
         for (ch = 0; ch < BRAINCODE_PSPACE_REGISTERS; ch++)
         {
             math_random3(local_random);
-            local->braincode_register[ch]=(n_byte)local_random[0];
+            GET_BR(sim, local)[ch]=(n_byte)local_random[0];
         }
 
         /** initialize brainprobes */
@@ -2610,19 +3308,19 @@ n_int being_init(noble_simulation * sim, noble_being * mother,
             math_random3(local_random);
 			if ((n_byte)local_random[0]&1)
 			{
-				local->brainprobe[ch].type = INPUT_SENSOR;
+				GET_BP(sim, local)[ch].type = INPUT_SENSOR;
 			}
 			else
 			{
-				local->brainprobe[ch].type = OUTPUT_ACTUATOR;
+				GET_BP(sim, local)[ch].type = OUTPUT_ACTUATOR;
 			}
-            local->brainprobe[ch].frequency =
+            GET_BP(sim, local)[ch].frequency =
 				(n_byte)1 + (local_random[1]%BRAINCODE_MAX_FREQUENCY);
             math_random3(local_random);
-            local->brainprobe[ch].address = (n_byte)local_random[0];
-            local->brainprobe[ch].position = (n_byte)local_random[1];
+            GET_BP(sim, local)[ch].address = (n_byte)local_random[0];
+            GET_BP(sim, local)[ch].position = (n_byte)local_random[1];
             math_random3(local_random);
-            local->brainprobe[ch].offset = (n_byte)local_random[0];
+            GET_BP(sim, local)[ch].offset = (n_byte)local_random[0];
         }
 
 
@@ -2809,11 +3507,14 @@ n_int being_init(noble_simulation * sim, noble_being * mother,
             sim->ext_birth(local,mother,sim);
         }
 #ifdef METABOLISM_ON
-        metabolism_init(local);
+        metabolism_init(sim, local);
 #endif
     }
     sim->num++;
 
+    being_space_birth(sim);
+    being_index_birth(sim);
+
     return 0;
 }
 
@@ -2829,6 +3530,9 @@ void being_tidy(noble_simulation * local_sim)
 #ifdef PARASITES_ON
     n_byte       max_honor = 1;
 #endif
+    /* the beings are about to move */
+    local_sim->space_num = NO_BEINGS_FOUND;
+
     while (loop < number)
     {
         noble_being *local_being = &local[loop];
@@ -2960,25 +3664,198 @@ void being_tidy(noble_simulation * local_sim)
 #endif
 }
 
+/*
+ Each being keeps its brain memory location from birth to death, the brain,
+ social graph and episodic memory there never move. The locations of the
+ beings that died end up in the beings past num, the next being born takes
+ the location of the being at num.
+
+ The compaction before this moved the brain and social graph down with a
+ being but left the episodic memory at the location, so a being moved down
+ took the episodic memory of the being before it. Now everything stays with
+ the being, and a run with deaths differs from that compaction from the
+ first death. The selection is held as a being identity
+ so it stays on the same being as the beings before it die.
+ */
+
+/**
+ * Puts a location in each being and finds the being at each location.
+ * The identities of the beings already found stop being found.
+ * @param sim The simulation.
+ * @param identity Non zero to give each being the location of its index,
+ *        zero to keep the locations of the beings alive and give the rest the
+ *        locations not used.
+ */
+void being_slots_rebuild(noble_simulation * sim, n_byte identity)
+{
+    n_uint loop = 0, location = 0;
+
+    if (sim->slots == 0L)
+    {
+        return;
+    }
+    while (loop < sim->max)
+    {
+        sim->slots[loop].index = NO_BEINGS_FOUND;
+        sim->slots[loop].generation++;
+        loop++;
+    }
+    loop = 0;
+    if (identity == 0)
+    {
+        while (loop < sim->num)
+        {
+            sim->slots[sim->beings[loop].brain_memory_location].index = loop;
+            loop++;
+        }
+    }
+    while (loop < sim->max)
+    {
+        if (identity == 0)
+        {
+            while (sim->slots[location].index != NO_BEINGS_FOUND)
+            {
+                location++;
+            }
+        }
+        else
+        {
+            location = loop;
+        }
+        sim->beings[loop].brain_memory_location = (n_byte2)location;
+        sim->slots[location].index = loop;
+        loop++;
+    }
+}
+
+/**
+ * One more than the highest location used by a being alive, the memory
+ * locations below this hold all the beings.
+ * @param sim The simulation.
+ * @return The number of locations.
+ */
+n_uint being_locations(noble_simulation * sim)
+{
+    n_uint loop = 0, locations = sim->num;
+    while (loop < sim->num)
+    {
+        n_uint location = sim->beings[loop].brain_memory_location;
+        if ((location != NO_BRAIN_MEMORY_LOCATION) && (location >= locations))
+        {
+            locations = location + 1;
+        }
+        loop++;
+    }
+    return locations;
+}
+
+/**
+ * An identity for the being that stays the same while it is alive, as the
+ * beings around it die and are born, and is never given to another being.
+ * @param sim The simulation.
+ * @param local The being.
+ * @return The identity or NO_BEINGS_FOUND.
+ */
+n_uint being_id(noble_simulation * sim, noble_being * local)
+{
+    if ((sim->slots == 0L) || (local == 0L) || (local->brain_memory_location == NO_BRAIN_MEMORY_LOCATION))
+    {
+        return NO_BEINGS_FOUND;
+    }
+    return ((sim->slots[local->brain_memory_location].generation & BEING_ID_GENERATION) << 16) |
+           local->brain_memory_location;
+}
+
+/**
+ * Finds a being from its identity.
+ * @param sim The simulation.
+ * @param id The identity from being_id.
+ * @return The being or 0L if it has died.
+ */
+noble_being * being_from_id(noble_simulation * sim, n_uint id)
+{
+    n_uint location = id & 0xffff;
+    n_uint index;
+
+    if ((sim->slots == 0L) || (id == NO_BEINGS_FOUND) || (location >= sim->max))
+    {
+        return 0L;
+    }
+    if ((sim->slots[location].generation & BEING_ID_GENERATION) != ((id >> 16) & BEING_ID_GENERATION))
+    {
+        return 0L;
+    }
+    index = sim->slots[location].index;
+    if (index >= sim->num)
+    {
+        return 0L;
+    }
+    return &(sim->beings[index]);
+}
+
+/**
+ * Selects the being at an index, the selection then follows the being as the
+ * beings around it die.
+ * @param sim The simulation.
+ * @param index The index of the being or NO_BEINGS_FOUND for none.
+ */
+void being_select(noble_simulation * sim, n_uint index)
+{
+    sim->select = (index < sim->num) ? being_id(sim, &(sim->beings[index])) : NO_BEINGS_FOUND;
+}
+
+/**
+ * The selected being.
+ * @param sim The simulation.
+ * @return The being or 0L if none is selected or it has died.
+ */
+noble_being * being_selected(noble_simulation * sim)
+{
+    return being_from_id(sim, sim->select);
+}
+
+/**
+ * The index of the selected being, which changes as the beings before it die.
+ * @param sim The simulation.
+ * @return The index or NO_BEINGS_FOUND.
+ */
+n_uint being_selected_index(noble_simulation * sim)
+{
+    noble_being * selected = being_selected(sim);
+    if (selected == 0L)
+    {
+        return NO_BEINGS_FOUND;
+    }
+    return (n_uint)(selected - sim->beings);
+}
+
 n_int being_remove_internal = 0;
 n_int being_remove_external = 0;
 
 void being_remove(noble_simulation * local_sim)
 {
     noble_being * local = local_sim->beings;
-    n_uint	reference = local_sim->select;
+    n_uint	reference = being_selected_index(local_sim);
     n_uint  end_loop =  local_sim->num;
     n_uint  last_reference = reference;
     n_uint	count = 0;
     n_uint	possible = NO_BEINGS_FOUND;
     n_uint  loop=0;
     n_int   selected_died = 0;
-    
-    if (being_remove_external)
-        do{}while(being_remove_external);
-    
-    being_remove_internal = 1;
-    
+    /* only the simulation watched from the console shares its beings with the console */
+    n_byte  watched = local_sim->watched;
+
+    if (watched)
+    {
+        if (being_remove_external)
+            do{}while(being_remove_external);
+
+        being_remove_internal = 1;
+    }
+
+    /* the beings are about to be compacted */
+    local_sim->space_num = NO_BEINGS_FOUND;
+
     while (loop < end_loop)
     {
         if (local[loop].energy == 0)
@@ -2993,6 +3870,23 @@ void being_remove(noble_simulation * local_sim)
                 local_sim->ext_death(b,local_sim);
             }
 
+            /* the identity of the being dies with it and the being born next in its location starts with no social graph */
+            if ((local_sim->slots != 0L) && (b->brain_memory_location != NO_BRAIN_MEMORY_LOCATION))
+            {
+                local_sim->slots[b->brain_memory_location].generation++;
+                io_erase((n_byte *)GET_SOC(local_sim, b), (SOCIAL_SIZE * sizeof(social_link)));
+#ifdef BRAINCODE_ON
+                {
+                    social_link * graph = GET_SOC(local_sim, b);
+                    n_uint        link = 0;
+                    while (link < SOCIAL_SIZE)
+                    {
+                        brain_braincode_changed(local_sim, graph[link++].braincode, 0, BRAINCODE_SIZE);
+                    }
+                }
+#endif
+            }
+
             /* Did the being drown? */
             if (b->state&BEING_STATE_SWIMMING)
             {
@@ -3058,23 +3952,17 @@ void being_remove(noble_simulation * local_sim)
         {
             if ( count != loop )
             {
-                n_byte2        new_brain_memory_location = local[ count ].brain_memory_location;
-                n_byte       * new_brain = GET_B(local_sim, &local[ count ]);
-                n_byte       * old_brain = GET_B(local_sim, &local[ loop ]);
-                social_link * new_event = GET_SOC(local_sim, &local[ count ]);
-                social_link * old_event = GET_SOC(local_sim, &local[ loop ]);
+                /* the memory stays where it is, the vacant location moves to where the being was */
+                n_byte2 vacant_location = local[ count ].brain_memory_location;
+                n_byte2 being_location = local[ loop ].brain_memory_location;
 
                 io_copy((n_byte *)&local[ loop ], (n_byte *)&local[ count ], sizeof(noble_being));
+                local[ loop ].brain_memory_location = vacant_location;
 
-                if ((new_brain != 0L) && (old_brain != 0L))
+                if ((local_sim->slots != 0L) && (being_location != NO_BRAIN_MEMORY_LOCATION))
                 {
-                    io_copy(old_brain, new_brain, DOUBLE_BRAIN);
-                    io_erase(old_brain, DOUBLE_BRAIN);
-
-                    io_copy((n_byte *)old_event, (n_byte *)new_event, (SOCIAL_SIZE * sizeof(social_link)));
-                    io_erase((n_byte *)old_event, (SOCIAL_SIZE * sizeof(social_link)));
-
-                    local[ count ].brain_memory_location = new_brain_memory_location;
+                    local_sim->slots[being_location].index = count;
+                    local_sim->slots[vacant_location].index = loop;
                 }
             }
 
@@ -3108,17 +3996,26 @@ void being_remove(noble_simulation * local_sim)
     
     local_sim->num    = count;
 
+    if (count != end_loop)
+    {
+        being_index_rebuild(local_sim);
+    }
+
+    /* the selection follows a being that lives as it is compacted */
     if (selected_died)
     {
-        sim_set_select(possible);
+        sim_world_select(local_sim, possible);
     }
 
     if ((possible == NO_BEINGS_FOUND) && (last_reference != NO_BEINGS_FOUND))
     {
         (void)SHOW_ERROR("No Apes remain start new run");
     }
-    
-    being_remove_internal = 0;
+
+    if (watched)
+    {
+        being_remove_internal = 0;
+    }
 }
 
 
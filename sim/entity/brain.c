@@ -49,6 +49,13 @@
 
 #include <stdio.h>
 
+/* the middle of the brain is cycled with SSE2 or AVX2 where the processor has them */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BRAIN_VECTOR
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
 /*NOBLEMAKE END=""*/
 
 /*NOBLEMAKE VAR=""*/
@@ -88,60 +95,338 @@
 #define	B_N_UH (br[(loc+B_Z)&B_WR]+br[(loc+B_Y)&B_WR]+br[(loc+B_X)&B_WR])
 
 
-void brain_cycle(n_byte * local, n_byte2 * constants)
+/*
+ *	The previous brain is only read at the location being written, so the
+ *	current value is moved into it as each location is updated. This avoids a
+ *	shared frame buffer and lets any number of brains cycle at the same time.
+ */
+
+typedef void (brain_middle)(n_byte * br, n_byte * obr, n_int l_a, n_int l_b, n_int l_c);
+
+static void brain_middle_scalar(n_byte * br, n_byte * obr, n_int l_a, n_int l_b, n_int l_c)
 {
-    static n_byte frame[B_SIZE];
-    n_byte  *br = local, *obr = &local[B_SIZE];
-    n_int  l_a = constants[0], l_c = constants[2];
-    n_int  l_b = constants[1] + l_c, loc = 0;
+    n_int  loc = F_Z;
     n_int  average;
     n_int  obr_tmp;
     n_int  br_tmp;
 
-    io_copy(br, frame, B_SIZE);
-
-    while (loc < F_Z)
+    while (loc < B_Z)
     {
-        average = (B_P_LH + B_N_UH);
+        average =  br[loc-F_Z];
+        average += br[loc-F_Y];
+        average += br[loc-F_X];
         br_tmp = br[loc];
+        average += br[loc+F_X];
+        average += br[loc+F_Y];
+        average += br[loc+F_Z];
         obr_tmp = obr[loc];
+        obr[loc] = (n_byte)br_tmp;
 
         average *= l_a;
         obr_tmp *= l_c;
-        
+
         br_tmp *= l_b;        
         br_tmp -= obr_tmp;
         average += br_tmp;
-
+        
         br[loc++] = (n_byte)(average>>10);
     }
-        
+}
+
+#ifdef BRAIN_VECTOR
+
+/*
+ *	Each location depends on the location before it which has just been
+ *	written. Everything else it reads is either written in an earlier block
+ *	or not yet written, so a block is summed in parallel first and then
+ *	finished in order adding the location before.
+ */
+
+#define BRAIN_BLOCK  (32)
+
+static void brain_middle_block(n_byte * br, n_int loc, n_int l_a, int * partial)
+{
+    n_int previous = br[loc - F_X];
+    n_int loop = 0;
+    while (loop < BRAIN_BLOCK)
+    {
+        previous = (n_byte)((partial[loop] + (previous * l_a)) >> 10);
+        br[loc + loop] = (n_byte)previous;
+        loop++;
+    }
+}
+
+/* unsigned 16 bit lanes multiplied out to 32 bits */
+#define BRAIN_MUL_LO(v, k)  _mm_unpacklo_epi16(_mm_mullo_epi16(v, k), _mm_mulhi_epu16(v, k))
+#define BRAIN_MUL_HI(v, k)  _mm_unpackhi_epi16(_mm_mullo_epi16(v, k), _mm_mulhi_epu16(v, k))
+
+__attribute__((target("sse2")))
+static void brain_middle_sse2(n_byte * br, n_byte * obr, n_int l_a, n_int l_b, n_int l_c)
+{
+    int     partial[BRAIN_BLOCK];
+    n_int   loc = F_Z;
+    __m128i zero = _mm_setzero_si128();
+    __m128i k_a = _mm_set1_epi16((short)l_a);
+    __m128i k_m = _mm_set1_epi16((short)(l_b - l_c));
+    __m128i k_c = _mm_set1_epi16((short)l_c);
+
     while (loc < B_Z)
     {
-        average =  br[loc-F_Z];
-        average += br[loc-F_Y];
-        average += br[loc-F_X];
+        n_int  offset = 0;
+        while (offset < BRAIN_BLOCK)
+        {
+            n_byte * at = &br[loc + offset];
+            __m128i  v_br  = _mm_loadu_si128((__m128i *)at);
+            __m128i  v_obr = _mm_loadu_si128((__m128i *)&obr[loc + offset]);
+            __m128i  v_sum[2], v_b[2], v_o[2];
+            n_int    half = 0;
+
+            v_sum[0] = _mm_unpacklo_epi8(_mm_loadu_si128((__m128i *)(at - F_Z)), zero);
+            v_sum[1] = _mm_unpackhi_epi8(_mm_loadu_si128((__m128i *)(at - F_Z)), zero);
+            v_sum[0] = _mm_add_epi16(v_sum[0], _mm_unpacklo_epi8(_mm_loadu_si128((__m128i *)(at - F_Y)), zero));
+            v_sum[1] = _mm_add_epi16(v_sum[1], _mm_unpackhi_epi8(_mm_loadu_si128((__m128i *)(at - F_Y)), zero));
+            v_sum[0] = _mm_add_epi16(v_sum[0], _mm_unpacklo_epi8(_mm_loadu_si128((__m128i *)(at + F_X)), zero));
+            v_sum[1] = _mm_add_epi16(v_sum[1], _mm_unpackhi_epi8(_mm_loadu_si128((__m128i *)(at + F_X)), zero));
+            v_sum[0] = _mm_add_epi16(v_sum[0], _mm_unpacklo_epi8(_mm_loadu_si128((__m128i *)(at + F_Y)), zero));
+            v_sum[1] = _mm_add_epi16(v_sum[1], _mm_unpackhi_epi8(_mm_loadu_si128((__m128i *)(at + F_Y)), zero));
+            v_sum[0] = _mm_add_epi16(v_sum[0], _mm_unpacklo_epi8(_mm_loadu_si128((__m128i *)(at + F_Z)), zero));
+            v_sum[1] = _mm_add_epi16(v_sum[1], _mm_unpackhi_epi8(_mm_loadu_si128((__m128i *)(at + F_Z)), zero));
+
+            v_b[0] = _mm_unpacklo_epi8(v_br, zero);
+            v_b[1] = _mm_unpackhi_epi8(v_br, zero);
+            v_o[0] = _mm_unpacklo_epi8(v_obr, zero);
+            v_o[1] = _mm_unpackhi_epi8(v_obr, zero);
+
+            while (half < 2)
+            {
+                __m128i low  = _mm_add_epi32(BRAIN_MUL_LO(v_sum[half], k_a), BRAIN_MUL_LO(v_b[half], k_m));
+                __m128i high = _mm_add_epi32(BRAIN_MUL_HI(v_sum[half], k_a), BRAIN_MUL_HI(v_b[half], k_m));
+                low  = _mm_add_epi32(low, BRAIN_MUL_LO(v_b[half], k_c));
+                high = _mm_add_epi32(high, BRAIN_MUL_HI(v_b[half], k_c));
+                low  = _mm_sub_epi32(low, BRAIN_MUL_LO(v_o[half], k_c));
+                high = _mm_sub_epi32(high, BRAIN_MUL_HI(v_o[half], k_c));
+                _mm_storeu_si128((__m128i *)&partial[offset + (half * 8)], low);
+                _mm_storeu_si128((__m128i *)&partial[offset + (half * 8) + 4], high);
+                half++;
+            }
+
+            _mm_storeu_si128((__m128i *)&obr[loc + offset], v_br);
+            offset += 16;
+        }
+        brain_middle_block(br, loc, l_a, partial);
+        loc += BRAIN_BLOCK;
+    }
+}
+
+#define BRAIN_WIDEN(pointer)  _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *)(pointer)))
+
+__attribute__((target("avx2")))
+static void brain_middle_avx2(n_byte * br, n_byte * obr, n_int l_a, n_int l_b, n_int l_c)
+{
+    int     partial[BRAIN_BLOCK];
+    n_int   loc = F_Z;
+    __m256i k_a = _mm256_set1_epi32((int)l_a);
+    __m256i k_b = _mm256_set1_epi32((int)l_b);
+    __m256i k_c = _mm256_set1_epi32((int)l_c);
+
+    while (loc < B_Z)
+    {
+        n_int  offset = 0;
+        __m256i v_block = _mm256_loadu_si256((__m256i *)&br[loc]);
+        while (offset < BRAIN_BLOCK)
+        {
+            n_byte * at = &br[loc + offset];
+            __m256i  v_sum = BRAIN_WIDEN(at - F_Z);
+            __m256i  v_total;
+            v_sum = _mm256_add_epi32(v_sum, BRAIN_WIDEN(at - F_Y));
+            v_sum = _mm256_add_epi32(v_sum, BRAIN_WIDEN(at + F_X));
+            v_sum = _mm256_add_epi32(v_sum, BRAIN_WIDEN(at + F_Y));
+            v_sum = _mm256_add_epi32(v_sum, BRAIN_WIDEN(at + F_Z));
+
+            v_total = _mm256_mullo_epi32(v_sum, k_a);
+            v_total = _mm256_add_epi32(v_total, _mm256_mullo_epi32(BRAIN_WIDEN(at), k_b));
+            v_total = _mm256_sub_epi32(v_total, _mm256_mullo_epi32(BRAIN_WIDEN(&obr[loc + offset]), k_c));
+
+            _mm256_storeu_si256((__m256i *)&partial[offset], v_total);
+            offset += 8;
+        }
+        _mm256_storeu_si256((__m256i *)&obr[loc], v_block);
+        brain_middle_block(br, loc, l_a, partial);
+        loc += BRAIN_BLOCK;
+    }
+}
+
+/* a vector kernel is only used if it matches the scalar kernel on random brains */
+static n_int brain_middle_check(brain_middle * kernel, n_byte2 * local_random, n_int rounds)
+{
+    n_byte  * scalar = (n_byte *)io_new(DOUBLE_BRAIN * 2);
+    n_byte  * vector = &scalar[DOUBLE_BRAIN];
+    n_int     round = 0, result = 0;
+
+    if (scalar == 0L)
+    {
+        return SHOW_ERROR("Brain kernel check memory not allocated");
+    }
+    while ((round < rounds) && (result == 0))
+    {
+        n_uint  loop = 0;
+        n_int   constants[3];
+        while (loop < DOUBLE_BRAIN)
+        {
+            scalar[loop++] = (n_byte)math_random(local_random);
+        }
+        io_copy(scalar, vector, DOUBLE_BRAIN);
+
+        /* include the extremes of the constants */
+        loop = 0;
+        while (loop < 3)
+        {
+            constants[loop] = (round == 0) ? 65535 : ((round == 1) ? 0 : math_random(local_random));
+            loop++;
+        }
+
+        brain_middle_scalar(scalar, &scalar[B_SIZE], constants[0], constants[1] + constants[2], constants[2]);
+        (kernel)(vector, &vector[B_SIZE], constants[0], constants[1] + constants[2], constants[2]);
+
+        loop = 0;
+        while (loop < DOUBLE_BRAIN)
+        {
+            if (scalar[loop] != vector[loop])
+            {
+                result = -1;
+                break;
+            }
+            loop++;
+        }
+        round++;
+    }
+    io_free(scalar);
+    return result;
+}
+
+#endif
+
+static brain_middle * brain_middle_kernel = 0L;
+static n_int          brain_middle_kind = 0;
+
+/**
+ * Chooses the kernel used for the middle of the brain cycle. This is called
+ * before any threads are cycling brains. A vector kernel that the processor
+ * supports but that does not match the scalar kernel is reported and not used.
+ * @return 2 for AVX2, 1 for SSE2 and 0 for the scalar kernel
+ */
+n_int brain_cycle_init(void)
+{
+    if (brain_middle_kernel != 0L)
+    {
+        return brain_middle_kind;
+    }
+    brain_middle_kernel = &brain_middle_scalar;
+    brain_middle_kind = 0;
+#ifdef BRAIN_VECTOR
+    {
+        n_byte2 local_random[2] = {0x5a17, 0x3e91};
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            if (brain_middle_check(&brain_middle_avx2, local_random, 8) == 0)
+            {
+                brain_middle_kernel = &brain_middle_avx2;
+                brain_middle_kind = 2;
+                return brain_middle_kind;
+            }
+            (void)SHOW_ERROR("AVX2 brain kernel differs from scalar, not used");
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            if (brain_middle_check(&brain_middle_sse2, local_random, 8) == 0)
+            {
+                brain_middle_kernel = &brain_middle_sse2;
+                brain_middle_kind = 1;
+                return brain_middle_kind;
+            }
+            (void)SHOW_ERROR("SSE2 brain kernel differs from scalar, not used");
+        }
+    }
+#endif
+    return brain_middle_kind;
+}
+
+/**
+ * Compares every vector kernel the processor supports with the scalar kernel
+ * on random brains with the extreme and random constants, whichever kernel
+ * brain_cycle_init chose.
+ * @param local_random the random seed for the brain and the constants.
+ * @return the number of vector kernels tested or -1 if any differs.
+ */
+n_int brain_cycle_test(n_byte2 * local_random)
+{
+    n_int tested = 0;
+#ifdef BRAIN_VECTOR
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        if (brain_middle_check(&brain_middle_avx2, local_random, 3) != 0)
+        {
+            return SHOW_ERROR("AVX2 brain kernel differs from scalar");
+        }
+        tested++;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        if (brain_middle_check(&brain_middle_sse2, local_random, 3) != 0)
+        {
+            return SHOW_ERROR("SSE2 brain kernel differs from scalar");
+        }
+        tested++;
+    }
+#endif
+    return tested;
+}
+
+void brain_cycle(n_byte * local, n_byte2 * constants)
+{
+    n_byte  *br = local, *obr = &local[B_SIZE];
+    n_int  l_a = constants[0], l_c = constants[2];
+    n_int  l_b = constants[1] + l_c, loc = 0;
+    n_int  average;
+    n_int  obr_tmp;
+    n_int  br_tmp;
+
+    while (loc < F_Z)
+    {
+        average = (B_P_LH + B_N_UH);
         br_tmp = br[loc];
-        average += br[loc+F_X];
-        average += br[loc+F_Y];
-        average += br[loc+F_Z];
         obr_tmp = obr[loc];
+        obr[loc] = (n_byte)br_tmp;
 
         average *= l_a;
         obr_tmp *= l_c;
-
+        
         br_tmp *= l_b;        
         br_tmp -= obr_tmp;
         average += br_tmp;
-        
+
         br[loc++] = (n_byte)(average>>10);
     }
+
+    if (brain_middle_kernel == 0L)
+    {
+        brain_middle_scalar(br, obr, l_a, l_b, l_c);
+    }
+    else
+    {
+        (brain_middle_kernel)(br, obr, l_a, l_b, l_c);
+    }
+    loc = B_Z;
+
     while (loc < B_SIZE)
     {
         average = B_P_UH;
         br_tmp = br[loc];
         average += B_N_LH;
         obr_tmp = obr[loc];
+        obr[loc] = (n_byte)br_tmp;
 
         average *= l_a;
         obr_tmp *= l_c;
@@ -151,9 +436,62 @@ void brain_cycle(n_byte * local, n_byte2 * constants)
 
         br[loc++] = (n_byte)(average>>10);
     }
+}
 
-    io_copy(frame, obr, B_SIZE);
+/**
+ * Cycles a brain unless it is at rest. The brain cycle only depends on the
+ * brain, the previous brain and the constants. A cycle that leaves both the
+ * same will leave them the same forever after, so the brain can be skipped
+ * until the constants change or brain_wake is called.
+ * @param local the brain.
+ * @param constants the brain constants.
+ * @param rest the rest state of this brain, 0L to always cycle.
+ */
+void brain_cycle_rest(n_byte * local, n_byte2 * constants, noble_brain_rest * rest)
+{
+    if (rest == 0L)
+    {
+        brain_cycle(local, constants);
+        return;
+    }
+    if ((rest->constants[0] != constants[0]) ||
+            (rest->constants[1] != constants[1]) ||
+            (rest->constants[2] != constants[2]))
+    {
+        rest->constants[0] = constants[0];
+        rest->constants[1] = constants[1];
+        rest->constants[2] = constants[2];
+        rest->state = BRAIN_ACTIVE;
+    }
+    if (rest->state == BRAIN_DORMANT)
+    {
+        return;
+    }
+    brain_cycle(local, constants);
+
+    /* the cycle moves the brain into the previous brain */
+    if (io_same(local, &local[B_SIZE], B_SIZE))
+    {
+        /* settled twice running means this cycle changed nothing */
+        rest->state = (rest->state == BRAIN_SETTLING) ? BRAIN_DORMANT : BRAIN_SETTLING;
+    }
+    else
+    {
+        rest->state = BRAIN_ACTIVE;
+    }
+}
 
+/**
+ * Must be called after anything other than the brain cycle writes to a brain.
+ * @param sim the simulation.
+ * @param local the being whose brain was written.
+ */
+void brain_wake(noble_simulation * sim, noble_being * local)
+{
+    if ((sim->brain_rest != 0L) && (local->brain_memory_location != NO_BRAIN_MEMORY_LOCATION))
+    {
+        sim->brain_rest[local->brain_memory_location].state = BRAIN_ACTIVE;
+    }
 }
 
 void brain_hash(n_byte *local_brain, n_byte * local_brain_hash)   /* THIS IS WRONG! FIX!*/
@@ -455,74 +793,74 @@ void brain_sentence(n_string string, n_byte * response)
 
 #ifdef BRAINCODE_ON
 
+/* adds the kinds of braincode instruction of one being to counts, which are
+   data, operators, conditionals, sensors and actuators in that order */
+void braincode_statistics_being(noble_simulation * sim, noble_being * local_being, n_uint * counts)
+{
+    n_int j,k,instruction;
+    for (j=0; j<BRAINCODE_SIZE; j+=BRAINCODE_BYTES_PER_INSTRUCTION)
+    {
+        for (k=0; k<2; k++)
+        {
+            if (k==0)
+            {
+                instruction = GET_BRAINCODE_INTERNAL(sim,local_being)[j] % BRAINCODE_INSTRUCTIONS;
+            }
+            else
+            {
+                instruction = GET_BRAINCODE_EXTERNAL(sim,local_being)[j] % BRAINCODE_INSTRUCTIONS;
+            }
+
+            if (instruction < BRAINCODE_OPERATORS_START)
+            {
+                counts[0]++;
+            }
+            else if (instruction < BRAINCODE_CONDITIONALS_START)
+            {
+                counts[1]++;
+            }
+            else if (instruction < BRAINCODE_SENSORS_START)
+            {
+                counts[2]++;
+            }
+            else if (instruction < BRAINCODE_ACTUATORS_START)
+            {
+                counts[3]++;
+            }
+            else
+            {
+                counts[4]++;
+            }
+        }
+    }
+}
+
 /* gathers statistics on braincode instructions */
 void braincode_statistics(noble_simulation * sim)
 {
-    n_int i,j,k,instruction;
-    noble_being * local_being;
+    n_int i;
     noble_indicators * indicators;
-    n_uint sensors = 0;
-    n_uint actuators = 0;
-    n_uint operators = 0;
-    n_uint conditionals = 0;
-    n_uint data = 0;
+    n_uint counts[5] = {0, 0, 0, 0, 0};
 
     indicators = &(sim->indicators_base[sim->indicator_index]);
 
     for (i=0; i<(n_int)(sim->num); i++)
     {
-        local_being = &(sim->beings[i]);
-        for (j=0; j<BRAINCODE_SIZE; j+=BRAINCODE_BYTES_PER_INSTRUCTION)
-        {
-            for (k=0; k<2; k++)
-            {
-                if (k==0)
-                {
-                    instruction = GET_BRAINCODE_INTERNAL(sim,local_being)[j] % BRAINCODE_INSTRUCTIONS;
-                }
-                else
-                {
-                    instruction = GET_BRAINCODE_EXTERNAL(sim,local_being)[j] % BRAINCODE_INSTRUCTIONS;
-                }
-                
-                if (instruction < BRAINCODE_OPERATORS_START)
-                {
-                    data++;
-                }
-                else if (instruction < BRAINCODE_CONDITIONALS_START)
-                {
-                    operators++;
-                }
-                else if (instruction < BRAINCODE_SENSORS_START)
-                {
-                    conditionals++;
-                }
-                else if (instruction < BRAINCODE_ACTUATORS_START)
-                {
-                    sensors++;
-                }
-                else
-                {
-                    actuators++;
-                }
-            }
-        }
+        braincode_statistics_being(sim, &(sim->beings[i]), counts);
     }
     if (sim->num>0)
     {
-        indicators->average_sensors = (n_byte2)(sensors*10/sim->num);
-        indicators->average_actuators = (n_byte2)(actuators*10/sim->num);
-        indicators->average_operators = (n_byte2)(operators*10/sim->num);
-        indicators->average_conditionals = (n_byte2)(conditionals*10/sim->num);
-        indicators->average_data = (n_byte2)(data*10/sim->num);
+        indicators->average_sensors = (n_byte2)(counts[3]*10/sim->num);
+        indicators->average_actuators = (n_byte2)(counts[4]*10/sim->num);
+        indicators->average_operators = (n_byte2)(counts[1]*10/sim->num);
+        indicators->average_conditionals = (n_byte2)(counts[2]*10/sim->num);
+        indicators->average_data = (n_byte2)(counts[0]*10/sim->num);
     }
 }
 
 /* returns a random braincode instruction of the given type */
-static n_byte get_braincode_instruction_type(n_byte instruction_type)
+static n_byte get_braincode_instruction_type(n_byte instruction_type, n_byte2 * local_random)
 {
-    n_byte2 local_random[2];
-    
     math_random3(local_random);
     switch(instruction_type)
     {
@@ -571,11 +909,11 @@ n_byte get_braincode_instruction(noble_being * local_being)
     {
         if (index>=total)
         {
-            return get_braincode_instruction_type(i);
+            return get_braincode_instruction_type(i, local_being->seed);
         }
     }
 
-    return get_braincode_instruction_type(4);
+    return get_braincode_instruction_type(4, local_being->seed);
 }
 
 static n_int get_actor_index(social_link * social_graph, n_int value)
@@ -922,7 +1260,7 @@ static n_byte brain_third_sense(noble_simulation * sim, noble_being * meeter_bei
         n_byte return_value = 0;
 #ifdef IMMUNE_ON
         n_int n;
-        noble_immune_system * immune = &(important_being->immune_system);
+        noble_immune_system * immune = GET_IM(sim, important_being);
         return_value = immune->antigens[0];
         for (n=1; n<IMMUNE_ANTIGENS; n++)
         {
@@ -969,24 +1307,27 @@ static n_byte brain_third_sense(noble_simulation * sim, noble_being * meeter_bei
 
 /**
  * Returns a byte value indicating how familiar the being is with a place
+ * @param sim Pointer to the simulation
  * @param local_being Pointer to the being
  * @param index an index number corresponding to the place
  * @return A byte value indicating the level of familiarity
  */
-static n_byte territory_familiarity(noble_being * local_being,
+static n_byte territory_familiarity(noble_simulation * sim,
+                                    noble_being * local_being,
                                     n_byte2 index)
 {
     n_byte result=0;
 #ifdef TERRITORY_ON
-    n_uint familiarity = (n_uint)(local_being->territory[index].familiarity);
+    noble_place * territory = GET_T(sim, local_being);
+    n_uint familiarity = (n_uint)(territory[index].familiarity);
     n_uint i,max_familiarity = 1;
 
     /** find the maximum familiarity */
     for (i=0; i<TERRITORY_AREA; i++)
     {
-        if (local_being->territory[i].familiarity > max_familiarity)
+        if (territory[i].familiarity > max_familiarity)
         {
-            max_familiarity = (n_uint)local_being->territory[i].familiarity;
+            max_familiarity = (n_uint)territory[i].familiarity;
         }
     }
 
@@ -1003,6 +1344,141 @@ static n_byte territory_familiarity(noble_being * local_being,
 #define IS_CONST0 (is_constant0 ? value0 : addr0[0])
 #define IS_CONST1 (is_constant1 ? value1 : addr1[0])
 
+/* a braincode address from 0 to BRAINCODE_MAX_ADDRESS-1 within the two beings */
+#define BRAINCODE_POINTER(space, address) (&((space)[(address) / BRAINCODE_SIZE][(address) % BRAINCODE_SIZE]))
+
+/* the instruction for each possible first byte, the same as BRAINCODE_INSTRUCTION */
+static n_byte brain_opcode[256];
+
+/* the operands an instruction can write to, the steps decoded from them are decoded again */
+#define BRAINCODE_WRITES0       (1)
+#define BRAINCODE_WRITES1       (2)
+
+/* in the order of BRAINCODE_COMMANDS, the block move writes more than its operands and is left to itself */
+static const n_byte brain_step_writes[BRAINCODE_INSTRUCTIONS] =
+{
+    0, 0,
+    BRAINCODE_WRITES1, BRAINCODE_WRITES1, BRAINCODE_WRITES1, BRAINCODE_WRITES1, BRAINCODE_WRITES1, 0,
+    BRAINCODE_WRITES1, 0, BRAINCODE_WRITES1, BRAINCODE_WRITES0 | BRAINCODE_WRITES1,
+    BRAINCODE_WRITES0 | BRAINCODE_WRITES1, 0, BRAINCODE_WRITES1,
+    0, 0, BRAINCODE_WRITES0, BRAINCODE_WRITES0, BRAINCODE_WRITES0, 0, 0, 0,
+    BRAINCODE_WRITES1, BRAINCODE_WRITES1, BRAINCODE_WRITES1,
+    BRAINCODE_WRITES0 | BRAINCODE_WRITES1, 0, BRAINCODE_WRITES1, 0
+};
+
+/* the decoded instructions jump straight to their code where the compiler can take the address of a label */
+#ifdef __GNUC__
+#define BRAINCODE_COMPUTED_GOTO
+#endif
+
+#ifdef BRAINCODE_COMPUTED_GOTO
+#define BRAINCODE_CASE(op)      case BRAINCODE_##op: dispatch_##op
+#else
+#define BRAINCODE_CASE(op)      case BRAINCODE_##op
+#endif
+
+/**
+ * Fills the instruction table used by brain_dialogue. This is called before
+ * any threads are running dialogues.
+ */
+void brain_dialogue_init(void)
+{
+    n_byte code[1];
+    n_int  loop = 0;
+    while (loop < 256)
+    {
+        code[0] = (n_byte)loop;
+        brain_opcode[loop++] = (n_byte)BRAINCODE_INSTRUCTION(code, 0);
+    }
+}
+
+/**
+ * The decoded steps of the braincode of a social link.
+ * @param sim Pointer to the simulation
+ * @param braincode The braincode of a social link
+ * @return The steps, 0L if there are none or the braincode is not in the social graphs
+ */
+noble_braincode_steps * brain_braincode_steps(noble_simulation * sim, n_byte * braincode)
+{
+    n_uint link;
+    if ((sim->braincode_steps == 0L) || (braincode < (n_byte *)sim->social_base))
+    {
+        return 0L;
+    }
+    link = (n_uint)(braincode - (n_byte *)sim->social_base) / sizeof(social_link);
+    if (link >= (sim->max * SOCIAL_SIZE))
+    {
+        return 0L;
+    }
+    return &(sim->braincode_steps[link]);
+}
+
+/* each step is decoded from its own byte and the two after it */
+static void brain_steps_changed(noble_braincode_steps * steps, n_int position, n_int bytes)
+{
+    n_int loop = position - (BRAINCODE_BYTES_PER_INSTRUCTION - 1);
+    n_int end = position + bytes;
+    if (steps == 0L)
+    {
+        return;
+    }
+    if (loop < 0)
+    {
+        loop = 0;
+    }
+    if (end > BRAINCODE_SIZE)
+    {
+        end = BRAINCODE_SIZE;
+    }
+    while (loop < end)
+    {
+        steps->decoded[loop >> 5] &= ~((n_c_uint)1 << (loop & 31));
+        loop++;
+    }
+}
+
+/**
+ * Anything that writes to the braincode outside brain_dialogue calls this
+ * so the steps decoded from the bytes it wrote are decoded again.
+ * @param sim Pointer to the simulation
+ * @param braincode The braincode of a social link
+ * @param position The first byte written
+ * @param bytes The number of bytes written
+ */
+void brain_braincode_changed(noble_simulation * sim, n_byte * braincode, n_int position, n_int bytes)
+{
+    brain_steps_changed(brain_braincode_steps(sim, braincode), position, bytes);
+}
+
+/**
+ * Leaves none of the braincode decoded, for when the social graphs are replaced.
+ * @param sim Pointer to the simulation
+ */
+void brain_braincode_reset(noble_simulation * sim)
+{
+    n_uint loop = 0;
+    n_uint links = sim->max * SOCIAL_SIZE;
+    if (sim->braincode_steps == 0L)
+    {
+        return;
+    }
+    while (loop < links)
+    {
+        io_erase((n_byte *)sim->braincode_steps[loop++].decoded, sizeof(sim->braincode_steps[0].decoded));
+    }
+}
+
+static void brain_step_decode(noble_braincode_step * step, n_byte * braincode, n_int i)
+{
+    n_byte code = braincode[i];
+    step->instruction = brain_opcode[code];
+    step->constants = code & (BRAINCODE_CONSTANT0_BIT | BRAINCODE_CONSTANT1_BIT);
+    step->value[0] = BRAINCODE_VALUE(braincode, i, 0);
+    step->value[1] = BRAINCODE_VALUE(braincode, i, 1);
+    step->address[0] = (n_byte)BRAINCODE_ADDRESS(i + step->value[0]);
+    step->address[1] = (n_byte)BRAINCODE_ADDRESS(i + step->value[1]);
+}
+
 void brain_dialogue(
     noble_simulation * sim,
     n_byte awake,
@@ -1028,7 +1504,24 @@ void brain_dialogue(
     social_link * meeter_social_graph = GET_SOC(sim,meeter_being);
     episodic_memory * episodic = GET_EPI(sim,meeter_being);
     n_int max_itterations;
-    n_byte * pspace = (n_byte*)meeter_being->braincode_register;
+    n_byte * pspace = (n_byte*)GET_BR(sim,meeter_being);
+    n_byte * address_space[2];
+    noble_braincode_steps * space_steps[2];
+    noble_braincode_step   live_step;
+#ifdef BRAINCODE_COMPUTED_GOTO
+    /* in the order of BRAINCODE_COMMANDS */
+    static const void * brain_dispatch[BRAINCODE_INSTRUCTIONS] =
+    {
+        &&dispatch_DAT0, &&dispatch_DAT1,
+        &&dispatch_ADD, &&dispatch_SUB, &&dispatch_MUL, &&dispatch_DIV, &&dispatch_MOD, &&dispatch_MVB,
+        &&dispatch_MOV, &&dispatch_JMP, &&dispatch_CTR, &&dispatch_SWP, &&dispatch_INV, &&dispatch_STP,
+        &&dispatch_LTP,
+        &&dispatch_JMZ, &&dispatch_JMN, &&dispatch_DJN, &&dispatch_AND, &&dispatch_OR, &&dispatch_SEQ,
+        &&dispatch_SNE, &&dispatch_SLT,
+        &&dispatch_SEN, &&dispatch_SEN2, &&dispatch_SEN3,
+        &&dispatch_ACT, &&dispatch_ACT2, &&dispatch_ACT3, &&dispatch_ANE
+    };
+#endif
 
     /* what is the current actor index within episodic memory? */
     if (being_index>-1)
@@ -1061,46 +1554,56 @@ void brain_dialogue(
 
     i = 0;
 
+    /* the first half of the address space is this being, the second half the other */
+    address_space[0] = bc0;
+    address_space[1] = bc1;
+    space_steps[0] = brain_braincode_steps(sim, bc0);
+    space_steps[1] = brain_braincode_steps(sim, bc1);
+
     while (itt<max_itterations)
     {
-        n_byte instruction = BRAINCODE_INSTRUCTION(bc0, i);
-        n_byte is_constant0 = BRAINCODE_CONSTANT0(bc0, i);
-        n_byte is_constant1 = BRAINCODE_CONSTANT1(bc0, i);
-        n_byte value0 = BRAINCODE_VALUE(bc0, i, 0);
-        n_byte value1 = BRAINCODE_VALUE(bc0, i, 1);
+        /* the braincode writes to itself so a step is decoded again once its bytes have changed */
+        noble_braincode_step * step = &live_step;
+        n_byte  instruction, is_constant0, is_constant1, value0, value1, address0, address1;
         n_byte *addr0;
         n_byte *addr1;
 
-        if (BRAINCODE_ADDRESS(i+value0) < BRAINCODE_SIZE)
-        {
-            /* address within this being */
-            addr0 = &bc0[BRAINCODE_ADDRESS(i+value0)];
-        }
-        else
-        {
-            /* Address within the other being */
-            addr0 = &bc1[BRAINCODE_ADDRESS(i+value0) - BRAINCODE_SIZE];
-        }
-        if (BRAINCODE_ADDRESS(i+value1) < BRAINCODE_SIZE)
+        if ((space_steps[0] != 0L) && (i <= BRAINCODE_STEPS_CACHED))
         {
-            /* Address within this being */
-            addr1 = &bc0[BRAINCODE_ADDRESS(i+value1)];
+            step = &(space_steps[0]->step[i]);
+            if (BRAINCODE_STEP_DECODED(space_steps[0], i) == 0)
+            {
+                brain_step_decode(step, bc0, i);
+                space_steps[0]->decoded[i >> 5] |= (n_c_uint)1 << (i & 31);
+            }
         }
         else
         {
-            /* Address within the other being */
-            addr1 = &bc1[BRAINCODE_ADDRESS(i+value1) - BRAINCODE_SIZE];
+            brain_step_decode(step, bc0, i);
         }
 
+        instruction = step->instruction;
+        is_constant0 = step->constants & BRAINCODE_CONSTANT0_BIT;
+        is_constant1 = step->constants & BRAINCODE_CONSTANT1_BIT;
+        value0 = step->value[0];
+        value1 = step->value[1];
+        address0 = step->address[0];
+        address1 = step->address[1];
+        addr0 = BRAINCODE_POINTER(address_space, address0);
+        addr1 = BRAINCODE_POINTER(address_space, address1);
+
+#ifdef BRAINCODE_COMPUTED_GOTO
+        goto *brain_dispatch[instruction];
+#endif
         switch(instruction)
         {
             /* General sensor */
-        case BRAINCODE_SEN:
+        BRAINCODE_CASE(SEN):
         {
             addr1[0] = brain_first_sense(sim,meeter_being, met_being, meeter_social_graph, actor_index, addr0[0]);
             break;
         }
-        case BRAINCODE_SEN2:
+        BRAINCODE_CASE(SEN2):
         {
             n_int new_episode_index=-1;
             n_int switcher = addr0[0]%25;
@@ -1188,16 +1691,16 @@ void brain_dialogue(
             case 19:
 #ifdef TERRITORY_ON
                 /* territory name */
-                addr1[0] = meeter_being->territory[territory_index].name;
+                addr1[0] = GET_T(sim,meeter_being)[territory_index].name;
 #endif
                 break;
             case 20:
                 /* territory familiarity */
-                addr1[0] = territory_familiarity(meeter_being,territory_index);
+                addr1[0] = territory_familiarity(sim,meeter_being,territory_index);
                 break;
             case 21:
                 /* territory familiarity */
-                addr1[0] = territory_familiarity(met_being,territory_index);
+                addr1[0] = territory_familiarity(sim,met_being,territory_index);
                 break;
             case 22:
             {
@@ -1292,12 +1795,12 @@ void brain_dialogue(
             }
             break;
         }
-        case BRAINCODE_SEN3:
+        BRAINCODE_CASE(SEN3):
 
             addr1[0] = brain_third_sense(sim,meeter_being, met_being, internal, addr0[0], addr1);
             break;
             /* Action */
-        case BRAINCODE_ACT:
+        BRAINCODE_CASE(ACT):
         {
             switch(addr0[0]%6)
             {
@@ -1395,17 +1898,17 @@ void brain_dialogue(
                 n_int  n = pspace[0] % BRAINCODE_PROBES;
                 n_byte f = 1 + (IS_CONST1 % BRAINCODE_MAX_FREQUENCY);
 
-                if (meeter_being->brainprobe[n].frequency != f)
+                if (GET_BP(sim,meeter_being)[n].frequency != f)
                 {
                     GET_IN(sim).average_brainprobe_activity++;
                 }
-                meeter_being->brainprobe[n].frequency = f;
+                GET_BP(sim,meeter_being)[n].frequency = f;
                 break;
             }
             }
             break;
         }
-        case BRAINCODE_ACT2:
+        BRAINCODE_CASE(ACT2):
         {
             switch(addr0[0]%6)
             {
@@ -1413,11 +1916,11 @@ void brain_dialogue(
             {
                 n_int  n = pspace[0] % BRAINCODE_PROBES;
                 n_byte typ = IS_CONST1 & 1;
-                if (meeter_being->brainprobe[n].type != typ)
+                if (GET_BP(sim,meeter_being)[n].type != typ)
                 {
                     GET_IN(sim).average_brainprobe_activity++;
                 }
-                meeter_being->brainprobe[n].type = typ;
+                GET_BP(sim,meeter_being)[n].type = typ;
                 break;
             }
             case 1: /* brainprobe address */
@@ -1425,11 +1928,11 @@ void brain_dialogue(
                 n_int n = pspace[0] % BRAINCODE_PROBES;
                 n_byte adr = IS_CONST1;
 
-                if (meeter_being->brainprobe[n].address != adr)
+                if (GET_BP(sim,meeter_being)[n].address != adr)
                 {
                     GET_IN(sim).average_brainprobe_activity++;
                 }
-                meeter_being->brainprobe[n].address = adr;
+                GET_BP(sim,meeter_being)[n].address = adr;
                 break;
             }
             case 2: /* shout out */
@@ -1474,12 +1977,12 @@ void brain_dialogue(
             {
                 n_int n = pspace[0] % BRAINCODE_PROBES;
                 n_byte offset = IS_CONST1;
-                if (meeter_being->brainprobe[n].offset != offset)
+                if (GET_BP(sim,meeter_being)[n].offset != offset)
                 {
                     GET_IN(sim).average_brainprobe_activity++;
                 }
 
-                meeter_being->brainprobe[n].offset = offset;
+                GET_BP(sim,meeter_being)[n].offset = offset;
                 break;
             }
             case 5: /* posture */
@@ -1491,7 +1994,7 @@ void brain_dialogue(
             }
             break;
         }
-        case BRAINCODE_ACT3:
+        BRAINCODE_CASE(ACT3):
             switch(addr0[0]%2)
             {
                 /* brainprobe position */
@@ -1500,12 +2003,12 @@ void brain_dialogue(
                 n_int  n = pspace[0] % BRAINCODE_PROBES;
                 n_byte p = IS_CONST1;
 
-                if (meeter_being->brainprobe[n].position != p)
+                if (GET_BP(sim,meeter_being)[n].position != p)
                 {
                     GET_IN(sim).average_brainprobe_activity++;
                 }
 
-                meeter_being->brainprobe[n].position = p;
+                GET_BP(sim,meeter_being)[n].position = p;
                 break;
             }
             /* alter learned preferences */
@@ -1537,7 +2040,7 @@ void brain_dialogue(
             break;
             }
             /* spread anecdote */
-        case BRAINCODE_ANE:
+        BRAINCODE_CASE(ANE):
             if (internal == 0)
             {
                 /* not internal dialogue */
@@ -1553,7 +2056,7 @@ void brain_dialogue(
             break;
                 
             /* Logical and */
-        case BRAINCODE_AND:
+        BRAINCODE_CASE(AND):
             if (is_constant0)
             {
                 addr0[0] &= addr1[0];
@@ -1564,7 +2067,7 @@ void brain_dialogue(
             }
             break;
             /* Logical or */
-        case BRAINCODE_OR:
+        BRAINCODE_CASE(OR):
             if (is_constant0)
             {
                 addr0[0] |= addr1[0];
@@ -1575,7 +2078,7 @@ void brain_dialogue(
             }
             break;
             /* Move a byte, with no particular alignment */
-        case BRAINCODE_MOV:
+        BRAINCODE_CASE(MOV):
             if ((!is_constant0) && (!is_constant1))
             {
                 addr1[0] = addr0[0];
@@ -1586,7 +2089,7 @@ void brain_dialogue(
             }
             break;
             /* Move a block of instructions */
-        case BRAINCODE_MVB:
+        BRAINCODE_CASE(MVB):
         {
             n_int ptr0, ptr1, n, instructions_to_copy, dat = 0;
 
@@ -1608,28 +2111,14 @@ void brain_dialogue(
 				instructions_to_copy = 1 + (pspace[1]%BRAINCODE_BLOCK_COPY);
 				while (dat < instructions_to_copy)
                 {
-                    if (ptr0 < BRAINCODE_SIZE)
-                    {
-                        addr0 = &bc0[ptr0];
-                    }
-                    else
-                    {
-                        addr0 = &bc1[ptr0 - BRAINCODE_SIZE];
-                    }
-
-                    if (ptr1 < BRAINCODE_SIZE)
-                    {
-                        addr1 = &bc0[ptr1];
-                    }
-                    else
-                    {
-                        addr1 = &bc1[ptr1 - BRAINCODE_SIZE];
-                    }
+                    addr0 = BRAINCODE_POINTER(address_space, ptr0);
+                    addr1 = BRAINCODE_POINTER(address_space, ptr1);
 
                     for (n = 0; n < BRAINCODE_BYTES_PER_INSTRUCTION; n++)
                     {
                         addr1[n] = addr0[n];
                     }
+                    brain_steps_changed(space_steps[ptr1 / BRAINCODE_SIZE], ptr1 % BRAINCODE_SIZE, BRAINCODE_BYTES_PER_INSTRUCTION);
                     dat++;
                     ptr0 = BRAINCODE_ADDRESS(ptr0 + BRAINCODE_BYTES_PER_INSTRUCTION);
                     ptr1 = BRAINCODE_ADDRESS(ptr1 + BRAINCODE_BYTES_PER_INSTRUCTION);
@@ -1638,7 +2127,7 @@ void brain_dialogue(
             break;
         }
         /* Add */
-        case BRAINCODE_ADD:
+        BRAINCODE_CASE(ADD):
             if ((!is_constant0) && (!is_constant1))
             {
                 addr1[0] += addr0[0];
@@ -1649,7 +2138,7 @@ void brain_dialogue(
             }
             break;
             /* Subtract */
-        case BRAINCODE_SUB:
+        BRAINCODE_CASE(SUB):
             if ((!is_constant0) && (!is_constant1))
             {
                 addr1[0] -= addr0[0];
@@ -1660,7 +2149,7 @@ void brain_dialogue(
             }
             break;
             /* Multiply */
-        case BRAINCODE_MUL:
+        BRAINCODE_CASE(MUL):
             if ((!is_constant0) && (!is_constant1))
             {
                 addr1[0] *= addr0[0];
@@ -1671,7 +2160,7 @@ void brain_dialogue(
             }
             break;
             /* Divide */
-        case BRAINCODE_DIV:
+        BRAINCODE_CASE(DIV):
             if ((!is_constant0) && (!is_constant1))
             {
                 addr1[0] >>= (addr0[0]%4);
@@ -1682,7 +2171,7 @@ void brain_dialogue(
             }
             break;
             /* Modulus */
-        case BRAINCODE_MOD:
+        BRAINCODE_CASE(MOD):
             if ((!is_constant0) && (!is_constant1))
             {
                 if (addr0[0] != 0)
@@ -1699,7 +2188,7 @@ void brain_dialogue(
             }
             break;
             /* Count up or down */
-        case BRAINCODE_CTR:
+        BRAINCODE_CASE(CTR):
             if (addr0[0] > 127)
             {
                 if (addr1[0] < 255)
@@ -1724,7 +2213,7 @@ void brain_dialogue(
             }
             break;
             /* Goto */
-        case BRAINCODE_JMP:
+        BRAINCODE_CASE(JMP):
         {
             n_int v0 = IS_CONST0;
             n_int v1 = IS_CONST1;
@@ -1742,7 +2231,7 @@ void brain_dialogue(
             break;
         }
         /* Goto if zero */
-        case BRAINCODE_JMZ:
+        BRAINCODE_CASE(JMZ):
         {
             n_int v0 = IS_CONST0;
 
@@ -1764,7 +2253,7 @@ void brain_dialogue(
             break;
         }
         /* Goto if not zero */
-        case BRAINCODE_JMN:
+        BRAINCODE_CASE(JMN):
         {
             n_int v0 = IS_CONST0;
             if (v0 != 0)
@@ -1783,7 +2272,7 @@ void brain_dialogue(
             break;
         }
         /* Goto and decrement if not zero */
-        case BRAINCODE_DJN:
+        BRAINCODE_CASE(DJN):
             if (addr0[0]-1 != 0)
             {
                 addr0[0]--;
@@ -1800,7 +2289,7 @@ void brain_dialogue(
             }
             break;
             /* If two values are equal then skip the next n instructions */
-        case BRAINCODE_SEQ:
+        BRAINCODE_CASE(SEQ):
             if ((!is_constant0) && (!is_constant1))
             {
                 if (addr1[0] == addr0[0])
@@ -1817,7 +2306,7 @@ void brain_dialogue(
             }
             break;
             /* If two values are not equal then skip the next n instructions */
-        case BRAINCODE_SNE:
+        BRAINCODE_CASE(SNE):
             if ((!is_constant0) && (!is_constant1))
             {
                 if (addr1[0] != addr0[0])
@@ -1834,7 +2323,7 @@ void brain_dialogue(
             }
             break;
             /* Skip the next n instructions if less than */
-        case BRAINCODE_SLT:
+        BRAINCODE_CASE(SLT):
             if ((!is_constant0) && (!is_constant1))
             {
                 if (addr1[0] < addr0[0])
@@ -1851,11 +2340,11 @@ void brain_dialogue(
             }
             break;
             /* No operation (data only) */
-        case BRAINCODE_DAT0:
-        case BRAINCODE_DAT1:
+        BRAINCODE_CASE(DAT0):
+        BRAINCODE_CASE(DAT1):
             break;
             /* swap */
-        case BRAINCODE_SWP:
+        BRAINCODE_CASE(SWP):
         {
             n_byte tmp = addr0[0];
             addr0[0] = addr1[0];
@@ -1863,7 +2352,7 @@ void brain_dialogue(
             break;
         }
         /* invert */
-        case BRAINCODE_INV:
+        BRAINCODE_CASE(INV):
             if (is_constant0)
             {
                 addr0[0] = 255 - addr0[0];
@@ -1874,7 +2363,7 @@ void brain_dialogue(
             }
             break;
             /* Save to Pspace */
-        case BRAINCODE_STP:
+        BRAINCODE_CASE(STP):
         {
             n_byte v0 = IS_CONST0;
             n_byte v1 = IS_CONST1;
@@ -1882,7 +2371,7 @@ void brain_dialogue(
             break;
         }
         /* Load from Pspace */
-        case BRAINCODE_LTP:
+        BRAINCODE_CASE(LTP):
         {
             n_byte v0 = IS_CONST0;
             addr1[0] = pspace[v0 % BRAINCODE_PSPACE_REGISTERS];
@@ -1890,6 +2379,16 @@ void brain_dialogue(
         }
 
         }
+
+        if (brain_step_writes[instruction] & BRAINCODE_WRITES0)
+        {
+            brain_steps_changed(space_steps[address0 / BRAINCODE_SIZE], address0 % BRAINCODE_SIZE, 1);
+        }
+        if (brain_step_writes[instruction] & BRAINCODE_WRITES1)
+        {
+            brain_steps_changed(space_steps[address1 / BRAINCODE_SIZE], address1 % BRAINCODE_SIZE, 1);
+        }
+
         i += BRAINCODE_BYTES_PER_INSTRUCTION;
         itt++;
 
@@ -75,14 +75,16 @@ n_int  brain_probe_to_location(n_int position);
 
 void   metabolism_vascular_description(n_int index, n_string description);
 n_string metabolism_description(n_int index);
-n_int  metabolism_vascular_radius(noble_being * local_being, n_int vessel_index);
+n_int  metabolism_vascular_radius(noble_simulation * local_sim, noble_being * local_being, n_int vessel_index);
 
 void   being_name(n_byte female, n_int first, n_byte family0, n_byte family1, n_string name);
 n_int  being_init(noble_simulation * sim, noble_being * mother, n_int random_factor, n_byte first_generation);
 void   being_cycle_awake(noble_simulation * sim, n_uint current_being_index);
+void   being_sense(noble_simulation * sim, n_uint current_being_index);
 void   being_cycle_universal(noble_simulation * sim, noble_being * local, n_byte awake);
 void   being_state_description(n_byte2 state, n_string result);
 n_uint being_affect(noble_simulation * local_sim, noble_being * local, n_byte is_positive);
+void   being_affect_totals(noble_simulation * local_sim, noble_being * local, n_uint * positive, n_uint * negative);
 
 void being_set_select_name(noble_simulation * sim, n_string name);
 n_string being_get_select_name(noble_simulation * sim);
@@ -99,12 +101,18 @@ n_int episodic_first_person_memories_percent(
     noble_simulation * local_sim,
     noble_being * local,
     n_byte intention);
+void episodic_first_person_percents(
+    noble_simulation * local_sim,
+    noble_being * local,
+    n_int * first_person,
+    n_int * intentions);
 
-void being_immune_transmit(noble_being * meeter_being, noble_being * met_being, n_byte transmission_type);
+void being_immune_transmit(noble_simulation * sim, noble_being * meeter_being, noble_being * met_being, n_byte transmission_type);
 void body_genome(n_byte maternal, n_genetics * genome, n_byte * genome_str);
 void being_relationship_description(n_int index, n_string description);
 n_string being_body_inventory_description(n_int index);
 
+void brain_dialogue_init(void);
 void brain_dialogue(
     noble_simulation * sim,
     n_byte awake,
@@ -113,19 +121,34 @@ void brain_dialogue(
     n_byte		* bc0,
     n_byte		* bc1,
     n_int being_index);
+noble_braincode_steps * brain_braincode_steps(noble_simulation * sim, n_byte * braincode);
+void brain_braincode_changed(noble_simulation * sim, n_byte * braincode, n_int position, n_int bytes);
+void brain_braincode_reset(noble_simulation * sim);
 
 void brain_hash(n_byte *local_brain, n_byte * local_brain_hash);
+n_int brain_cycle_init(void);
+n_int brain_cycle_test(n_byte2 * local_random);
 void brain_cycle(n_byte * local, n_byte2 * constants);
+void brain_cycle_rest(n_byte * local, n_byte2 * constants, noble_brain_rest * rest);
+void brain_wake(noble_simulation * sim, noble_being * local);
 noble_being * being_from_name(noble_simulation * sim, n_string name);
 
 void being_tidy(noble_simulation * local_sim);
 void being_remove(noble_simulation * local_sim);
+void being_slots_rebuild(noble_simulation * sim, n_byte identity);
+n_uint being_locations(noble_simulation * sim);
+n_uint being_id(noble_simulation * sim, noble_being * local);
+noble_being * being_from_id(noble_simulation * sim, n_uint id);
+void being_select(noble_simulation * sim, n_uint index);
+noble_being * being_selected(noble_simulation * sim);
+n_uint being_selected_index(noble_simulation * sim);
 
 void brain_three_byte_command(n_string string, n_byte * response);
 
 void brain_sentence(n_string string, n_byte * response);
 
 void braincode_statistics(noble_simulation * sim);
+void braincode_statistics_being(noble_simulation * sim, noble_being * local_being, n_uint * counts);
 
 n_int episode_description(noble_simulation * sim,
                          noble_being * local_being,
@@ -142,6 +165,24 @@ n_byte        being_awake_local(noble_simulation * sim, noble_being * local);
 
 n_byte        being_los(n_land * land, noble_being * local, n_byte2 lx, n_byte2 ly);
 
+n_int         being_index_init(noble_simulation * sim);
+void          being_index_free(noble_simulation * sim);
+void          being_index_rebuild(noble_simulation * sim);
+
+n_int         being_space_init(noble_simulation * sim);
+void          being_space_free(noble_simulation * sim);
+void          being_space_rebuild(noble_simulation * sim);
+
+n_int         food_map_init(noble_simulation * sim);
+void          food_map_free(noble_simulation * sim);
+void          food_map_rebuild(noble_simulation * sim);
+n_int         food_operator(noble_simulation * sim, n_int loc_x, n_int loc_y, n_int number);
+
+void          being_water_init(noble_simulation * sim);
+void          being_water_free(noble_simulation * sim);
+void          being_water_rebuild(noble_simulation * sim);
+n_byte      * being_water_field(noble_simulation * sim, n_byte tide);
+
 void          speak_out(n_string filename, n_string paragraph);
 
 
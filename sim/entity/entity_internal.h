@@ -40,6 +40,12 @@
 
 #define VISUAL_DISTANCE_SQUARED (4000*4000)
 
+/* spatial cells are 1024 apespace units square, a little over a third of the
+   radius of SOCIAL_RANGE, giving a 32 x 32 grid over the apespace */
+#define BEING_SPACE_BITS        (10)
+#define BEING_SPACE_DIMENSION   ((APESPACE_BOUNDS + 1) >> BEING_SPACE_BITS)
+#define BEING_SPACE_CELLS       (BEING_SPACE_DIMENSION * BEING_SPACE_DIMENSION)
+
 #define FULLY_ASLEEP    0
 #define SLIGHTLY_AWAKE  1
 #define FULLY_AWAKE     2
@@ -55,8 +61,7 @@ void body_genome_random(noble_simulation * sim, noble_being * local, n_byte2 * l
 void body_genetics(noble_simulation * sim, noble_being * local, noble_being * mother, n_byte2 * local_random);
 
 n_int food_eat(
-    n_land * local_land,
-    n_weather * local_weather,
+    noble_simulation * sim,
     n_int loc_x,
     n_int loc_y,
     n_int az,
@@ -65,7 +70,7 @@ n_int food_eat(
 
 n_int food_absorption(n_byte food_type, noble_being * local);
 
-void food_values(n_land * local_land, n_weather * local_weather,
+void food_values(noble_simulation * sim,
                  n_int loc_x,
                  n_int loc_y,
                  n_int *grass, n_int *trees, n_int *bush);
@@ -75,10 +80,10 @@ void  genetics_set(n_genetics * genetics_a, n_genetics * n_genetics);
 void  genetics_zero(n_genetics * genetics_a);
 
 
-void metabolism_init(noble_being * local_being);
+void metabolism_init(noble_simulation * local_sim, noble_being * local_being);
 void metabolism_cycle(noble_simulation * local_sim, noble_being * local_being);
 void metabolism_vascular_response(noble_simulation * local_sim, noble_being * local_being, n_int response);
-void metabolism_eat(noble_being * local_being, n_byte food_type);
+void metabolism_eat(noble_simulation * local_sim, noble_being * local_being, n_byte food_type);
 void metabolism_suckle(noble_simulation * sim,noble_being * child, noble_being * mother);
 
 
@@ -158,7 +163,7 @@ void drives_cycle(noble_being * local, n_byte social, n_int awake, noble_simulat
 
 n_byte get_braincode_instruction(noble_being * local_being);
 
-void being_ingest_pathogen(noble_being * local, n_byte food_type);
+void being_ingest_pathogen(noble_simulation * sim, noble_being * local, n_byte food_type);
 
 void watch_speech(void *ptr, n_string beingname, noble_being * local, n_string result);
 
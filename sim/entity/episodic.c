@@ -273,26 +273,31 @@ n_int episodic_met_being_celebrity(
 }
 
 /**
- * This returns the percentage of episodic memories or intentions which are first person.
+ * The percentages of episodic memories which are first person and which are
+ * intentions, from one look through the memories.
  * Some memories originate from the self and others are acquired from others via chatting.
  * @param local_sim pointer to the simulation
  * @param local pointer to the ape
- * @param intention: 0=episodic memories, 1=intentions
- * @return percentage in the range 0-100
+ * @param first_person percentage of memories which are first person, in the range 0-100
+ * @param intentions percentage of memories which are intentions, in the range 0-100
  */
-n_int episodic_first_person_memories_percent(
+void episodic_first_person_percents(
     noble_simulation * local_sim,
     noble_being * local,
-    n_byte intention)
+    n_int * first_person,
+    n_int * intentions)
 {
-    n_int i,hits=0,memories=0;
+    n_int i,hits=0,intention_hits=0,memories=0;
     episodic_memory * local_episodic = GET_EPI(local_sim, local);
     n_byte2 name = GET_NAME_GENDER(local_sim,local);
     n_byte2 family = GET_NAME_FAMILY2(local_sim,local);
 
+    *first_person = 0;
+    *intentions = 0;
+
     if (local_episodic == 0L)
     {
-        return 0;
+        return;
     }
 
     /** examine all memories */
@@ -300,38 +305,51 @@ n_int episodic_first_person_memories_percent(
     {
         if (local_episodic[i].event>0)
         {
-            if (intention!=0)
+            /** ratio of intentions to other memories */
+            if (local_episodic[i].event >= EVENT_INTENTION)
             {
-                /** ratio of intentions to other memories */
-                if (local_episodic[i].event >= EVENT_INTENTION)
-                {
-                    hits++;
-                }
+                intention_hits++;
             }
-            else
+            /** ratio of first person memories to other memories */
+            if ((local_episodic[i].first_name[BEING_MEETER] == name) &&
+                    (local_episodic[i].family_name[BEING_MEETER] == family))
             {
-                /** ratio of first person memories to other memories */
-                if ((local_episodic[i].first_name[BEING_MEETER] == name) &&
-                        (local_episodic[i].family_name[BEING_MEETER] == family))
-                {
-                    hits++;
-                }
+                hits++;
             }
             memories++;
         }
     }
     if (memories>0)
     {
-        return hits*100/memories;
+        *first_person = hits*100/memories;
+        *intentions = intention_hits*100/memories;
     }
     else
     {
-        if (intention!=0)
-        {
-            return 0;
-        }
-        return 100;
+        *first_person = 100;
+    }
+}
+
+/**
+ * This returns the percentage of episodic memories or intentions which are first person.
+ * Some memories originate from the self and others are acquired from others via chatting.
+ * @param local_sim pointer to the simulation
+ * @param local pointer to the ape
+ * @param intention: 0=episodic memories, 1=intentions
+ * @return percentage in the range 0-100
+ */
+n_int episodic_first_person_memories_percent(
+    noble_simulation * local_sim,
+    noble_being * local,
+    n_byte intention)
+{
+    n_int first_person, intentions;
+    episodic_first_person_percents(local_sim, local, &first_person, &intentions);
+    if (intention!=0)
+    {
+        return intentions;
     }
+    return first_person;
 }
 
 /**
@@ -102,41 +102,102 @@ n_int food_absorption(
 }
 
 
-static n_int food_location(n_land * local_land, n_weather * local_weather,
+/**
+ * Allocates the maps of the land terms of the operators
+ * @param sim Pointer to the simulation
+ * @return 0 on success, -1 if the memory could not be allocated
+ */
+n_int food_map_init(noble_simulation * sim)
+{
+    sim->food_map = (n_c_int *)io_new(LAND_OPERATORS * MAP_AREA * sizeof(n_c_int));
+    if (sim->food_map == 0L)
+    {
+        return SHOW_ERROR("Food map not allocated");
+    }
+    return 0;
+}
+
+/**
+ * Frees the maps of the land terms of the operators
+ * @param sim Pointer to the simulation
+ */
+void food_map_free(noble_simulation * sim)
+{
+    io_free((void *)sim->food_map);
+    sim->food_map = 0L;
+}
+
+/**
+ * Remakes the maps of the land terms of the operators. This is needed
+ * whenever the land is made or loaded.
+ * @param sim Pointer to the simulation
+ */
+void food_map_rebuild(noble_simulation * sim)
+{
+    n_int loop = 0;
+    if (sim->food_map == 0L)
+    {
+        return;
+    }
+    while (loop < LAND_OPERATORS)
+    {
+        land_operator_map(sim->land, (n_byte *)&operators[loop], &(sim->food_map[loop * MAP_AREA]));
+        loop++;
+    }
+}
+
+/**
+ * Returns the value of one of the operators at the given location
+ * @param sim Pointer to the simulation
+ * @param loc_x X ape coordinate
+ * @param loc_y Y ape coordinate
+ * @param number The operator, from 0 (area) to LAND_OPERATORS - 1 (eagle)
+ * @return The operator value
+ */
+n_int food_operator(noble_simulation * sim, n_int loc_x, n_int loc_y, n_int number)
+{
+    if (sim->food_map == 0L)
+    {
+        return land_operator_interpolated(sim->land, sim->weather, loc_x, loc_y,
+                                          (n_byte *)&operators[number]);
+    }
+    return land_operator_mapped(sim->land, sim->weather, &(sim->food_map[number * MAP_AREA]),
+                                loc_x, loc_y, (n_byte *)&operators[number]);
+}
+
+static n_int food_location(noble_simulation * sim,
                            n_int loc_x,
                            n_int loc_y,
                            n_int kind)
 {
-    return land_operator_interpolated(local_land, local_weather, loc_x, loc_y,
-                                      (n_byte*)&operators[kind - VARIABLE_BIOLOGY_AREA]);
+    return food_operator(sim, loc_x, loc_y, kind - VARIABLE_BIOLOGY_AREA);
 }
 
 /**
  * Returns the values for grass, trees and bushes at the given location
- * @param local_land Pointer to the land
- * @param local_weather Pointer to the weather
+ * @param sim Pointer to the simulation
  * @param loc_x X ape coordinate on the map
  * @param loc_y Y ape coordinate on the lap
  * @param grass Returned value for grass
  * @param trees Returned value for trees
  * @param bush Returned value for bushes
  */
-void food_values(n_land * local_land, n_weather * local_weather,
+void food_values(noble_simulation * sim,
                  n_int loc_x,
                  n_int loc_y,
                  n_int *grass, n_int *trees, n_int *bush)
 {
     /** grass at this location */
     *grass =
-        food_location(local_land, local_weather, loc_x, loc_y, VARIABLE_BIOLOGY_GRASS)+OFFSET_GRASS;
+        food_location(sim, loc_x, loc_y, VARIABLE_BIOLOGY_GRASS)+OFFSET_GRASS;
 
     /** trees at this location */
     *trees =
-        food_location(local_land, local_weather, loc_x, loc_y, VARIABLE_BIOLOGY_TREE);
+        food_location(sim, loc_x, loc_y, VARIABLE_BIOLOGY_TREE);
 
     /** bushes at this location */
     *bush =
-        food_location(local_land, local_weather, loc_x, loc_y, VARIABLE_BIOLOGY_BUSH)+OFFSET_BUSH;
+        food_location(sim, loc_x, loc_y, VARIABLE_BIOLOGY_BUSH)+OFFSET_BUSH;
 
     *grass += LAND_DITHER(*grass, *trees, *bush);
 }
@@ -151,8 +212,7 @@ void food_values(n_land * local_land, n_weather * local_weather,
  * @return The type of food
  */
 static n_byte food_eat_land(
-    n_land * local_land,
-    n_weather * local_weather,
+    noble_simulation * sim,
     n_int loc_x,
     n_int loc_y,
     n_int * energy)
@@ -160,7 +220,7 @@ static n_byte food_eat_land(
     n_byte food_type = FOOD_VEGETABLE;
     n_int grass, trees, bush;
 
-    food_values(local_land, local_weather,loc_x,loc_y,&grass, &trees, &bush);
+    food_values(sim,loc_x,loc_y,&grass, &trees, &bush);
 
     /** which is the dominant form of vegetation in this area? */
     if ((grass > bush) && (grass > trees))
@@ -191,8 +251,7 @@ static n_byte food_eat_land(
  * @return The type of food
  */
 static n_byte food_intertidal(
-    n_land * local_land,
-    n_weather * local_weather,
+    noble_simulation * sim,
     n_int loc_x,
     n_int loc_y,
     n_int * energy)
@@ -203,17 +262,17 @@ static n_byte food_intertidal(
     /** seaweed at this location */
     seaweed =
         food_location(
-            local_land, local_weather, loc_x, loc_y, VARIABLE_BIOLOGY_SEAWEED);
+            sim, loc_x, loc_y, VARIABLE_BIOLOGY_SEAWEED);
 
     /** rockpools at this location */
     rockpool =
         food_location(
-            local_land, local_weather, loc_x, loc_y, VARIABLE_BIOLOGY_ROCKPOOL);
+            sim, loc_x, loc_y, VARIABLE_BIOLOGY_ROCKPOOL);
 
     /** beach at this location */
     beach =
         food_location(
-            local_land, local_weather, loc_x, loc_y, VARIABLE_BIOLOGY_BEACH);
+            sim, loc_x, loc_y, VARIABLE_BIOLOGY_BEACH);
 
     beach += LAND_DITHER(seaweed, rockpool, beach);
 
@@ -244,8 +303,7 @@ static n_byte food_intertidal(
  * @return Energy obtained from the food
  */
 n_int food_eat(
-    n_land * local_land,
-    n_weather * local_weather,
+    noble_simulation * sim,
     n_int loc_x,
     n_int loc_y,
     n_int az,
@@ -257,19 +315,19 @@ n_int food_eat(
     if (az > TIDE_MAX)
     {
         /** above the high water mark */
-        *food_type = food_eat_land(local_land, local_weather,loc_x,loc_y,&max_energy);
+        *food_type = food_eat_land(sim,loc_x,loc_y,&max_energy);
     }
     else
     {
         /** in the intertidal zone */
-        *food_type = food_intertidal(local_land, local_weather,loc_x,loc_y,&max_energy);
+        *food_type = food_intertidal(sim,loc_x,loc_y,&max_energy);
     }
 
     /** update metabolism */
-    metabolism_eat(local_being,*food_type);
+    metabolism_eat(sim, local_being,*food_type);
 
     /** ingest pathogens from certain foods */
-    being_ingest_pathogen(local_being, *food_type);
+    being_ingest_pathogen(sim, local_being, *food_type);
 
     energy = CONSUME_E(local_being,max_energy,*food_type);
 
@@ -208,16 +208,17 @@ static void metabolism_vascular_compartment(n_uint I, noble_vessel * vessel)
  */
 void metabolism_vascular_response(noble_simulation * local_sim, noble_being * local_being, n_int response)
 {
+    noble_vessel * vessel = GET_V(local_sim, local_being);
     n_uint i;
 
     /** parasympathetic */
     if (response <= 0)
     {
         /** return towards a resting heart beat */
-        n_uint hr_diff = GET_MT(local_being,METABOLISM_HEART_RATE) - HEART_RATE_RESTING;
+        n_uint hr_diff = GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) - HEART_RATE_RESTING;
         n_int mult = response;
         if (mult==0) mult=-1;
-        GET_MT(local_being,METABOLISM_HEART_RATE) += (n_int)(1+(hr_diff>>2))*mult;
+        GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) += (n_int)(1+(hr_diff>>2))*mult;
 
         for (i = 0; i < VASCULAR_SIZE; i++)
         {
@@ -226,23 +227,23 @@ void metabolism_vascular_response(noble_simulation * local_sim, noble_being * lo
                 if (i < VASCULAR_SIZE_CORE)
                 {
                     /** contract core vessels */
-                    if (local_being->vessel[i].constriction > 1) local_being->vessel[i].constriction-=2;
+                    if (vessel[i].constriction > 1) vessel[i].constriction-=2;
                 }
                 else
                 {
                     /** dilate peripheral vessels */
-                    if (local_being->vessel[i].constriction < 254) local_being->vessel[i].constriction+=2;
+                    if (vessel[i].constriction < 254) vessel[i].constriction+=2;
                 }
             }
             else
             {
                 /** if the response is zero then return towards the default vessel radius */
                 n_int v_diff =
-                    (n_int)local_being->vessel[i].constriction -
-                    (n_int)GET_MT(local_being,METABOLISM_THERMOREGULATOR);
+                    (n_int)vessel[i].constriction -
+                    (n_int)GET_MT(local_sim, local_being,METABOLISM_THERMOREGULATOR);
                 if (v_diff > 1) v_diff=1;
                 if (v_diff < -1) v_diff=-1;
-                local_being->vessel[i].constriction -= v_diff;
+                vessel[i].constriction -= v_diff;
             }
         }
         return;
@@ -258,16 +259,16 @@ void metabolism_vascular_response(noble_simulation * local_sim, noble_being * lo
         	with 16 levels possible (which could come from the genome) */
         n_uint hr_target = HEART_RATE_RESTING + ((hr_range*(n_uint)response)>>4);
 
-        if (GET_MT(local_being,METABOLISM_HEART_RATE) < hr_target)
+        if (GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) < hr_target)
         {
             /** increase heart rate towards the target */
-            GET_MT(local_being,METABOLISM_HEART_RATE) += (1+((hr_target - GET_MT(local_being,METABOLISM_HEART_RATE))>>2));
+            GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) += (1+((hr_target - GET_MT(local_sim, local_being,METABOLISM_HEART_RATE))>>2));
         }
-        if (GET_MT(local_being,METABOLISM_HEART_RATE) > hr_target)
+        if (GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) > hr_target)
         {
             /** decrease heart rate towards the target */
-            n_uint hr_diff = GET_MT(local_being,METABOLISM_HEART_RATE) - hr_target;
-            GET_MT(local_being,METABOLISM_HEART_RATE) -= (n_int)(1+(hr_diff>>2));
+            n_uint hr_diff = GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) - hr_target;
+            GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) -= (n_int)(1+(hr_diff>>2));
         }
 
         for (i = 0; i < VASCULAR_SIZE; i++)
@@ -275,12 +276,12 @@ void metabolism_vascular_response(noble_simulation * local_sim, noble_being * lo
             if (i < VASCULAR_SIZE_CORE)
             {
                 /** dilate core vessels */
-                if (local_being->vessel[i].constriction < 254) local_being->vessel[i].constriction+=2;
+                if (vessel[i].constriction < 254) vessel[i].constriction+=2;
             }
             else
             {
                 /** contract peripheral vessels */
-                if (local_being->vessel[i].constriction > 1) local_being->vessel[i].constriction-=2;
+                if (vessel[i].constriction > 1) vessel[i].constriction-=2;
             }
         }
 
@@ -289,15 +290,17 @@ void metabolism_vascular_response(noble_simulation * local_sim, noble_being * lo
 
 /**
  * Returns the radius of a vessel for the given being
+ * @param local_sim Pointer to the simulation
  * @param local_being Pointer to the being
  * @param vessel_index Index number of the vessel
  * @return Radius of the vessel
  */
-n_int metabolism_vascular_radius(noble_being * local_being, n_int vessel_index)
+n_int metabolism_vascular_radius(noble_simulation * local_sim, noble_being * local_being, n_int vessel_index)
 {
-    return ((n_int)local_being->vessel[vessel_index].radius -
-            (((n_int)local_being->vessel[vessel_index].constriction-VASCULAR_CONSTRICTION_ZERO)*
-             (n_int)local_being->vessel[vessel_index].radius/256)) *
+    noble_vessel * vessel = GET_V(local_sim, local_being);
+    return ((n_int)vessel[vessel_index].radius -
+            (((n_int)vessel[vessel_index].constriction-VASCULAR_CONSTRICTION_ZERO)*
+             (n_int)vessel[vessel_index].radius/256)) *
            (n_uint)local_being->height/BEING_MAX_HEIGHT;
 }
 
@@ -367,11 +370,12 @@ static const n_int metabolic_pathway[] =
 
 /**
  * Returns if the given metabolism type is below its maximum capavity
+ * @param local_sim Pointer to the simulation
  * @param local_being Pointer to the being
  * @param index Metabolism type index
  * @return Maximum value
  */
-static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
+static n_int metabolism_below_capacity(noble_simulation * local_sim, noble_being * local_being, n_byte2 index)
 {
     n_byte2 capacity = 1000;
 
@@ -402,37 +406,39 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
         capacity = BREATHING_RATE_MAX;
         break;
     }
-    return (GET_MT(local_being,index)<capacity);
+    return (GET_MT(local_sim, local_being,index)<capacity);
 }
 
 /**
  * Decay a reaction product amount
+ * @param local_sim Pointer to the simulation
  * @param local_being Pointer to the being
  * @param pathway
- */ static void metabolism_decay(noble_being * local_being, n_byte2 pathway)
+ */ static void metabolism_decay(noble_simulation * local_sim, noble_being * local_being, n_byte2 pathway)
 {
-    if (GET_MT(local_being,pathway)>0)
+    if (GET_MT(local_sim, local_being,pathway)>0)
     {
-        GET_MT(local_being,pathway)--;
+        GET_MT(local_sim, local_being,pathway)--;
     }
 }
 
 /**
  * Set a given metabolism state as active or inactive
+ * @param local_sim Pointer to the simulation
  * @param local_being Pointer to the being
  * @param state The bit to be set active or inactive
  * @param active Whether to set the state as active (1) or inactive (0)
- */ static void metabolism_set_state(noble_being * local_being, n_byte2 state, n_byte active)
+ */ static void metabolism_set_state(noble_simulation * local_sim, noble_being * local_being, n_byte2 state, n_byte active)
 {
     if (active!=0)
     {
-        GET_MT(local_being,METABOLISM_STATE) |= state;
+        GET_MT(local_sim, local_being,METABOLISM_STATE) |= state;
     }
     else
     {
-        if (GET_MT(local_being,METABOLISM_STATE) & state)
+        if (GET_MT(local_sim, local_being,METABOLISM_STATE) & state)
         {
-            GET_MT(local_being,METABOLISM_STATE) ^= state;
+            GET_MT(local_sim, local_being,METABOLISM_STATE) ^= state;
         }
     }
 }
@@ -453,14 +459,14 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
                  conception_date + GESTATION_DAYS + CARRYING_DAYS))
         {
             /** activate lactation prior to weaning */
-            metabolism_set_state(local_being,METABOLISM_STATE_LACTATION,1);
+            metabolism_set_state(local_sim, local_being,METABOLISM_STATE_LACTATION,1);
         }
         else
         {
             /** lactation deactivated */
-            metabolism_set_state(local_being,METABOLISM_STATE_LACTATION,0);
+            metabolism_set_state(local_sim, local_being,METABOLISM_STATE_LACTATION,0);
             /** prolactin decays */
-            metabolism_decay(local_being, METABOLISM_PROLACTIN);
+            metabolism_decay(local_sim, local_being, METABOLISM_PROLACTIN);
         }
     }
 }
@@ -472,44 +478,44 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
  */ static void metabolism_hunger(noble_simulation * local_sim, noble_being * local_being)
 {
     /** leptin / ghrelin levels */
-    if (GET_MT(local_being,METABOLISM_LEPTIN) > 10 + (GENE_FRAME(GET_G(local_being))*10))
+    if (GET_MT(local_sim, local_being,METABOLISM_LEPTIN) > 10 + (GENE_FRAME(GET_G(local_being))*10))
     {
         /** disable the hunger flag if leptin is above a threshold */
-        metabolism_set_state(local_being,METABOLISM_STATE_HUNGER,0);
+        metabolism_set_state(local_sim, local_being,METABOLISM_STATE_HUNGER,0);
     }
     else
     {
         /** enable the hunger flag if leptin falls below a threshold */
-        metabolism_set_state(local_being,METABOLISM_STATE_HUNGER,1);
+        metabolism_set_state(local_sim, local_being,METABOLISM_STATE_HUNGER,1);
     }
 
     /** Produce bile if food is available */
-    if (((GET_MT(local_being,METABOLISM_PROTEIN)>0) ||
-            (GET_MT(local_being,METABOLISM_STARCH)>0) ||
-            (GET_MT(local_being,METABOLISM_FAT)>0)) &&
-            metabolism_below_capacity(local_being, METABOLISM_BILE))
+    if (((GET_MT(local_sim, local_being,METABOLISM_PROTEIN)>0) ||
+            (GET_MT(local_sim, local_being,METABOLISM_STARCH)>0) ||
+            (GET_MT(local_sim, local_being,METABOLISM_FAT)>0)) &&
+            metabolism_below_capacity(local_sim, local_being, METABOLISM_BILE))
     {
-        GET_MT(local_being,METABOLISM_BILE) += 8;
+        GET_MT(local_sim, local_being,METABOLISM_BILE) += 8;
     }
     else
     {
         /** decay bile */
-        metabolism_decay(local_being, METABOLISM_BILE);
+        metabolism_decay(local_sim, local_being, METABOLISM_BILE);
     }
 
     /** if glucose fall below a minimum threshold then enable
     	the starve flag which initiates conversion of muscle
     	back to amino acids and then to glucose */
-    if (GET_MT(local_being,METABOLISM_GLUCOSE) <
+    if (GET_MT(local_sim, local_being,METABOLISM_GLUCOSE) <
             GLUCOSE_THRESHOLD_STARVE)
     {
         /** starving */
-        metabolism_set_state(local_being,METABOLISM_STATE_STARVE,1);
+        metabolism_set_state(local_sim, local_being,METABOLISM_STATE_STARVE,1);
     }
     else
     {
         /** no longer starving */
-        metabolism_set_state(local_being,METABOLISM_STATE_STARVE,0);
+        metabolism_set_state(local_sim, local_being,METABOLISM_STATE_STARVE,0);
     }
 }
 
@@ -523,38 +529,38 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
 
     /** if glucose falls below a minimum level then begin
     	converting glycogen and fat */
-    if (GET_MT(local_being,METABOLISM_GLUCOSE) <
+    if (GET_MT(local_sim, local_being,METABOLISM_GLUCOSE) <
             GLUCOSE_THRESHOLD_MIN+(GENE_GLUCOSE_THRESHOLD_MIN(genetics)*10))
     {
-        metabolism_set_state(local_being,METABOLISM_STATE_STORE,0);
-        metabolism_set_state(local_being,METABOLISM_STATE_RETRIEVE,1);
+        metabolism_set_state(local_sim, local_being,METABOLISM_STATE_STORE,0);
+        metabolism_set_state(local_sim, local_being,METABOLISM_STATE_RETRIEVE,1);
     }
     else
     {
         /** If glucose level exceeds a threshold then begin
         	storing it as glycogen (glycogenesis) and fat */
-        if (GET_MT(local_being,METABOLISM_GLUCOSE) >
+        if (GET_MT(local_sim, local_being,METABOLISM_GLUCOSE) >
                 GLUCOSE_THRESHOLD_MAX+(GENE_GLUCOSE_THRESHOLD_MAX(genetics)*10))
         {
-            metabolism_set_state(local_being,METABOLISM_STATE_RETRIEVE,0);
-            metabolism_set_state(local_being,METABOLISM_STATE_STORE,1);
+            metabolism_set_state(local_sim, local_being,METABOLISM_STATE_RETRIEVE,0);
+            metabolism_set_state(local_sim, local_being,METABOLISM_STATE_STORE,1);
         }
         else
         {
-            metabolism_set_state(local_being,METABOLISM_STATE_RETRIEVE,0);
-            metabolism_set_state(local_being,METABOLISM_STATE_STORE,0);
+            metabolism_set_state(local_sim, local_being,METABOLISM_STATE_RETRIEVE,0);
+            metabolism_set_state(local_sim, local_being,METABOLISM_STATE_STORE,0);
         }
 
         /** adrenalin level decays */
-        metabolism_decay(local_being, METABOLISM_ADRENALIN);
+        metabolism_decay(local_sim, local_being, METABOLISM_ADRENALIN);
     }
 
-    if (!(GET_MT(local_being,METABOLISM_STATE)&METABOLISM_STATE_STORE))
+    if (!(GET_MT(local_sim, local_being,METABOLISM_STATE)&METABOLISM_STATE_STORE))
     {
         /** glucogen level decays */
-        metabolism_decay(local_being, METABOLISM_GLUCOGEN);
+        metabolism_decay(local_sim, local_being, METABOLISM_GLUCOGEN);
         /** insulin level decays */
-        metabolism_decay(local_being, METABOLISM_INSULIN);
+        metabolism_decay(local_sim, local_being, METABOLISM_INSULIN);
     }
 }
 
@@ -566,13 +572,13 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
 {
     n_genetics * genetics = GET_G(local_being);
 
-    if (GET_MT(local_being,METABOLISM_UREA)>50+(GENE_BLADDER_CAPACITY(genetics)<<2))
+    if (GET_MT(local_sim, local_being,METABOLISM_UREA)>50+(GENE_BLADDER_CAPACITY(genetics)<<2))
     {
-        GET_MT(local_being,METABOLISM_UREA) = 0;
+        GET_MT(local_sim, local_being,METABOLISM_UREA) = 0;
     }
-    if (GET_MT(local_being,METABOLISM_WASTE)>200+(GENE_WASTE_CAPACITY(genetics)<<6))
+    if (GET_MT(local_sim, local_being,METABOLISM_WASTE)>200+(GENE_WASTE_CAPACITY(genetics)<<6))
     {
-        GET_MT(local_being,METABOLISM_WASTE) = 0;
+        GET_MT(local_sim, local_being,METABOLISM_WASTE) = 0;
     }
 }
 
@@ -598,7 +604,7 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
                                    (METABOLISM_MAX_PRODUCTS*2) +
                                    (METABOLISM_MAX_REACTANTS*2)];
         if ((mstate != METABOLISM_STATE_ANY) &&
-                (!(mstate & GET_MT(local_being,METABOLISM_STATE))))
+                (!(mstate & GET_MT(local_sim, local_being,METABOLISM_STATE))))
         {
             i++;
             continue;
@@ -616,7 +622,7 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
             reactant = metabolic_pathway[index+1+METABOLISM_MAX_PRODUCTS+j];
             if (reactant > 0)
             {
-                if (GET_MT(local_being,reactant) <
+                if (GET_MT(local_sim, local_being,reactant) <
                         metabolic_pathway[index+1+METABOLISM_MAX_PRODUCTS+METABOLISM_MAX_REACTANTS+j])
                 {
                     break;
@@ -632,7 +638,7 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
                 reactant = metabolic_pathway[index+1+METABOLISM_MAX_PRODUCTS+j];
                 if (reactant > 0)
                 {
-                    GET_MT(local_being,reactant) -=
+                    GET_MT(local_sim, local_being,reactant) -=
                         metabolic_pathway[index+1+METABOLISM_MAX_PRODUCTS+METABOLISM_MAX_REACTANTS+j];
                 }
             }
@@ -643,7 +649,7 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
                     metabolic_pathway[index + 1 + METABOLISM_MAX_PRODUCTS + p + (METABOLISM_MAX_REACTANTS*2)];
 
                 if ((product[p] > 0) &&
-                        ((increment<0) || ((increment>0) && metabolism_below_capacity(local_being,product[p]))))
+                        ((increment<0) || ((increment>0) && metabolism_below_capacity(local_sim, local_being,product[p]))))
                 {
 
                     /** for particular reactions alter the number of products
@@ -670,25 +676,25 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
                     if (increment >= 0)
                     {
                         /** increase the value */
-                        GET_MT(local_being,product[p]) += increment;
+                        GET_MT(local_sim, local_being,product[p]) += increment;
                     }
                     else
                     {
                         /** decrease the value */
-                        if (GET_MT(local_being,product[p])>=-increment)
+                        if (GET_MT(local_sim, local_being,product[p])>=-increment)
                         {
-                            GET_MT(local_being,product[p]) += increment;
+                            GET_MT(local_sim, local_being,product[p]) += increment;
                         }
                         else
                         {
-                            GET_MT(local_being,product[p]) = 0;
+                            GET_MT(local_sim, local_being,product[p]) = 0;
                         }
                     }
 
                     /** if food is digested then increment waste */
                     if (metabolic_pathway[index]==ORGAN_STOMACH)
                     {
-                        GET_MT(local_being,METABOLISM_WASTE)++;
+                        GET_MT(local_sim, local_being,METABOLISM_WASTE)++;
                     }
                 }
             }
@@ -719,97 +725,97 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
  */ static void metabolism_respiration(noble_simulation * local_sim, noble_being * local_being, n_uint core_temp)
 {
     n_int pressure;
-    n_uint lung_surface_area = (n_uint)GET_MT(local_being,METABOLISM_LUNG_CAPACITY)*5; /** approximation from a sphere */
+    n_uint lung_surface_area = (n_uint)GET_MT(local_sim, local_being,METABOLISM_LUNG_CAPACITY)*5; /** approximation from a sphere */
 
     pressure = 16384-(weather_pressure(local_sim->weather,
                                        APESPACE_TO_MAPSPACE(local_being->x),
                                        APESPACE_TO_MAPSPACE(local_being->y))>>4);
 
     /** convert breathing rate into oxygen uptake */
-    if (metabolism_below_capacity(local_being, METABOLISM_OXYGEN))
+    if (metabolism_below_capacity(local_sim, local_being, METABOLISM_OXYGEN))
     {
         n_uint gas_pressure = ((((n_uint)pressure)>>4)*(lung_surface_area>>4))>>5;
-        n_uint oxygen_absorbtion = 1 + ((gas_pressure * (GET_MT(local_being,METABOLISM_BREATHING_RATE)>>6))>>4);
+        n_uint oxygen_absorbtion = 1 + ((gas_pressure * (GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE)>>6))>>4);
         /*printf("gas %u %u\n", gas_pressure, oxygen_absorbtion);*/
-        GET_MT(local_being,METABOLISM_OXYGEN) += (n_byte2)oxygen_absorbtion;
+        GET_MT(local_sim, local_being,METABOLISM_OXYGEN) += (n_byte2)oxygen_absorbtion;
     }
 
     /** dump CO2 */
-    if (GET_MT(local_being,METABOLISM_CO2) > 0)
+    if (GET_MT(local_sim, local_being,METABOLISM_CO2) > 0)
     {
         n_uint gas_pressure = ((((n_uint)pressure)>>4)*(lung_surface_area>>4))>>6;
-        n_uint co2_diffusion = 1 + ((gas_pressure * (GET_MT(local_being,METABOLISM_BREATHING_RATE)>>6))>>4);
+        n_uint co2_diffusion = 1 + ((gas_pressure * (GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE)>>6))>>4);
 
-        if (GET_MT(local_being,METABOLISM_CO2)>=(n_byte2)co2_diffusion)
+        if (GET_MT(local_sim, local_being,METABOLISM_CO2)>=(n_byte2)co2_diffusion)
         {
-            GET_MT(local_being,METABOLISM_CO2) -= (n_byte2)co2_diffusion;
+            GET_MT(local_sim, local_being,METABOLISM_CO2) -= (n_byte2)co2_diffusion;
         }
         else
         {
-            GET_MT(local_being,METABOLISM_CO2) = 0;
+            GET_MT(local_sim, local_being,METABOLISM_CO2) = 0;
         }
     }
 
     /** if there is too much co2 then increase breathing rate,
     	for example after running */
-    if (GET_MT(local_being,METABOLISM_CO2) > CO2_PANT)
+    if (GET_MT(local_sim, local_being,METABOLISM_CO2) > CO2_PANT)
     {
         /** breathe more often */
-        if (GET_MT(local_being,METABOLISM_BREATHING_RATE) < BREATHING_RATE_MAX)
+        if (GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE) < BREATHING_RATE_MAX)
         {
-            GET_MT(local_being,METABOLISM_BREATHING_RATE) += 20;
+            GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE) += 20;
         }
 
         /* breathe more deeply */
-        if (metabolism_below_capacity(local_being, METABOLISM_LUNG_CAPACITY))
+        if (metabolism_below_capacity(local_sim, local_being, METABOLISM_LUNG_CAPACITY))
         {
-            GET_MT(local_being,METABOLISM_LUNG_CAPACITY) += 10;
+            GET_MT(local_sim, local_being,METABOLISM_LUNG_CAPACITY) += 10;
         }
     }
 
     if (core_temp>CORE_TEMPERATURE)
     {
         /** increase breathing rate to remove excess heat */
-        if (GET_MT(local_being,METABOLISM_BREATHING_RATE) < BREATHING_RATE_MAX)
+        if (GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE) < BREATHING_RATE_MAX)
         {
-            GET_MT(local_being,METABOLISM_BREATHING_RATE) += 10;
+            GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE) += 10;
         }
 
         /* breathe more deeply */
-        if (metabolism_below_capacity(local_being, METABOLISM_LUNG_CAPACITY))
+        if (metabolism_below_capacity(local_sim, local_being, METABOLISM_LUNG_CAPACITY))
         {
-            GET_MT(local_being,METABOLISM_LUNG_CAPACITY) += 5;
+            GET_MT(local_sim, local_being,METABOLISM_LUNG_CAPACITY) += 5;
         }
     }
     if (core_temp<CORE_TEMPERATURE)
     {
         /** decrease breathing rate to preserve heat */
-        if (GET_MT(local_being,METABOLISM_BREATHING_RATE) > BREATHING_RATE_MIN)
+        if (GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE) > BREATHING_RATE_MIN)
         {
-            GET_MT(local_being,METABOLISM_BREATHING_RATE) -= 10;
+            GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE) -= 10;
         }
 
         /* decrease breathing depth */
-        if (GET_MT(local_being,METABOLISM_LUNG_CAPACITY) >= MIN_LUNG_CAPACITY(local_being))
+        if (GET_MT(local_sim, local_being,METABOLISM_LUNG_CAPACITY) >= MIN_LUNG_CAPACITY(local_being))
         {
-            GET_MT(local_being,METABOLISM_LUNG_CAPACITY) -= 10;
+            GET_MT(local_sim, local_being,METABOLISM_LUNG_CAPACITY) -= 10;
         }
     }
 
     /** prevent ADP level from falling to zero */
-    if (GET_MT(local_being,METABOLISM_ADP)<200)
+    if (GET_MT(local_sim, local_being,METABOLISM_ADP)<200)
     {
-        GET_MT(local_being,METABOLISM_ADP)=200;
+        GET_MT(local_sim, local_being,METABOLISM_ADP)=200;
     }
 
     /** prevent water level from falling to zero */
-    if (GET_MT(local_being,METABOLISM_WATER)<200)
+    if (GET_MT(local_sim, local_being,METABOLISM_WATER)<200)
     {
-        GET_MT(local_being,METABOLISM_WATER)=200;
+        GET_MT(local_sim, local_being,METABOLISM_WATER)=200;
     }
 
     /** cool down */
-    metabolism_decay(local_being, METABOLISM_HEAT);
+    metabolism_decay(local_sim, local_being, METABOLISM_HEAT);
 }
 
 /**
@@ -819,6 +825,7 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
  * @return Core temperature
  */ static n_uint metabolism_thermoregulation(noble_simulation * local_sim, noble_being * local_being)
 {
+    noble_vessel * vessel = GET_V(local_sim, local_being);
     n_uint i,index,conduction,water_conduction=0,core_temp=0,diff;
     n_int local_z;
     n_vect2 slope_vector, location_vector;
@@ -827,12 +834,13 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
                                 APESPACE_TO_MAPSPACE(local_being->x),
                                 APESPACE_TO_MAPSPACE(local_being->y));
 
-    local_being->vessel[0].temperature =
+    vessel[0].temperature =
         (n_uint)(CORE_TEMPERATURE +
-                 (((n_int)GET_MT(local_being,METABOLISM_THERMOREGULATOR)-VASCULAR_CONSTRICTION_ZERO)*10)-
-                 (n_int)(GET_MT(local_being,METABOLISM_BREATHING_RATE)*4));
+                 (((n_int)GET_MT(local_sim, local_being,METABOLISM_THERMOREGULATOR)-VASCULAR_CONSTRICTION_ZERO)*10)-
+                 (n_int)(GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE)*4));
 
     /** greater conductivity in water */
+    vect2_byte2(&location_vector, (n_byte2 *)&GET_X(local_being));
     land_vect2(&slope_vector, &local_z,local_sim->land, &location_vector);
     if (WATER_TEST(local_z,local_sim->land->tide_level))
     {
@@ -848,24 +856,24 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
         n_uint paths = 0;
         for (i = 0; i < VASCULAR_SIZE; i++)
         {
-            if (local_being->vessel[i].parent == index) paths++;
+            if (vessel[i].parent == index) paths++;
         }
         if (paths > 0)
         {
             for (i = 0; i < VASCULAR_SIZE; i++)
             {
-                if (local_being->vessel[i].parent == index)
+                if (vessel[i].parent == index)
                 {
                     /** Adjust temperature */
-                    if (local_being->vessel[index].temperature > local_being->vessel[i].temperature)
+                    if (vessel[index].temperature > vessel[i].temperature)
                     {
-                        diff = local_being->vessel[index].temperature - local_being->vessel[i].temperature;
-                        local_being->vessel[i].temperature += 1 + (diff>>1);
+                        diff = vessel[index].temperature - vessel[i].temperature;
+                        vessel[i].temperature += 1 + (diff>>1);
                     }
                     else
                     {
-                        diff = local_being->vessel[i].temperature - local_being->vessel[index].temperature;
-                        local_being->vessel[i].temperature -= 1 + (diff>>1);
+                        diff = vessel[i].temperature - vessel[index].temperature;
+                        vessel[i].temperature -= 1 + (diff>>1);
                     }
 
                     /** temperature loss from thermal conduction to the environment */
@@ -884,21 +892,21 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
                     {
                         conduction = 2 - water_conduction;
                     }
-                    if (ambient_temperature < local_being->vessel[i].temperature)
+                    if (ambient_temperature < vessel[i].temperature)
                     {
-                        diff = local_being->vessel[i].temperature - ambient_temperature;
-                        local_being->vessel[i].temperature -= 1 + (diff>>conduction);
+                        diff = vessel[i].temperature - ambient_temperature;
+                        vessel[i].temperature -= 1 + (diff>>conduction);
                     }
-                    if (ambient_temperature > local_being->vessel[i].temperature)
+                    if (ambient_temperature > vessel[i].temperature)
                     {
-                        diff = ambient_temperature - local_being->vessel[i].temperature;
-                        local_being->vessel[i].temperature += 1 + (diff>>conduction);
+                        diff = ambient_temperature - vessel[i].temperature;
+                        vessel[i].temperature += 1 + (diff>>conduction);
                     }
                 }
             }
         }
         /** update the core temperature */
-        if (index < VASCULAR_SIZE_CORE) core_temp += local_being->vessel[index].temperature;
+        if (index < VASCULAR_SIZE_CORE) core_temp += vessel[index].temperature;
         index++;
     }
 
@@ -907,12 +915,12 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
     if (core_temp>CORE_TEMPERATURE)
     {
         /** vasodilation */
-        if (GET_MT(local_being,METABOLISM_THERMOREGULATOR)>55) GET_MT(local_being,METABOLISM_THERMOREGULATOR)--;
+        if (GET_MT(local_sim, local_being,METABOLISM_THERMOREGULATOR)>55) GET_MT(local_sim, local_being,METABOLISM_THERMOREGULATOR)--;
     }
     if (core_temp<CORE_TEMPERATURE)
     {
         /** vasoconstriction */
-        if (GET_MT(local_being,METABOLISM_THERMOREGULATOR)<200) GET_MT(local_being,METABOLISM_THERMOREGULATOR)++;
+        if (GET_MT(local_sim, local_being,METABOLISM_THERMOREGULATOR)<200) GET_MT(local_sim, local_being,METABOLISM_THERMOREGULATOR)++;
     }
     return core_temp;
 }
@@ -927,6 +935,7 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
  * @param local_being Pointer to the being
  */ static void metabolism_vascular(noble_simulation * local_sim, noble_being * local_being)
 {
+    noble_vessel * vessel = GET_V(local_sim, local_being);
     n_uint i,area,I,index,radius,length,elasticity;
 
     metabolism_vascular_response(local_sim, local_being, 0);
@@ -935,43 +944,43 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
     for (i = 0; i < VASCULAR_SIZE; i++)
     {
         /** radius taking into account constriction/dilation */
-        radius = (n_uint)metabolism_vascular_radius(local_being, i);
+        radius = (n_uint)metabolism_vascular_radius(local_sim, local_being, i);
 
         /** scale vessel length depending upon height */
-        length = (n_uint)local_being->height*(n_uint)local_being->vessel[i].length/BEING_MAX_HEIGHT;
+        length = (n_uint)local_being->height*(n_uint)vessel[i].length/BEING_MAX_HEIGHT;
 
         /** elasticity taking into account hardening */
         elasticity =
-            local_being->vessel[i].elasticity -
-            local_being->vessel[i].hardening;
+            vessel[i].elasticity -
+            vessel[i].hardening;
 
         /** cross sectional area of the vessel */
         area = 1 + ((3142 * radius * radius) >> 10);
 
         /** resistance to flow */
-        local_being->vessel[i].resistance =
+        vessel[i].resistance =
             8*length*3142*BLOOD_VISCOSITY /
             (area*area);
 
         /** inertia (inductance) */
-        local_being->vessel[i].inertia =
+        vessel[i].inertia =
             9*length*BLOOD_DENSITY /
             (4*area);
 
         /** Vessel compliance (capacitance)
         	How much of the flow can be stored */
-        local_being->vessel[i].compliance =
+        vessel[i].compliance =
             3*length*3142*
             radius*radius*radius /
-            (2000000000*elasticity*(n_uint)local_being->vessel[i].thickness);
+            (2000000000*elasticity*(n_uint)vessel[i].thickness);
     }
 
     /** Convert heart rate to blood flow rate in ml per minute.
     	This is scaled by height to take account of different heart sizes */
-    I = (n_uint)GET_MT(local_being,METABOLISM_HEART_RATE) * 100 *
+    I = (n_uint)GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) * 100 *
         SECONDS_PER_SIMULATION_STEP * (n_uint)local_being->height /
         (1219*BEING_MAX_HEIGHT);
-    metabolism_vascular_compartment(I, &local_being->vessel[0]);
+    metabolism_vascular_compartment(I, &vessel[0]);
 
     index = 0;
     while (index < VASCULAR_SIZE)
@@ -980,22 +989,22 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
         n_uint paths = 0, R = 0;
         for (i = 0; i < VASCULAR_SIZE; i++)
         {
-            if (local_being->vessel[i].parent == index)
+            if (vessel[i].parent == index)
             {
-                R += 1 + local_being->vessel[i].resistance;
+                R += 1 + vessel[i].resistance;
                 paths++;
             }
         }
         /** flow volume */
         if (R > 0)
         {
-            I = local_being->vessel[index].flow_rate;
+            I = vessel[index].flow_rate;
             for (i = 0; i < VASCULAR_SIZE; i++)
             {
-                if (local_being->vessel[i].parent == index)
+                if (vessel[i].parent == index)
                 {
-                    metabolism_vascular_compartment(I*R/(1+local_being->vessel[i].resistance+R),
-                                                    &local_being->vessel[i]);
+                    metabolism_vascular_compartment(I*R/(1+vessel[i].resistance+R),
+                                                    &vessel[i]);
                 }
             }
         }
@@ -1026,9 +1035,11 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
  * Based on "Simulating of Human Cardiovascular System
  * and Blood Vessel Obstruction Using Lumped Method" by
  * Mohammad Reza Mirzaee, Omid Ghasemalizadeh and Bahar Firoozabadi
+ * @param local_sim Pointer to the simulation
  * @param local_being Pointer to the being
- */ void metabolism_init(noble_being * local_being)
+ */ void metabolism_init(noble_simulation * local_sim, noble_being * local_being)
 {
+    noble_vessel * vessel = GET_V(local_sim, local_being);
     n_uint i;
 
     /**
@@ -1073,46 +1084,46 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
 
     for (i=0; i<VASCULAR_SIZE; i++)
     {
-        local_being->vessel[i].length = (n_byte2)vascular_params[i*5];
-        local_being->vessel[i].thickness = (n_byte2)vascular_params[i*5+1];
-        local_being->vessel[i].radius = (n_byte2)vascular_params[i*5+2];
-        local_being->vessel[i].elasticity = (n_byte2)vascular_params[i*5+3];
+        vessel[i].length = (n_byte2)vascular_params[i*5];
+        vessel[i].thickness = (n_byte2)vascular_params[i*5+1];
+        vessel[i].radius = (n_byte2)vascular_params[i*5+2];
+        vessel[i].elasticity = (n_byte2)vascular_params[i*5+3];
         if (vascular_params[i*5+4] > 0)
         {
-            local_being->vessel[i].parent = (n_byte2)vascular_params[i*5+4]-1;
+            vessel[i].parent = (n_byte2)vascular_params[i*5+4]-1;
         }
         else
         {
-            local_being->vessel[i].parent = 0;
+            vessel[i].parent = 0;
         }
-        local_being->vessel[i].volume = 0;
-        local_being->vessel[i].inertia = 0;
-        local_being->vessel[i].pressure = 0;
-        local_being->vessel[i].temperature = CORE_TEMPERATURE;
-        local_being->vessel[i].flow_rate = 0;
-        local_being->vessel[i].constriction = VASCULAR_CONSTRICTION_ZERO;
-        local_being->vessel[i].hardening = 0;
+        vessel[i].volume = 0;
+        vessel[i].inertia = 0;
+        vessel[i].pressure = 0;
+        vessel[i].temperature = CORE_TEMPERATURE;
+        vessel[i].flow_rate = 0;
+        vessel[i].constriction = VASCULAR_CONSTRICTION_ZERO;
+        vessel[i].hardening = 0;
     }
 
     for (i = 0; i < METABOLISM_SIZE; i++)
     {
-        GET_MT(local_being,i)=0;
+        GET_MT(local_sim, local_being,i)=0;
     }
 
     /** Start heartbeat */
-    GET_MT(local_being,METABOLISM_HEART_RATE) = 1219;
-    GET_MT(local_being,METABOLISM_LUNG_CAPACITY) = MIN_LUNG_CAPACITY(local_being);
-    GET_MT(local_being,METABOLISM_THERMOREGULATOR) = VASCULAR_CONSTRICTION_ZERO;
-    GET_MT(local_being,METABOLISM_BREATHING_RATE) = BREATHING_RATE_MIN;
+    GET_MT(local_sim, local_being,METABOLISM_HEART_RATE) = 1219;
+    GET_MT(local_sim, local_being,METABOLISM_LUNG_CAPACITY) = MIN_LUNG_CAPACITY(local_being);
+    GET_MT(local_sim, local_being,METABOLISM_THERMOREGULATOR) = VASCULAR_CONSTRICTION_ZERO;
+    GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE) = BREATHING_RATE_MIN;
 
     /** chemistry */
-    GET_MT(local_being,METABOLISM_HEAT)=1000;
-    GET_MT(local_being,METABOLISM_ENERGY)=1000;
-    GET_MT(local_being,METABOLISM_WATER)=1000;
-    GET_MT(local_being,METABOLISM_PROTEIN)=1000;
-    GET_MT(local_being,METABOLISM_STARCH)=1000;
-    GET_MT(local_being,METABOLISM_FAT)=1000;
-    GET_MT(local_being,METABOLISM_ADP)=1000;
+    GET_MT(local_sim, local_being,METABOLISM_HEAT)=1000;
+    GET_MT(local_sim, local_being,METABOLISM_ENERGY)=1000;
+    GET_MT(local_sim, local_being,METABOLISM_WATER)=1000;
+    GET_MT(local_sim, local_being,METABOLISM_PROTEIN)=1000;
+    GET_MT(local_sim, local_being,METABOLISM_STARCH)=1000;
+    GET_MT(local_sim, local_being,METABOLISM_FAT)=1000;
+    GET_MT(local_sim, local_being,METABOLISM_ADP)=1000;
 }
 
 /**
@@ -1126,18 +1137,19 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
 
     metabolism_vascular_response(sim, mother, VASCULAR_PARASYMPATHETIC);
     metabolism_vascular_response(sim, child, VASCULAR_PARASYMPATHETIC);
-    if (GET_MT(mother,METABOLISM_MILK) >= suckling_rate)
+    if (GET_MT(sim, mother,METABOLISM_MILK) >= suckling_rate)
     {
-        GET_MT(mother,METABOLISM_MILK) -= suckling_rate;
-        GET_MT(child,METABOLISM_MILK) += suckling_rate;
+        GET_MT(sim, mother,METABOLISM_MILK) -= suckling_rate;
+        GET_MT(sim, child,METABOLISM_MILK) += suckling_rate;
     }
 }
 
 /**
  * Ingest various food types
+ * @param local_sim Pointer to the simulation
  * @param local_being Pointer to the being
  * @param food_type Type of food being eaten
- */ void metabolism_eat(noble_being * local_being,
+ */ void metabolism_eat(noble_simulation * local_sim, noble_being * local_being,
                         n_byte food_type)
 {
     n_int i;
@@ -1176,9 +1188,9 @@ static n_int metabolism_below_capacity(noble_being * local_being, n_byte2 index)
 
     for (i=0; i<5; i++)
     {
-        if (GET_MT(local_being,i) < metabolism_below_capacity(local_being, i))
+        if (GET_MT(local_sim, local_being,i) < metabolism_below_capacity(local_sim, local_being, i))
         {
-            GET_MT(local_being,i) += qty[i];
+            GET_MT(local_sim, local_being,i) += qty[i];
         }
     }
 }
@@ -493,7 +493,7 @@ static n_int social_meet(
 
     if (!graph) return -1;
 
-    being_immune_transmit(meeter_being, met_being, PATHOGEN_TRANSMISSION_AIR);
+    being_immune_transmit(sim, meeter_being, met_being, PATHOGEN_TRANSMISSION_AIR);
 
     /** get the social graph index which will be used to represent this relation */
     index = get_social_link(meeter_being,met_being,sim);
@@ -766,8 +766,8 @@ n_byte social_groom(
                 GROOMING_PROB + (gpref*(1+familiarity)*GROOMING_PROB_HONOR*(1+met_being->honor)))
         {
             /** transmit pathogens via touch */
-            being_immune_transmit(meeter_being, met_being, PATHOGEN_TRANSMISSION_TOUCH);
-            being_immune_transmit(met_being, meeter_being, PATHOGEN_TRANSMISSION_TOUCH);
+            being_immune_transmit(sim, meeter_being, met_being, PATHOGEN_TRANSMISSION_TOUCH);
+            being_immune_transmit(sim, met_being, meeter_being, PATHOGEN_TRANSMISSION_TOUCH);
 
             /** pick a body location to groom */
             groomloc = GET_A(meeter_being,ATTENTION_BODY);
@@ -1118,8 +1118,8 @@ n_int social_mate(
                 if (distance < MATING_RANGE)
                 {
                     /** transmit pathogens */
-                    being_immune_transmit(meeter_being, met_being, PATHOGEN_TRANSMISSION_SEX);
-                    being_immune_transmit(met_being, meeter_being, PATHOGEN_TRANSMISSION_SEX);
+                    being_immune_transmit(sim, meeter_being, met_being, PATHOGEN_TRANSMISSION_SEX);
+                    being_immune_transmit(sim, met_being, meeter_being, PATHOGEN_TRANSMISSION_SEX);
                     /** check opposite sexes */
                     if ((FIND_SEX(GET_I(meeter_being)) == SEX_FEMALE) &&
                             (FIND_SEX(GET_I(met_being)) != SEX_FEMALE))
@@ -1171,20 +1171,24 @@ n_int social_mate(
  * @param being_index Array index for the met individual within the social graph of the meeter
  * @param meeter_graph Pointer to the social graph of the meeter
  * @param respect_mean Average friend of foe value within the social graph
+ * @param sim Pointer to the simulation
  */
 static void social_chat_territory(
     noble_being * meeter_being,
     noble_being * met_being,
     n_int being_index,
     social_link * meeter_graph,
-    n_uint respect_mean)
+    n_uint respect_mean,
+    noble_simulation * sim)
 {
 #ifdef TERRITORY_ON
+    noble_place * meeter_territory = GET_T(sim, meeter_being);
+    noble_place * met_territory = GET_T(sim, met_being);
     n_int idx=0,idx2,i=0,x,y;
 
     idx = APESPACE_TO_TERRITORY(meeter_being->y)*TERRITORY_DIMENSION +
           APESPACE_TO_TERRITORY(meeter_being->x);
-    if (meeter_being->territory[idx].name==0)
+    if (meeter_territory[idx].name==0)
     {
         i=0;
         for (y=-1; y<=1; y++)
@@ -1196,7 +1200,7 @@ static void social_chat_territory(
                     idx2 = idx + (y*TERRITORY_DIMENSION+x);
                     if (idx2<0) idx2+=TERRITORY_AREA;
                     if (idx2>=TERRITORY_AREA) idx2-=TERRITORY_AREA;
-                    i = meeter_being->territory[idx2].name;
+                    i = meeter_territory[idx2].name;
                     if (i>0)
                     {
                         y = 2;
@@ -1210,7 +1214,7 @@ static void social_chat_territory(
         {
             i = 1 + (n_byte)math_random(meeter_being->seed);
         }
-        meeter_being->territory[idx].name = (n_byte)i;
+        meeter_territory[idx].name = (n_byte)i;
     }
 
     /** take advice from more honorable friends */
@@ -1218,19 +1222,19 @@ static void social_chat_territory(
     {
         if (met_being->honor > meeter_being->honor)
         {
-            if (met_being->territory[idx].name > 0)
+            if (met_territory[idx].name > 0)
             {
-                meeter_being->territory[idx].name =
-                    met_being->territory[idx].name;
+                meeter_territory[idx].name =
+                    met_territory[idx].name;
             }
         }
         else
         {
             if ((met_being->honor < meeter_being->honor) &&
-                    (meeter_being->territory[idx].name > 0))
+                    (meeter_territory[idx].name > 0))
             {
-                met_being->territory[idx].name =
-                    meeter_being->territory[idx].name;
+                met_territory[idx].name =
+                    meeter_territory[idx].name;
             }
         }
     }
@@ -1278,7 +1282,7 @@ n_int social_chat(
     GET_IN(sim).average_chat++;
 
     /** agree upon terrirory */
-    social_chat_territory(meeter_being,met_being,being_index,meeter_graph,respect_mean);
+    social_chat_territory(meeter_being,met_being,being_index,meeter_graph,respect_mean,sim);
 
 #ifdef PARASITES_ON
     /** do I respect their views ? */
@@ -1375,6 +1379,9 @@ n_int social_chat(
                         link0 = (unsigned char*)&meeter_graph[replace];
                         link1 = (unsigned char*)&met_graph[idx];
                         io_copy(link1,link0, sizeof(social_link));
+#ifdef BRAINCODE_ON
+                        brain_braincode_changed(sim, meeter_graph[replace].braincode, 0, BRAINCODE_SIZE);
+#endif
                         meeter_graph[replace].attraction = 0;
                         speaking |= BEING_STATE_SPEAKING;
 
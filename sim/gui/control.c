@@ -178,12 +178,12 @@ void control_mouse(n_byte wwind, n_int px, n_int py, n_byte option)
         return;
     }
 
-    if (local_sim->select == NO_BEINGS_FOUND)
+    local = being_selected(local_sim);
+    if (local == 0L)
     {
         return;
     }
 
-    local = &(local_sim->beings[local_sim->select]);
     if (wwind == NUM_VIEW)
     {
         if (option)
@@ -193,7 +193,8 @@ void control_mouse(n_byte wwind, n_int px, n_int py, n_byte option)
         }
         else
         {
-            n_uint	desired_ape = local_sim->select;
+            n_uint	selected_ape = being_selected_index(local_sim);
+            n_uint	desired_ape = selected_ape;
             n_uint high_squ = 31;
             n_uint	loop = 0;
 
@@ -210,7 +211,7 @@ void control_mouse(n_byte wwind, n_int px, n_int py, n_byte option)
                 }
                 loop++;
             }
-            if (local_sim->select != desired_ape)
+            if (selected_ape != desired_ape)
             {
                 sim_set_select(desired_ape);
             }
@@ -253,13 +254,12 @@ void control_key(n_byte wwind, n_byte2 num)
     if (local_sim == 0L)
         return;
 
-    if (local_sim->select == NO_BEINGS_FOUND)
+    local = being_selected(local_sim);
+    if (local == 0L)
     {
         return;
     }
 
-    local = &(local_sim->beings[local_sim->select]);
-
     if ((num > 27) && (num < 32))
     {
         if (wwind != NUM_VIEW)
@@ -280,7 +280,7 @@ void control_key(n_byte wwind, n_byte2 num)
     }
     if ((num > 2077) && (num < 2080))
     {
-        n_uint local_select = local_sim->select;
+        n_uint local_select = being_selected_index(local_sim);
         n_uint local_number = local_sim->num;
 
         if (num == 2078)
@@ -176,6 +176,7 @@ static n_int toggle_weather = 1;
 static n_int toggle_brain = 1;
 static n_int toggle_braincode = 0;
 static n_int toggle_territory = 0;
+static n_int toggle_water = 0;
 
 n_int draw_toggle_weather(void)
 {
@@ -201,6 +202,12 @@ n_int draw_toggle_territory(void)
     return toggle_territory;
 }
 
+n_int draw_toggle_water(void)
+{
+    toggle_water ^= 1;
+    return toggle_water;
+}
+
 /*NOBLEMAKE END=""*/
 
 /*
@@ -631,7 +638,7 @@ static void draw_terrain(noble_simulation * local_sim, n_int dim_x, n_int dim_y)
         return;
     }
     
-    if (local_sim->select == NO_BEINGS_FOUND)
+    if (being_selected(local_sim) == 0L)
     {
         io_erase(buf_offscr, dim_area);
         return;
@@ -639,7 +646,7 @@ static void draw_terrain(noble_simulation * local_sim, n_int dim_x, n_int dim_y)
     {
         n_int       lowest_y = ((dim_y + 256) * dim_y)/256;
         n_byte      * combined = local_sim->highres;
-        noble_being * loc_being = &(local_sim->beings[local_sim->select]);
+        noble_being * loc_being = being_selected(local_sim);
         n_int turn = GET_F(loc_being);
         n_int co_x = APESPACE_TO_HR_MAPSPACE(GET_X(loc_being));
         n_int co_y = APESPACE_TO_HR_MAPSPACE(GET_Y(loc_being));
@@ -738,7 +745,7 @@ static void draw_terrain(noble_simulation * local_sim, n_int dim_x, n_int dim_y)
 static void	draw_meters(noble_simulation * local_sim)
 {
     n_land  * loc_land  =   local_sim->land;
-    noble_being * loc_being = &(local_sim->beings[local_sim->select]);
+    noble_being * loc_being = being_selected(local_sim);
     n_pixel 	* local_draw = &pixel_overlay;
     n_byte		* local_info = draw_pointer(NUM_TERRAIN);
     n_byte 		* local_icon;
@@ -785,7 +792,7 @@ static void	draw_meters(noble_simulation * local_sim)
 
 #define GENDER_X        (terrain_dim_x-(512-312))
 
-    if (local_sim->select != NO_BEINGS_FOUND)
+    if (loc_being != 0L)
     {
         pntx = 0;
         while (pntx < 41)
@@ -982,7 +989,7 @@ static void draw_apeloc(noble_simulation * sim, n_uint reference, n_join * draw)
         }
         ty++;
     }
-    if(reference == sim->select)
+    if(reference == being_selected_index(sim))
     {
         ty = -1;
         while (ty < 2)
@@ -1064,7 +1071,7 @@ static void draw_apeloc_hires(noble_simulation * sim, n_uint reference, n_join *
         }
         ty++;
     }
-    if(reference == sim->select)
+    if(reference == being_selected_index(sim))
     {
         ty = -1;
         while (ty < 2)
@@ -1114,13 +1121,13 @@ static void draw_apeloc_hires(noble_simulation * sim, n_uint reference, n_join *
     }
 }
 
-static void draw_region(noble_being * local)
+static void draw_region(noble_simulation * local_sim, noble_being * local)
 {
     n_join	local_draw;
     n_byte * draw = draw_pointer(NUM_VIEW);
     n_int    ly = 0;
     
-    if (draw == 0L) return;
+    if ((draw == 0L) || (local == 0L)) return;
     
     local_draw.information = draw;
     local_draw.pixel_draw  = &pixel_map;
@@ -1143,7 +1150,7 @@ static void draw_region(noble_being * local)
         while (lx < TERRITORY_DIMENSION)
         {
             n_string_block string_draw;
-            n_int   value = local->territory[lx + (ly * TERRITORY_DIMENSION)].familiarity;
+            n_int   value = GET_T(local_sim, local)[lx + (ly * TERRITORY_DIMENSION)].familiarity;
             if (value)
             {
                 sprintf(string_draw,"%ld",value);
@@ -1155,6 +1162,40 @@ static void draw_region(noble_being * local)
     }
 }
 
+/* the contours of the water field, drawn only once the beings have made the field for the tide */
+#define WATER_CONTOUR   (8)
+
+static void draw_water(noble_simulation * local_sim)
+{
+    n_byte * draw = draw_pointer(NUM_VIEW);
+    n_int    level = local_sim->land->tide_level - TIDE_MIN;
+    n_byte * field;
+    n_uint   loop = 0;
+
+    if ((draw == 0L) || (level < 0) || (level >= LAND_TIDE_LEVELS))
+    {
+        return;
+    }
+    field = local_sim->water_field[level];
+    if (field == 0L)
+    {
+        return;
+    }
+    while (loop < MAP_AREA)
+    {
+        n_int   distance = field[loop << 1] - LAND_WATER_EDGE;
+        if ((distance == 1) || (distance == -1))
+        {
+            draw[loop] = COLOUR_RED_DARK;
+        }
+        else if ((distance % WATER_CONTOUR) == 0)
+        {
+            draw[loop] = COLOUR_YELLOW;
+        }
+        loop++;
+    }
+}
+
 static void draw_weather(noble_simulation * local_sim)
 {
     n_weather *wea = local_sim->weather;
@@ -1224,13 +1265,13 @@ static void draw_brain_cyles_per_second(n_uint count, n_join * local_mono)
 static void draw_brain(noble_simulation *local_sim, n_int dim_x, n_int dim_y)
 {
     n_byte  draw_big = 1;
-    if ((local_sim->select == NO_BEINGS_FOUND) || (number_errors != 0))
+    if ((being_selected(local_sim) == 0L) || (number_errors != 0))
     {
         return;
     }
 
     {
-        noble_being * local_being = &(local_sim->beings[local_sim->select]);
+        noble_being * local_being = being_selected(local_sim);
         n_byte      * local       = GET_B(local_sim, local_being);
         n_join	      local_mono;
         n_uint        turn_y = tilt_z;
@@ -1488,14 +1529,19 @@ static void draw_apes(noble_simulation * local_sim, n_byte lores)
     else
     {
         draw_tides(local_sim->land->map, local_col.screen, local_sim->land->tide_level);
+        if (toggle_water)
+        {
+            draw_water(local_sim);
+        }
         if (toggle_territory)
         {
-            draw_region(&(local_sim->beings[local_sim->select]));
+            draw_region(local_sim, being_selected(local_sim));
         }
     }
 
-    if (local_sim->select != NO_BEINGS_FOUND)
+    if (being_selected(local_sim) != 0L)
     {
+        noble_being *	selected = being_selected(local_sim);
         n_join			local_8bit;
         n_uint			loop = 0;
 
@@ -1512,7 +1558,7 @@ static void draw_apes(noble_simulation * local_sim, n_byte lores)
         while (loop < local_sim->num)
         {
             noble_being *bei = &(local_sim->beings[loop]);
-            if (being_los(local_sim->land, &(local_sim->beings[local_sim->select]), GET_X(bei), GET_Y(bei)) == 1)
+            if (being_los(local_sim->land, selected, GET_X(bei), GET_Y(bei)) == 1)
             {
                 local_col.color = COLOUR_RED;
             }
@@ -95,6 +95,8 @@ n_int draw_toggle_braincode(void);
 
 n_int draw_toggle_territory(void);
 
+n_int draw_toggle_water(void);
+
 n_int control_toggle_pause(n_byte actual_toggle);
 
 void control_about(n_string value);
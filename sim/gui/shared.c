@@ -175,6 +175,11 @@ void shared_notTerritory(void)
     (void)draw_toggle_territory();
 }
 
+void shared_notWater(void)
+{
+    (void)draw_toggle_water();
+}
+
 void shared_flood(void)
 {
     sim_flood();
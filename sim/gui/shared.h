@@ -57,6 +57,7 @@ void shared_notWeather(void);
 void shared_notBrain(void);
 void shared_notBrainCode(void);
 void shared_notTerritory(void);
+void shared_notWater(void);
 
 void shared_flood(void);
 void shared_healthy_carrier(void);
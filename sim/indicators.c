@@ -0,0 +1,185 @@
+/****************************************************************
+
+	indicators.c
+
+	=============================================================
+
+    Copyright 1996-2013 Tom Barbalet. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or
+	sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    This software and Noble Ape are a continuing work of Tom Barbalet,
+    begun on 13 June 1996. No apes or cats were harmed in the writing
+    of this software.
+
+****************************************************************/
+
+/*
+    Converts a binary indicator log back into the CSV the simulation writes
+    when logging indicators as CSV.
+
+    naindicators indicators1.bin [indicators1.csv]
+
+    Without an output file the CSV goes to the standard output. The log must
+    come from a machine with the same byte order.
+*/
+
+#define CONSOLE_ONLY
+#define CONSOLE_REQUIRED
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "noble/noble.h"
+#include "universe/universe.h"
+#include "entity/entity.h"
+
+n_int draw_error(n_string error_text)
+{
+    fprintf(stderr, "ERROR: %s\n", (const n_string) error_text);
+    return -1;
+}
+
+static n_int indicators_convert(FILE * input, FILE * output)
+{
+    n_byte     signature[8];
+    n_c_uint   header[2];
+    n_c_uint   rows;
+    n_c_uint * values;
+    n_byte   * names;
+
+    if ((fread(signature, 1, 8, input) != 8) ||
+            (io_same(signature, (n_byte *)INDICATORS_LOG_SIGNATURE, 8) == 0))
+    {
+        return SHOW_ERROR("Not a binary indicator log");
+    }
+    if ((fread(header, sizeof(n_c_uint), 2, input) != 2) || (header[0] == 0))
+    {
+        return SHOW_ERROR("Indicator log header incomplete");
+    }
+    names = (n_byte *)io_new(header[1]);
+    if (names == 0L)
+    {
+        return SHOW_ERROR("No memory for the column names");
+    }
+    if (fread(names, 1, header[1], input) != header[1])
+    {
+        io_free(names);
+        return SHOW_ERROR("Indicator log header incomplete");
+    }
+    (void)fwrite(names, 1, header[1], output);
+    io_free(names);
+
+    values = (n_c_uint *)io_new(sizeof(n_c_uint) * header[0] * INDICATORS_LOG_ROWS);
+    if (values == 0L)
+    {
+        return SHOW_ERROR("No memory for the indicator values");
+    }
+    while (fread(&rows, sizeof(n_c_uint), 1, input) == 1)
+    {
+        n_c_uint   row = 0;
+        n_c_uint   column = 0;
+        if ((rows == 0) || (rows > INDICATORS_LOG_ROWS))
+        {
+            io_free(values);
+            return SHOW_ERROR("Indicator log block incomplete");
+        }
+        while (column < header[0])
+        {
+            n_c_uint * column_values = &values[column * rows];
+            n_byte     width = 0;
+            if ((fread(&width, 1, 1, input) != 1) ||
+                    ((width != 1) && (width != 2) && (width != 4)) ||
+                    (fread(column_values, width, rows, input) != rows))
+            {
+                io_free(values);
+                return SHOW_ERROR("Indicator log block incomplete");
+            }
+            /* widen in place from the end so nothing is overwritten before it is read */
+            row = rows;
+            while (row > 0)
+            {
+                row--;
+                if (width == 1)
+                {
+                    column_values[row] = ((n_byte *)column_values)[row];
+                }
+                if (width == 2)
+                {
+                    column_values[row] = ((n_byte2 *)column_values)[row];
+                }
+            }
+            column++;
+        }
+        row = 0;
+        while (row < rows)
+        {
+            column = 0;
+            while (column < header[0])
+            {
+                fprintf(output, "%u%c", (unsigned int)values[(column * rows) + row],
+                        ((column + 1) == header[0]) ? '\n' : ',');
+                column++;
+            }
+            row++;
+        }
+    }
+    io_free(values);
+    return 0;
+}
+
+int main(int argc, n_string argv[])
+{
+    FILE * input;
+    FILE * output = stdout;
+    n_int  result;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "usage: naindicators indicators.bin [indicators.csv]\n");
+        return 1;
+    }
+    input = fopen(argv[1], "rb");
+    if (input == NULL)
+    {
+        fprintf(stderr, "naindicators: can not open %s\n", argv[1]);
+        return 1;
+    }
+    if (argc == 3)
+    {
+        output = fopen(argv[2], "w");
+        if (output == NULL)
+        {
+            fprintf(stderr, "naindicators: can not write %s\n", argv[2]);
+            fclose(input);
+            return 1;
+        }
+    }
+    result = indicators_convert(input, output);
+    fclose(input);
+    if (output != stdout)
+    {
+        fclose(output);
+    }
+    return (result == 0) ? 0 : 1;
+}
@@ -51,6 +51,7 @@ gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/noble/math.c -o math.o
 gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/noble/parse.c -o parse.o
 gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/noble/interpret.c -o interpret.o
 gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/noble/land.c -o land.o
+gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/noble/audio.c -o audio.o
 
 gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/entity/being.c -o being.o
 gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/entity/body.c -o body.o
@@ -87,6 +88,24 @@ else
 
 gcc ${CFLAGS} ${COMMANDLINEE} -I/usr/include -o $SOURCEDIR/../nalongterm *.o -lz -lm -lpthread
 
+rm longterm.o
+
+gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/benchmark.c -o benchmark.o
+
+gcc ${CFLAGS} ${COMMANDLINEE} -I/usr/include -o $SOURCEDIR/../nabenchmark *.o -lz -lm -lpthread
+
+rm benchmark.o
+
+gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/indicators.c -o indicators.o
+
+gcc ${CFLAGS} ${COMMANDLINEE} -I/usr/include -o $SOURCEDIR/../naindicators *.o -lz -lm -lpthread
+
+rm indicators.o
+
+gcc ${CFLAGS} ${COMMANDLINEE} -c $SOURCEDIR/telemetry.c -o telemetry.o
+
+gcc ${CFLAGS} ${COMMANDLINEE} -I/usr/include -o $SOURCEDIR/../natelemetry *.o -lz -lm -lpthread
+
 rm *.o
 
 fi
@@ -182,30 +182,30 @@ static void audit_print_offset(n_byte * start, n_byte * point, char * text)
 
 static void audit_compart_offset()
 {
-    noble_being local;
+    noble_being_file local; /* the layout the file offsets follow */
     n_byte * start = (n_byte *)&local;
-    audit_print_offset(start,(n_byte *)&(local.state),"state");
-    audit_print_offset(start,(n_byte *)&(local.crowding),"crowding");
-    audit_print_offset(start,(n_byte *)&(local.parasites),"parasites");
-    audit_print_offset(start,(n_byte *)&(local.honor),"honor");
+    audit_print_offset(start,(n_byte *)&(local.being.state),"state");
+    audit_print_offset(start,(n_byte *)&(local.being.crowding),"crowding");
+    audit_print_offset(start,(n_byte *)&(local.being.parasites),"parasites");
+    audit_print_offset(start,(n_byte *)&(local.being.honor),"honor");
     
-    audit_print_offset(start,(n_byte *)&(local.date_of_conception[0]),"date_of_conception[0]");
-    audit_print_offset(start,(n_byte *)&(local.mother_new_genetics[0]),"mother_new_genetics[0]");
-    audit_print_offset(start,(n_byte *)&(local.father_new_genetics[0]),"father_new_genetics[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.date_of_conception[0]),"date_of_conception[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.mother_new_genetics[0]),"mother_new_genetics[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.father_new_genetics[0]),"father_new_genetics[0]");
     
-    audit_print_offset(start,(n_byte *)&(local.father_honor),"father_honor");
-    audit_print_offset(start,(n_byte *)&(local.father_name[0]),"father_name[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.father_honor),"father_honor");
+    audit_print_offset(start,(n_byte *)&(local.being.father_name[0]),"father_name[0]");
     
-    audit_print_offset(start,(n_byte *)&(local.new_genetics[0]),"new_genetics[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.new_genetics[0]),"new_genetics[0]");
     
-    audit_print_offset(start,(n_byte *)&(local.social_x),"social_x");
+    audit_print_offset(start,(n_byte *)&(local.being.social_x),"social_x");
     
-    audit_print_offset(start,(n_byte *)&(local.drives[0]),"drives[0]");
-    audit_print_offset(start,(n_byte *)&(local.goal[0]),"goal[0]");
-    audit_print_offset(start,(n_byte *)&(local.learned_preference[0]),"learned_preference[0]");
-    audit_print_offset(start,(n_byte *)&(local.territory[0]),"territory[0]");
-    audit_print_offset(start,(n_byte *)&(local.immune_system),"immune_system[0]");
-    audit_print_offset(start,(n_byte *)&(local.brainprobe[0]),"brainprobe[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.drives[0]),"drives[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.goal[0]),"goal[0]");
+    audit_print_offset(start,(n_byte *)&(local.being.learned_preference[0]),"learned_preference[0]");
+    audit_print_offset(start,(n_byte *)&(local.cold.territory[0]),"territory[0]");
+    audit_print_offset(start,(n_byte *)&(local.cold.immune_system),"immune_system[0]");
+    audit_print_offset(start,(n_byte *)&(local.cold.brainprobe[0]),"brainprobe[0]");
 }
 
 static void audit(void)
@@ -268,6 +268,11 @@ n_int   count_switch = 0;
     shared_notTerritory();
 }
 
+-(IBAction) menuControlNoWater:(id) sender
+{
+    shared_notWater();
+}
+
 -(IBAction) menuControlNoWeather:(id) sender
 {
     shared_notWeather();
@@ -46,6 +46,15 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#ifndef _WIN32
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <windows.h>
+#endif
 /*NOBLEMAKE END=""*/
 
 static n_int command_line_execution;
@@ -325,6 +334,423 @@ void file_chain_bin_name(n_string original, n_string bin_file)
     sprintf(bin_file, "%s.bin",original);
 }
 
+#define SNAPSHOT_VERSION        (1)
+#define SNAPSHOT_HEADER_BYTES   (64)
+#define SNAPSHOT_ENTRY_BYTES    (32)
+
+#define SNAPSHOT_ALIGNED(value) (((value) + (SNAPSHOT_ALIGN - 1)) & ~((n_uint)SNAPSHOT_ALIGN - 1))
+
+static const n_byte snapshot_signature[4] = {'N', 'A', 'P', 'S'};
+
+/* the sections are written as they are in memory, so only little-endian machines share snapshots */
+static n_int io_snapshot_little_endian(void)
+{
+    n_c_uint one = 1;
+    return (*((n_byte *)&one) == 1);
+}
+
+static void io_snapshot_put(n_byte * location, n_uint value, n_uint bytes)
+{
+    n_uint loop = 0;
+    while (loop < bytes)
+    {
+        location[loop++] = (n_byte)(value & 255);
+        value >>= 8;
+    }
+}
+
+static n_uint io_snapshot_get(n_byte * location, n_uint bytes)
+{
+    n_uint value = 0;
+    while (bytes > 0)
+    {
+        bytes--;
+        value = (value << 8) | location[bytes];
+    }
+    return value;
+}
+
+/**
+ * Writes a snapshot file. The file is written under a temporary name and then
+ * renamed so a failed write never leaves a partial snapshot.
+ * @param name The name of the file.
+ * @param sections The sections with their id, element_bytes, bytes and data set.
+ * The offset and checksum are filled in.
+ * @param count The number of sections.
+ * @return 0 on success, -1 on failure.
+ */
+n_int io_snapshot_write(n_string name, n_snapshot_section * sections, n_uint count)
+{
+    n_byte         head[SNAPSHOT_HEADER_BYTES + (SNAPSHOT_SECTIONS_MAX * SNAPSHOT_ENTRY_BYTES)];
+    n_byte         padding[SNAPSHOT_ALIGN];
+    n_uint         table_bytes = count * SNAPSHOT_ENTRY_BYTES;
+    n_uint         offset = SNAPSHOT_ALIGNED(SNAPSHOT_HEADER_BYTES + table_bytes);
+    n_uint         written = SNAPSHOT_HEADER_BYTES + table_bytes;
+    n_uint         loop = 0;
+    n_string_block temporary_name;
+    FILE         * write_file;
+
+    if (io_snapshot_little_endian() == 0)
+    {
+        return SHOW_ERROR("Snapshots are little-endian only");
+    }
+    if ((count == 0) || (count > SNAPSHOT_SECTIONS_MAX))
+    {
+        return SHOW_ERROR("Snapshot section count invalid");
+    }
+
+    io_erase(head, sizeof(head));
+    io_erase(padding, sizeof(padding));
+
+    while (loop < count)
+    {
+        n_byte * entry = &head[SNAPSHOT_HEADER_BYTES + (loop * SNAPSHOT_ENTRY_BYTES)];
+        sections[loop].offset = offset;
+        sections[loop].checksum = math_checksum((n_byte *)sections[loop].data, sections[loop].bytes);
+        io_snapshot_put(&entry[0], sections[loop].id, 4);
+        io_snapshot_put(&entry[4], sections[loop].element_bytes, 4);
+        io_snapshot_put(&entry[8], sections[loop].offset, 8);
+        io_snapshot_put(&entry[16], sections[loop].bytes, 8);
+        io_snapshot_put(&entry[24], sections[loop].checksum, 4);
+        offset = SNAPSHOT_ALIGNED(offset + sections[loop].bytes);
+        loop++;
+    }
+
+    io_copy((n_byte *)snapshot_signature, head, 4);
+    io_snapshot_put(&head[4], SNAPSHOT_VERSION, 4);
+    io_snapshot_put(&head[8], SNAPSHOT_HEADER_BYTES, 4);
+    io_snapshot_put(&head[12], count, 4);
+    io_snapshot_put(&head[16], offset, 8);
+    io_snapshot_put(&head[24], math_checksum(&head[SNAPSHOT_HEADER_BYTES], table_bytes), 4);
+    io_snapshot_put(&head[60], math_checksum(head, 60), 4);
+
+    sprintf(temporary_name, "%s.tmp", name);
+    write_file = fopen(temporary_name, "wb");
+    if (write_file == 0L)
+    {
+        return SHOW_ERROR("Snapshot could not be created");
+    }
+    if (fwrite(head, 1, written, write_file) != written)
+    {
+        fclose(write_file);
+        (void)remove(temporary_name);
+        return SHOW_ERROR("Snapshot could not be written");
+    }
+    loop = 0;
+    while (loop < count)
+    {
+        n_uint pad = sections[loop].offset - written;
+        if ((fwrite(padding, 1, pad, write_file) != pad) ||
+            (fwrite(sections[loop].data, 1, sections[loop].bytes, write_file) != sections[loop].bytes))
+        {
+            fclose(write_file);
+            (void)remove(temporary_name);
+            return SHOW_ERROR("Snapshot could not be written");
+        }
+        written = sections[loop].offset + sections[loop].bytes;
+        loop++;
+    }
+    if (fwrite(padding, 1, offset - written, write_file) != (offset - written))
+    {
+        fclose(write_file);
+        (void)remove(temporary_name);
+        return SHOW_ERROR("Snapshot could not be written");
+    }
+    if (fclose(write_file) != 0)
+    {
+        (void)remove(temporary_name);
+        return SHOW_ERROR("Snapshot could not be written");
+    }
+#ifdef _WIN32
+    (void)remove(name);
+#endif
+    if (rename(temporary_name, name) != 0)
+    {
+        (void)remove(temporary_name);
+        return SHOW_ERROR("Snapshot could not be renamed");
+    }
+    return 0;
+}
+
+/* maps the file read only where possible, otherwise reads it into memory */
+static n_int io_snapshot_load(n_string name, n_snapshot * snapshot)
+{
+#ifndef _WIN32
+    struct stat file_stat;
+    n_int       file_descriptor = open(name, O_RDONLY);
+
+    if (file_descriptor < 0)
+    {
+        return SHOW_ERROR("Snapshot does not exist");
+    }
+    if ((fstat(file_descriptor, &file_stat) != 0) || (file_stat.st_size < SNAPSHOT_HEADER_BYTES))
+    {
+        close(file_descriptor);
+        return SHOW_ERROR("Snapshot too short");
+    }
+    snapshot->bytes = (n_uint)file_stat.st_size;
+    snapshot->base = (n_byte *)mmap(0L, snapshot->bytes, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+    if (snapshot->base == (n_byte *)MAP_FAILED)
+    {
+        snapshot->base = 0L;
+        return SHOW_ERROR("Snapshot could not be mapped");
+    }
+    snapshot->mapped = 1;
+    return 0;
+#else
+    FILE * read_file = 0L;
+    long   file_size;
+
+    fopen_s(&read_file, name, "rb");
+    if (read_file == 0L)
+    {
+        return SHOW_ERROR("Snapshot does not exist");
+    }
+    fseek(read_file, 0, SEEK_END);
+    file_size = ftell(read_file);
+    fseek(read_file, 0, SEEK_SET);
+    if (file_size < SNAPSHOT_HEADER_BYTES)
+    {
+        fclose(read_file);
+        return SHOW_ERROR("Snapshot too short");
+    }
+    snapshot->bytes = (n_uint)file_size;
+    snapshot->base = (n_byte *)io_new(snapshot->bytes);
+    if (snapshot->base == 0L)
+    {
+        fclose(read_file);
+        return SHOW_ERROR("Snapshot not allocated");
+    }
+    if (fread(snapshot->base, 1, snapshot->bytes, read_file) != snapshot->bytes)
+    {
+        fclose(read_file);
+        io_free(snapshot->base);
+        snapshot->base = 0L;
+        return SHOW_ERROR("Snapshot could not be read");
+    }
+    fclose(read_file);
+    return 0;
+#endif
+}
+
+/**
+ * Opens a snapshot file so its sections can be used in place. The sections are
+ * read only and stay valid until io_snapshot_close.
+ * @param name The name of the file.
+ * @param snapshot The snapshot filled in.
+ * @param validate Non zero to check the checksum of every section as well as the table.
+ * @return 0 on success, -1 on failure.
+ */
+n_int io_snapshot_open(n_string name, n_snapshot * snapshot, n_byte validate)
+{
+    n_byte * head;
+    n_uint   table_bytes;
+    n_uint   loop = 0;
+
+    io_erase((n_byte *)snapshot, sizeof(n_snapshot));
+
+    if (io_snapshot_little_endian() == 0)
+    {
+        return SHOW_ERROR("Snapshots are little-endian only");
+    }
+    if (io_snapshot_load(name, snapshot) != 0)
+    {
+        return -1;
+    }
+
+    head = snapshot->base;
+    snapshot->count = io_snapshot_get(&head[12], 4);
+    table_bytes = snapshot->count * SNAPSHOT_ENTRY_BYTES;
+
+    if (io_same(head, (n_byte *)snapshot_signature, 4) == 0)
+    {
+        io_snapshot_close(snapshot);
+        return SHOW_ERROR("Not a snapshot");
+    }
+    if (io_snapshot_get(&head[60], 4) != math_checksum(head, 60))
+    {
+        io_snapshot_close(snapshot);
+        return SHOW_ERROR("Snapshot header corrupt");
+    }
+    if (io_snapshot_get(&head[4], 4) != SNAPSHOT_VERSION)
+    {
+        io_snapshot_close(snapshot);
+        return SHOW_ERROR("Snapshot version not supported");
+    }
+    if ((snapshot->count > SNAPSHOT_SECTIONS_MAX) ||
+        (io_snapshot_get(&head[16], 8) != snapshot->bytes) ||
+        ((SNAPSHOT_HEADER_BYTES + table_bytes) > snapshot->bytes))
+    {
+        io_snapshot_close(snapshot);
+        return SHOW_ERROR("Snapshot size wrong");
+    }
+    if (io_snapshot_get(&head[24], 4) != math_checksum(&head[SNAPSHOT_HEADER_BYTES], table_bytes))
+    {
+        io_snapshot_close(snapshot);
+        return SHOW_ERROR("Snapshot table corrupt");
+    }
+
+    while (loop < snapshot->count)
+    {
+        n_byte             * entry = &head[SNAPSHOT_HEADER_BYTES + (loop * SNAPSHOT_ENTRY_BYTES)];
+        n_snapshot_section * section = &snapshot->section[loop];
+
+        section->id = (n_c_uint)io_snapshot_get(&entry[0], 4);
+        section->element_bytes = (n_c_uint)io_snapshot_get(&entry[4], 4);
+        section->offset = io_snapshot_get(&entry[8], 8);
+        section->bytes = io_snapshot_get(&entry[16], 8);
+        section->checksum = (n_c_uint)io_snapshot_get(&entry[24], 4);
+
+        if (((section->offset % SNAPSHOT_ALIGN) != 0) ||
+            (section->offset > snapshot->bytes) ||
+            (section->bytes > (snapshot->bytes - section->offset)))
+        {
+            io_snapshot_close(snapshot);
+            return SHOW_ERROR("Snapshot section outside the file");
+        }
+        section->data = &snapshot->base[section->offset];
+
+        if (validate && (math_checksum((n_byte *)section->data, section->bytes) != section->checksum))
+        {
+            io_snapshot_close(snapshot);
+            return SHOW_ERROR("Snapshot section corrupt");
+        }
+        loop++;
+    }
+    return 0;
+}
+
+/**
+ * Finds a section of an open snapshot.
+ * @param snapshot The open snapshot.
+ * @param id The identity of the section.
+ * @return The section or 0L if the snapshot does not have it.
+ */
+n_snapshot_section * io_snapshot_find(n_snapshot * snapshot, n_c_uint id)
+{
+    n_uint loop = 0;
+    while (loop < snapshot->count)
+    {
+        if (snapshot->section[loop].id == id)
+        {
+            return &snapshot->section[loop];
+        }
+        loop++;
+    }
+    return 0L;
+}
+
+void io_snapshot_close(n_snapshot * snapshot)
+{
+    if (snapshot->base == 0L)
+    {
+        return;
+    }
+#ifndef _WIN32
+    if (snapshot->mapped)
+    {
+        (void)munmap(snapshot->base, snapshot->bytes);
+    }
+    else
+#endif
+    {
+        io_free(snapshot->base);
+    }
+    snapshot->base = 0L;
+    snapshot->count = 0;
+}
+
+
+/**
+ * Maps a named block of memory that other processes can map by the same name.
+ * @param name the name of the block, which starts with a slash.
+ * @param bytes the size of the block.
+ * @param create non-zero to create the block to write to, zero to map an
+ * existing block to read from.
+ * @return the block or 0L if it could not be mapped or there is no shared memory.
+ */
+void * io_shared_open(n_string name, n_uint bytes, n_byte create)
+{
+#ifndef _WIN32
+    n_int  file_descriptor;
+    void * shared;
+
+    if (create)
+    {
+        file_descriptor = shm_open(name, O_RDWR | O_CREAT, 0644);
+    }
+    else
+    {
+        file_descriptor = shm_open(name, O_RDONLY, 0);
+    }
+    if (file_descriptor < 0)
+    {
+        return 0L;
+    }
+    if (create && (ftruncate(file_descriptor, (off_t)bytes) != 0))
+    {
+        close(file_descriptor);
+        (void)shm_unlink(name);
+        return 0L;
+    }
+    if (create == 0)
+    {
+        struct stat file_stat;
+        if ((fstat(file_descriptor, &file_stat) != 0) || ((n_uint)file_stat.st_size < bytes))
+        {
+            close(file_descriptor);
+            return 0L;
+        }
+    }
+    shared = mmap(0L, bytes, create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (shared == MAP_FAILED)
+    {
+        if (create)
+        {
+            (void)shm_unlink(name);
+        }
+        return 0L;
+    }
+    return shared;
+#else
+    return 0L;
+#endif
+}
+
+/**
+ * Unmaps a block mapped with io_shared_open.
+ * @param shared the block.
+ * @param bytes the size of the block.
+ * @param name the name to remove so no other process can map it, or 0L to leave it.
+ */
+void io_shared_close(void * shared, n_uint bytes, n_string name)
+{
+#ifndef _WIN32
+    if (shared != 0L)
+    {
+        (void)munmap(shared, bytes);
+    }
+    if (name != 0L)
+    {
+        (void)shm_unlink(name);
+    }
+#endif
+}
+
+/**
+ * Keeps the reads and writes to memory before this from being moved after it
+ * by the compiler or the processor, for memory shared with another process.
+ */
+void io_barrier(void)
+{
+#if defined(__GNUC__)
+    __sync_synchronize();
+#elif defined(_WIN32)
+    MemoryBarrier();
+#endif
+}
 
 void io_aiff_header(n_byte * header)
 {
@@ -484,6 +910,38 @@ void io_copy(n_byte * from, n_byte * to, n_uint number)
     memcpy(to, from, number);
 }
 
+/**
+ * Compares two blocks of memory with memcmp.
+ * @param first pointer to the first block.
+ * @param second pointer to the second block.
+ * @param number the number of bytes to compare.
+ * @return 1 if the blocks are the same, 0 otherwise.
+ */
+n_byte io_same(n_byte * first, n_byte * second, n_uint number)
+{
+    return (memcmp(first, second, number) == 0);
+}
+
+/**
+ * A monotonic high resolution clock for timing within the simulation. Only the
+ * difference between two values has meaning and it may wrap around.
+ * @return the time in nanoseconds.
+ */
+n_uint io_nanoseconds(void)
+{
+#ifndef _WIN32
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((n_uint)now.tv_sec * 1000000000) + (n_uint)now.tv_nsec;
+#else
+    LARGE_INTEGER frequency, now;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (n_uint)(((now.QuadPart / frequency.QuadPart) * 1000000000) +
+                    (((now.QuadPart % frequency.QuadPart) * 1000000000) / frequency.QuadPart));
+#endif
+}
+
 /**
  * This is a historical legacy function as all platforms now use malloc. Although in the future this may change.
  * @param bytes number of bytes to allocate.
@@ -604,21 +1062,21 @@ n_int io_disk_read(n_file * local_file, n_string file_name)
     {
         return SHOW_ERROR("File does not exist");
     }
-    while (!feof(in_file))
+    do
     {
-        n_byte local_char;
-        if (fread(&local_char,1,1,in_file)>0)
+        n_byte local_block[4096];
+        n_uint read_length = fread(local_block, 1, sizeof(local_block), in_file);
+        if (io_file_write_span(local_file, local_block, read_length) != FILE_OKAY)
         {
-            if (!feof(in_file))
-            {
-                n_int error = io_file_write(local_file, local_char);
-                if (error != 0)
-                {
-                    return FILE_ERROR;
-                }
-            }
+            fclose(in_file);
+            return FILE_ERROR;
+        }
+        if (read_length < sizeof(local_block))
+        {
+            break;
         }
     }
+    while (1);
     fclose(in_file);
     return FILE_OKAY;
 }
@@ -891,14 +1349,22 @@ n_string * io_tab_delimit_to_n_string_ptr(n_file * tab_file, n_int * size_value,
  */
 n_int io_read_byte4(n_file * fil, n_uint * actual_value, n_byte * final_char)
 {
-    n_uint  temp = 0;
-    n_int   ten_power_place = 0;
+    n_byte * data = fil->data;
+    n_uint   location = fil->location;
+    n_uint   end = fil->size;
+    n_uint   temp = 0;
+    n_int    ten_power_place = 0;
     while (1)
     {
-        n_byte  value = io_read(fil);
+        n_byte  value = CHAR_EOF;
         n_uint mod_ten;
+        if (location < end)
+        {
+            value = data[location++];
+        }
         if (!ASCII_NUMBER(value))
         {
+            fil->location = location;
             *actual_value = temp;
             *final_char = value;
             return ten_power_place;
@@ -906,10 +1372,12 @@ n_int io_read_byte4(n_file * fil, n_uint * actual_value, n_byte * final_char)
         mod_ten = value - '0';
         if ((temp == 429496729) && (mod_ten > 5))
         {
+            fil->location = location;
             return -1;
         }
         if (temp > 429496729)
         {
+            fil->location = location;
             return -1;
         }
         temp = (temp * 10) + mod_ten;
@@ -1067,51 +1535,171 @@ void io_whitespace(n_file * input)
     input->size = out_loop;
 }
 
-/**
- This is a dynamic write to file function which will increase the file size and
- allocated a larger data buffer if the original end of the file is reached. It
- is very useful for a number of dynamic file applications through the simulation.
- @param fil The file data to be written to.
- @param byte The byte/character to be written.
- @return Whether the parsing was successful or -1 on failure.
+/*
+ Reading a file without io_whitespace first. The white space and comments are
+ skipped as they are met, so the file is read in one pass where it lies.
  */
-n_int io_file_write(n_file * fil, n_byte byte)
+static void io_skip(n_file * fil)
 {
-    n_uint local_size = fil->size;
-    if((fil->location + 1) == local_size)
+    n_byte * data = fil->data;
+    n_uint   location = fil->location;
+    n_uint   end = fil->size;
+    while (location < end)
     {
-        /* This logic had to be changed for large file handling.*/
-        n_uint	temp_size;
-        n_byte *temp_data;
-        if (local_size <= (256*1024))
+        n_byte value = data[location];
+        if (ASCII_WHITESPACE(value))
+        {
+            location++;
+        }
+        else if ((value == '/') && ((location + 1) < end) && (data[location + 1] == '*'))
         {
-            temp_size = local_size * 4;
+            n_byte previous = 0;
+            location += 2;
+            while (location < end)
+            {
+                n_byte current = data[location++];
+                if ((previous == '*') && (current == '/'))
+                {
+                    break;
+                }
+                previous = current;
+            }
         }
         else
         {
-            if (local_size <= (512*1024*1024))
+            break;
+        }
+    }
+    fil->location = location;
+}
+
+static n_byte io_read_skip(n_file * fil)
+{
+    io_skip(fil);
+    return io_read(fil);
+}
+
+/* as io_read_byte4, with the digits read straight from the buffer until something other than a digit */
+static n_int io_read_byte4_skip(n_file * fil, n_uint * actual_value, n_byte * final_char)
+{
+    n_byte * data = fil->data;
+    n_uint   temp = 0;
+    n_int    ten_power_place = 0;
+    while (1)
+    {
+        n_uint  location = fil->location;
+        n_uint  end = fil->size;
+        n_byte  value = CHAR_EOF;
+        while (location < end)
+        {
+            n_uint mod_ten;
+            value = data[location++];
+            if (!ASCII_NUMBER(value))
             {
-                temp_size = local_size * 2;
+                break;
             }
-            else
+            mod_ten = value - '0';
+            if ((temp > 429496729) || ((temp == 429496729) && (mod_ten > 5)))
             {
-                temp_size = (local_size * 3) >> 1;
+                fil->location = location;
+                return -1;
             }
+            temp = (temp * 10) + mod_ten;
+            ten_power_place++;
+            value = CHAR_EOF;
         }
-        temp_data = io_new(temp_size);
-        if (temp_data == 0L)
+        fil->location = location;
+        if (ASCII_WHITESPACE(value) || (value == '/'))
         {
-            return(SHOW_ERROR("Attempted file overwrite"));
+            fil->location--;
+            io_skip(fil);
+            if ((fil->location < end) && ASCII_NUMBER(data[fil->location]))
+            {
+                continue;
+            }
+            value = io_read(fil);
         }
-        io_copy(fil->data, temp_data, local_size);
-        io_free(fil->data);
-        fil->data = temp_data;
-        fil->size = temp_size;
+        *actual_value = temp;
+        *final_char = value;
+        return ten_power_place;
+    }
+}
+
+/*
+ The file always keeps a spare byte past its location. It grows by a multiple
+ of its size, resized in place where the memory allows, so the time spent
+ growing stays in proportion to what is written.
+ */
+static n_int io_file_grow(n_file * fil, n_uint length)
+{
+    n_uint   temp_size = fil->size;
+    n_byte * temp_data;
+
+    while ((fil->location + length) >= temp_size)
+    {
+        /* This logic had to be changed for large file handling.*/
+        if (temp_size <= (256*1024))
+        {
+            temp_size = temp_size * 4;
+        }
+        else
+        {
+            if (temp_size <= (512*1024*1024))
+            {
+                temp_size = temp_size * 2;
+            }
+            else
+            {
+                temp_size = (temp_size * 3) >> 1;
+            }
+        }
+    }
+    temp_data = (n_byte *)realloc(fil->data, temp_size);
+    if (temp_data == 0L)
+    {
+        return(SHOW_ERROR("Attempted file overwrite"));
+    }
+    fil->data = temp_data;
+    fil->size = temp_size;
+    return (FILE_OKAY);
+}
+
+/**
+ This is a dynamic write to file function which will increase the file size and
+ allocated a larger data buffer if the original end of the file is reached. It
+ is very useful for a number of dynamic file applications through the simulation.
+ @param fil The file data to be written to.
+ @param byte The byte/character to be written.
+ @return Whether the parsing was successful or -1 on failure.
+ */
+n_int io_file_write(n_file * fil, n_byte byte)
+{
+    if (((fil->location + 1) >= fil->size) && (io_file_grow(fil, 1) != FILE_OKAY))
+    {
+        return -1;
     }
     fil->data[fil->location++] = byte;
     return (FILE_OKAY);
 }
 
+/**
+ Writes a block of bytes to the end of the file, growing the file at most once.
+ @param fil The file data to be written to.
+ @param bytes The bytes to be written.
+ @param length The number of bytes.
+ @return FILE_OKAY or -1 on failure.
+ */
+n_int io_file_write_span(n_file * fil, n_byte * bytes, n_uint length)
+{
+    if (((fil->location + length) >= fil->size) && (io_file_grow(fil, length) != FILE_OKAY))
+    {
+        return -1;
+    }
+    io_copy(bytes, &fil->data[fil->location], length);
+    fil->location += length;
+    return (FILE_OKAY);
+}
+
 /* Memory saving */
 void io_file_reused(n_file * fil)
 {
@@ -1188,40 +1776,49 @@ n_int io_find(n_string check, n_int from, n_int max, n_string value_find, n_int
     return -1;
 }
 
-/* writes a string, adding a new line if required in the OS correct format */
-#define FILE_MACRO_WRITE(ch)		if(io_file_write(fil,(ch)) == -1) return -1
+/* the endings io_write adds, a new line in the OS correct format and/or a tab */
+static n_uint io_write_ending(n_byte * ending, n_byte new_line)
+{
+    n_uint length = 0;
+    if (new_line&1)
+    {
+#ifdef	_WIN32
+        ending[length++] = 13;
+#endif
+        ending[length++] = 10;
+    }
+    if (new_line&2)
+    {
+        ending[length++] = 9;
+    }
+    return length;
+}
 
+/* writes a string, adding a new line if required in the OS correct format */
 n_int io_write(n_file * fil, n_string ch, n_byte new_line)
 {
-    if (ch[0] != 0)
+    n_byte ending[3];
+    n_uint length = 0;
+
+    while (ch[length] != 0)
     {
-        n_uint	lp = 0;
-        while (ch[lp] != 0)
-        {
-            FILE_MACRO_WRITE(ch[lp++]);
-        }
+        length++;
     }
-    if (new_line&1)
+    if (io_file_write_span(fil, (n_byte *)ch, length) == -1)
     {
-#ifndef	_WIN32
-        FILE_MACRO_WRITE(10);
-#else
-        FILE_MACRO_WRITE(13);
-        FILE_MACRO_WRITE(10);
-#endif
+        return -1;
     }
-    if (new_line&2)
+    length = io_write_ending(ending, new_line);
+    if (length != 0)
     {
-        FILE_MACRO_WRITE(9);
+        return io_file_write_span(fil, ending, length);
     }
     return (FILE_OKAY);
 }
 
-/* writes a 16-bit or 8-bit number with an end terminator(,/;) and new line if required */
-/* n_int error */
-n_int io_writenumber(n_file * fil, n_int loc_val, n_uint numer, n_uint denom)
+/* formats the number into the end of the buffer and gives where it starts or -1 on overflow */
+static n_int io_number_format(n_byte * number_buffer, n_int loc_val, n_uint numer, n_uint denom)
 {
-    n_byte	number_buffer[14] = {0};
     n_byte	negative;
     n_byte	decimal = 0;
     n_uint	positive_number;
@@ -1266,18 +1863,38 @@ n_int io_writenumber(n_file * fil, n_int loc_val, n_uint numer, n_uint denom)
         number_buffer[location] = '-';
     else
         location++;
-    return io_write(fil, (n_string)&number_buffer[location], 0);
+    return location;
 }
 
-n_int io_writenum(n_file * fil, n_int loc_val, n_byte ekind, n_byte new_line)
+/* writes a 16-bit or 8-bit number with an end terminator(,/;) and new line if required */
+/* n_int error */
+n_int io_writenumber(n_file * fil, n_int loc_val, n_uint numer, n_uint denom)
 {
-    n_int	return_val = io_writenumber(fil, loc_val,1,0);
-    n_byte	ekind_buffer[2] = {0};
-    if(return_val!=FILE_OKAY)
-        return return_val;
-    ekind_buffer[0] = ekind;
+    n_byte	number_buffer[14];
+    n_int	location = io_number_format(number_buffer, loc_val, numer, denom);
+    if (location < 0)
+    {
+        return -1;
+    }
+    return io_file_write_span(fil, &number_buffer[location], 13 - location);
+}
 
-    return io_write(fil, (n_string)ekind_buffer, new_line);
+/* the number, its terminator and ending are written together */
+n_int io_writenum(n_file * fil, n_int loc_val, n_byte ekind, n_byte new_line)
+{
+    n_byte	number_buffer[17];
+    n_int	location = io_number_format(number_buffer, loc_val, 1, 0);
+    n_uint	end = 13;
+    if (location < 0)
+    {
+        return -1;
+    }
+    if (ekind != 0)
+    {
+        number_buffer[end++] = ekind;
+    }
+    end += io_write_ending(&number_buffer[end], new_line);
+    return io_file_write_span(fil, &number_buffer[location], end - location);
 }
 
 /* find the variable command */
@@ -1320,9 +1937,7 @@ n_int io_command(n_file * fil, const noble_file_entry * commands)
 #define	FILE_MACRO_CONCLUSION(ch)	(((comman_req==1) && (ch) == ',') || \
 									 ((comman_req==0) && (ch) == ';'))
 
-/* after the variable command, read the kind of data in specified through the commands array */
-/* n_int error */
-n_int io_read_data(n_file * fil, n_byte2 command, n_byte * data_read)
+static n_int io_read_data_skip(n_file * fil, n_byte2 command, n_byte * data_read, n_byte skip)
 {
     n_int  comman_req = ((command & FILE_CONTINUATION) == FILE_CONTINUATION);
     n_byte type_from_command = (n_byte)FILE_TYPE(command);
@@ -1341,9 +1956,9 @@ n_int io_read_data(n_file * fil, n_byte2 command, n_byte * data_read)
 
         while (loop < PACKED_DATA_BLOCK)
         {
-            buffer[0] = io_read(fil);
-            buffer[1] = io_read(fil);
-            buffer[2] = io_read(fil);
+            buffer[0] = skip ? io_read_skip(fil) : io_read(fil);
+            buffer[1] = skip ? io_read_skip(fil) : io_read(fil);
+            buffer[2] = skip ? io_read_skip(fil) : io_read(fil);
 
             output_val = (buffer[0]-65);
             output_val += (buffer[1]-65) * 41;
@@ -1352,7 +1967,7 @@ n_int io_read_data(n_file * fil, n_byte2 command, n_byte * data_read)
             data_read[loop++] = (output_val >> 0) & 255;
             data_read[loop++] = (output_val >> 8) & 255;
         }
-        num_char  = io_read(fil);
+        num_char  = skip ? io_read_skip(fil) : io_read(fil);
 
         if (FILE_MACRO_CONCLUSION(num_char))
             return (FILE_OKAY);
@@ -1365,7 +1980,16 @@ n_int io_read_data(n_file * fil, n_byte2 command, n_byte * data_read)
     {
         n_uint	number = 0;
         n_byte	num_char;
-        n_int   response_code = io_read_byte4(fil, &number, &num_char);
+        n_int   response_code;
+
+        if (skip)
+        {
+            response_code = io_read_byte4_skip(fil, &number, &num_char);
+        }
+        else
+        {
+            response_code = io_read_byte4(fil, &number, &num_char);
+        }
 
         if (response_code == 0)
             return SHOW_ERROR("Expected number not found");
@@ -1394,25 +2018,145 @@ n_int io_read_data(n_file * fil, n_byte2 command, n_byte * data_read)
     return SHOW_ERROR("Type not found");
 }
 
+/* after the variable command, read the kind of data in specified through the commands array */
+/* n_int error */
+n_int io_read_data(n_file * fil, n_byte2 command, n_byte * data_read)
+{
+    return io_read_data_skip(fil, command, data_read, 0);
+}
+
+
+static n_uint io_file_index_hash(const n_byte * characters, n_uint seed)
+{
+    n_uint hash = 0;
+    n_int  loop = 0;
+    while (loop < 6)
+    {
+        hash = (hash * seed) + characters[loop++];
+    }
+    return (hash ^ (hash >> 13)) & (FILE_INDEX_SIZE - 1);
+}
 
 /**
- @discussion This function takes a file and parses the file date with the commands
- shown into the output data. This function is extremely powerful because it allows
- all different kinds of format-rich text data to be converted into binary
- information based on the command information passed in to this function too.
- @param fil The file data to be parsed.
- @param data The resultant output data.
- @param commands The commands used to parse the output data.
- @return Whether the parsing was successful or -1 on failure.
+ Builds a perfect hash of the command characters. Odd multipliers are tried
+ until every command has a slot of its own, which takes a handful of tries for
+ the simulation file format.
+ @param commands The commands, ending with an all zero entry.
+ @param index The resultant index.
+ @return 0 if the index was built and -1 on failure.
  */
-n_int	io_read_buff(n_file * fil, n_byte * data, const noble_file_entry * commands)
+n_int io_file_index(const noble_file_entry * commands, noble_file_index * index)
+{
+    n_uint seed = 3;
+    index->commands = commands;
+    while (seed < 0x10000)
+    {
+        n_int lp = 0;
+        n_int collision = 0;
+        io_erase((n_byte *)index->slot, sizeof(index->slot));
+        while (commands[lp].characters[0] != 0)
+        {
+            n_uint slot = io_file_index_hash(commands[lp].characters, seed);
+            if (index->slot[slot] != 0)
+            {
+                collision = 1;
+                break;
+            }
+            index->slot[slot] = (n_byte2)(lp + 1);
+            lp++;
+        }
+        if (collision == 0)
+        {
+            index->seed = seed;
+            return 0;
+        }
+        seed += 2;
+    }
+    return SHOW_ERROR("File commands could not be indexed");
+}
+
+/* find the variable command through the index, reading straight from the buffer */
+static n_int io_command_index(n_file * fil, const noble_file_index * index)
+{
+    n_byte   gathered[6];
+    n_byte * found_text;
+    const n_byte * command_text;
+    n_byte2  slot;
+    n_int    loop = 0;
+
+    io_skip(fil);
+    found_text = &fil->data[fil->location];
+
+    if ((fil->location >= fil->size) || (found_text[0] == 0))
+    {
+        return (FILE_EOF);
+    }
+    if ((fil->location + 6) <= fil->size)
+    {
+        while (loop < 6)
+        {
+            n_byte value = found_text[loop];
+            if (ASCII_WHITESPACE(value) || (value == '/') || (value == 0))
+            {
+                break;
+            }
+            loop++;
+        }
+    }
+    if (loop == 6)
+    {
+        if (found_text[0] == '}' && found_text[1] == ';')
+        {
+            fil->location += 2;
+            return (FILE_END_INCLUSION);
+        }
+        fil->location += 6;
+    }
+    else
+    {
+        /* white space or a comment within the command */
+        gathered[0] = io_read_skip(fil);
+        gathered[1] = io_read_skip(fil);
+        if (gathered[0] == '}' && gathered[1] == ';')
+            return (FILE_END_INCLUSION);
+        gathered[2] = io_read_skip(fil);
+        gathered[3] = io_read_skip(fil);
+        gathered[4] = io_read_skip(fil);
+        gathered[5] = io_read_skip(fil);
+        found_text = gathered;
+    }
+
+    slot = index->slot[io_file_index_hash(found_text, index->seed)];
+    if (slot == 0)
+    {
+        return -1;
+    }
+    command_text = index->commands[slot - 1].characters;
+    if ((command_text[0] == found_text[0]) && (command_text[1] == found_text[1]) &&
+            (command_text[2] == found_text[2]) && (command_text[3] == found_text[3]) &&
+            (command_text[4] == found_text[4]) && (command_text[5] == found_text[5]))
+    {
+        return (slot - 1);
+    }
+    return -1;
+}
+
+static n_int io_read_buff_commands(n_file * fil, n_byte * data, const noble_file_entry * commands,
+                                   const noble_file_index * index)
 {
 
     n_int	inclusion_number = 0xffff;
     n_int	result_number = 0;
     do
     {
-        result_number = io_command(fil, commands);
+        if (index)
+        {
+            result_number = io_command_index(fil, index);
+        }
+        else
+        {
+            result_number = io_command(fil, commands);
+        }
         if(result_number == -1)
             return SHOW_ERROR("Unknown command");
 
@@ -1447,7 +2191,7 @@ n_int	io_read_buff(n_file * fil, n_byte * data, const noble_file_entry * command
                 n_byte	local_kind = com_kind;
                 if ((loop + 1) != com_number_of)
                     local_kind |= FILE_CONTINUATION;
-                if (io_read_data(fil, local_kind, local_data) != FILE_OKAY)
+                if (io_read_data_skip(fil, local_kind, local_data, (index != 0L)) != FILE_OKAY)
                     return (FILE_ERROR);
                 if (com_kind == FILE_TYPE_PACKED)
                 {
@@ -1472,6 +2216,34 @@ n_int	io_read_buff(n_file * fil, n_byte * data, const noble_file_entry * command
     return (inclusion_number);
 }
 
+/**
+ @discussion This function takes a file and parses the file date with the commands
+ shown into the output data. This function is extremely powerful because it allows
+ all different kinds of format-rich text data to be converted into binary
+ information based on the command information passed in to this function too.
+ @param fil The file data to be parsed.
+ @param data The resultant output data.
+ @param commands The commands used to parse the output data.
+ @return Whether the parsing was successful or -1 on failure.
+ */
+n_int	io_read_buff(n_file * fil, n_byte * data, const noble_file_entry * commands)
+{
+    return io_read_buff_commands(fil, data, commands, 0L);
+}
+
+/**
+ As io_read_buff, with the commands found through an index from io_file_index.
+ The file is read as it was loaded, without io_whitespace, in a single pass.
+ @param fil The file data to be parsed.
+ @param data The resultant output data.
+ @param index The index of the commands used to parse the output data.
+ @return Whether the parsing was successful or -1 on failure.
+ */
+n_int	io_read_buff_index(n_file * fil, n_byte * data, const noble_file_index * index)
+{
+    return io_read_buff_commands(fil, data, index->commands, index);
+}
+
 #define	IO_CHECK_ERROR(cnd)             \
     {                                   \
         n_int	out_cnd = cnd;          \
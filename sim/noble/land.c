@@ -45,6 +45,12 @@
 
 #endif
 
+/* the rows of the pressure update are worked out with AVX2 where the processor has it, a row in one vector */
+#if defined(__GNUC__) && defined(__x86_64__) && (WEATHER_BLOCK == 8)
+#define WEATHER_VECTOR
+#include <immintrin.h>
+#endif
+
 /*NOBLEMAKE END=""*/
 /*NOBLEMAKE VAR=""*/
 
@@ -127,75 +133,357 @@ void weather_debug(n_weather * local_weather)
 
 #endif
 
-void weather_cycle(n_land * local_land, n_weather * local_weather)
+#define     WEATHER_DIMENSION   (MAP_DIMENSION/2)
+
+/* with no evaporation and no rain release there is nothing for the first pass to do */
+#if (WATER_EVAP_TIDE != 0) || (WATER_EVAP_REG != 0) || (WATER_RELEASE_RAIN != 0)
+#define     WEATHER_RAIN_ON
+#endif
+
+/**
+ * Adds the water evaporated from the land under the tide and releases the rain.
+ * Each weather point is tested for rain before the evaporation from its four
+ * map points is added, apart from the very first map point which comes before.
+ * @param local_land The land with the tide level.
+ * @param local_weather The weather to change.
+ */
+void weather_evaporate(n_land * local_land, n_weather * local_weather)
 {
-    n_c_int       total_pressure = 0;
-    n_int         local_delta = local_weather->total_pressure  >> (MAP_BITS-1);
+#ifdef WEATHER_RAIN_ON
     n_c_int       * atmosphere  = local_weather->atmosphere;
-    n_int         lx = 0;
     n_byte        * local_map = local_land->map;
-    n_byte        local_tide = local_land->tide_level;
-    while (lx < MAP_DIMENSION)
+    n_byte          local_tide = local_land->tide_level;
+    n_c_int         rate[256];
+    n_int           loop = 0;
+    n_int           ly = 0;
+
+    while (loop < 256)
     {
-        n_int ly = 0;
-        while (ly < MAP_DIMENSION)
+        rate[loop] = (loop == local_tide) ? WATER_EVAP_TIDE : ((loop < local_tide) ? WATER_EVAP_REG : 0);
+        loop++;
+    }
+
+    atmosphere[WEATHER_MEM(0,0,0)] += rate[local_map[0]];
+
+    while (ly < WEATHER_DIMENSION)
+    {
+        n_byte * map_row = &local_map[(ly << 1) << MAP_BITS];
+        n_int    lx = 0;
+        while (lx < WEATHER_DIMENSION)
         {
-            n_byte  land_value = local_map[lx | (ly << MAP_BITS)];
-            n_uint  location = WEATHER_MEM(ly>>1,lx>>1,0);
-            
-            if (land_value == local_tide)
+            n_c_int * point = &atmosphere[WEATHER_MEM(ly,lx,0)];
+            n_int     map_x = lx << 1;
+            if (*point >= WEATHER_RAIN)
             {
-                atmosphere[ location ] += WATER_EVAP_TIDE;
+                *point -= WATER_RELEASE_RAIN;
             }
-            else if (land_value < local_tide)
+            *point += rate[map_row[map_x + 1]]
+                      + rate[map_row[map_x + MAP_DIMENSION]] + rate[map_row[map_x + 1 + MAP_DIMENSION]];
+            if ((lx | ly) != 0)
             {
-                atmosphere[ location ] += WATER_EVAP_REG;
+                *point += rate[map_row[map_x]];
             }
-            
-            if ((lx < (MAP_DIMENSION/2))&&(ly < (MAP_DIMENSION/2)))
+            lx++;
+        }
+        ly++;
+    }
+#endif
+}
+
+/* a single point of the pressure update with the wrap around worked out for each neighbour */
+static n_c_uint weather_point(n_c_int * atmosphere, n_int local_delta, n_int lx, n_int ly)
+{
+    n_int	lx_min = WEATHER_MEM((lx + (WEATHER_DIMENSION-1) ) & (WEATHER_DIMENSION-1), 0, 0);
+    n_int	lx_plu = WEATHER_MEM((lx + 1 ) & (WEATHER_DIMENSION-1), 0, 0);
+    n_int	lx_val = WEATHER_MEM(lx,0,0);
+    n_int	ly_val = WEATHER_MEM(0,ly,0);
+    n_int	local_atm =
+        atmosphere[ lx_val | ly_val | CONST_BACK ]
+        - atmosphere[ lx_plu | ly_val ]
+        + atmosphere[ lx_min| ly_val ]
+        - atmosphere[ lx_val| WEATHER_MEM(0, ( ly + 1 ) & (WEATHER_DIMENSION-1), 0 ) ]
+        + atmosphere[ lx_val| WEATHER_MEM(0, ( ly + (WEATHER_DIMENSION-1) ) & (WEATHER_DIMENSION-1), 0 ) ];
+
+    atmosphere[ WEATHER_MEM(ly,lx,0) ] += (local_atm - local_delta) >> (MAP_BITS-1);
+    return (n_c_uint)local_atm;
+}
+
+/*
+ The pressure update reads the neighbours of one point and adds the result to the
+ transposed point, in place, so some of the neighbours read have already been updated
+ in the same cycle. Above the diagonal (ly > lx + 1) none of them have, below it
+ (ly < lx - 1) all of them have, so each triangle can be worked in any order and
+ split over threads. The diagonal and the wrapped edges between the triangles are
+ worked in the original order by weather_diagonal. The total pressure is summed
+ without sign so the parts can be added in any order and give the same total.
+ */
+
+/*
+ A WEATHER_BLOCK square inside a triangle away from the wrapped edges. The pressure
+ is worked out along the rows, where the neighbours are next to each other in memory,
+ before any point is written and then written along the transposed rows.
+ */
+
+typedef void (weather_rows)(n_c_int * atmosphere, n_int lx_start, n_int ly_start, n_c_int local_atm[WEATHER_BLOCK][WEATHER_BLOCK]);
+
+static void weather_rows_scalar(n_c_int * atmosphere, n_int lx_start, n_int ly_start, n_c_int local_atm[WEATHER_BLOCK][WEATHER_BLOCK])
+{
+    n_int       loop = 0;
+    while (loop < WEATHER_BLOCK)
+    {
+        n_int       lx = lx_start + loop;
+        n_c_int   * row     = &atmosphere[WEATHER_MEM(lx, ly_start, 0)];
+        n_c_int   * row_min = &atmosphere[WEATHER_MEM(lx - 1, ly_start, 0)];
+        n_c_int   * row_plu = &atmosphere[WEATHER_MEM(lx + 1, ly_start, 0)];
+        n_c_int   * result  = local_atm[loop];
+        n_int       ly = 0;
+        while (ly < WEATHER_BLOCK)
+        {
+            n_int   ly_val = ly * 2;
+            result[ly] = row[ly_val + 1] - row_plu[ly_val] + row_min[ly_val]
+                         - row[ly_val + 2] + row[ly_val - 2];
+            ly++;
+        }
+        loop++;
+    }
+}
+
+#ifdef WEATHER_VECTOR
+
+/* eight points of the front or the back of the atmosphere from sixteen interleaved */
+#define WEATHER_PAIRS(pointer, half)  _mm256_permute2x128_si256( \
+            _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *)(pointer)), weather_split), \
+            _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *)((pointer) + 8)), weather_split), (half))
+#define WEATHER_FRONT(pointer)  WEATHER_PAIRS(pointer, 0x20)
+#define WEATHER_BACK(pointer)   WEATHER_PAIRS(pointer, 0x31)
+
+/* the sums wrap at 32 bits in the same way as the scalar rows */
+__attribute__((target("avx2")))
+static void weather_rows_avx2(n_c_int * atmosphere, n_int lx_start, n_int ly_start, n_c_int local_atm[WEATHER_BLOCK][WEATHER_BLOCK])
+{
+    __m256i     weather_split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    n_int       loop = 0;
+    while (loop < WEATHER_BLOCK)
+    {
+        n_int       lx = lx_start + loop;
+        n_c_int   * row     = &atmosphere[WEATHER_MEM(lx, ly_start, 0)];
+        n_c_int   * row_min = &atmosphere[WEATHER_MEM(lx - 1, ly_start, 0)];
+        n_c_int   * row_plu = &atmosphere[WEATHER_MEM(lx + 1, ly_start, 0)];
+        __m256i     sum = WEATHER_BACK(row);
+        sum = _mm256_sub_epi32(sum, WEATHER_FRONT(row_plu));
+        sum = _mm256_add_epi32(sum, WEATHER_FRONT(row_min));
+        sum = _mm256_sub_epi32(sum, WEATHER_FRONT(row + 2));
+        sum = _mm256_add_epi32(sum, WEATHER_FRONT(row - 2));
+        _mm256_storeu_si256((__m256i *)local_atm[loop], sum);
+        loop++;
+    }
+}
+
+#endif
+
+static weather_rows * weather_rows_kernel = 0L;
+
+/**
+ * Chooses how the rows of the pressure update are worked out. This is called
+ * before any weather is cycled on more than one thread.
+ * @return 1 for AVX2 and 0 for the scalar rows
+ */
+n_int weather_cycle_init(void)
+{
+    if (weather_rows_kernel != 0L)
+    {
+        return (weather_rows_kernel == &weather_rows_scalar) ? 0 : 1;
+    }
+    weather_rows_kernel = &weather_rows_scalar;
+#ifdef WEATHER_VECTOR
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        weather_rows_kernel = &weather_rows_avx2;
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+static n_c_uint weather_square(n_c_int * atmosphere, n_int local_delta, n_int lx_start, n_int ly_start)
+{
+    n_c_int     local_atm[WEATHER_BLOCK][WEATHER_BLOCK];
+    n_c_uint    total = 0;
+    n_int       loop = 0;
+
+    if (weather_rows_kernel == 0L)
+    {
+        weather_rows_scalar(atmosphere, lx_start, ly_start, local_atm);
+    }
+    else
+    {
+        (weather_rows_kernel)(atmosphere, lx_start, ly_start, local_atm);
+    }
+
+    while (loop < WEATHER_BLOCK)
+    {
+        n_c_int   * row = &atmosphere[WEATHER_MEM(ly_start + loop, lx_start, 0)];
+        n_int       lx = 0;
+        while (lx < WEATHER_BLOCK)
+        {
+            n_c_int value = local_atm[lx][loop];
+            row[lx << 1] += (value - local_delta) >> (MAP_BITS-1);
+            total += (n_c_uint)value;
+            lx++;
+        }
+        loop++;
+    }
+    return total;
+}
+
+/**
+ * Updates the pressure in rows of the upper or lower triangle of the atmosphere.
+ * The upper triangle must be updated before weather_diagonal and the lower after.
+ * The rows are worked in blocks of WEATHER_BLOCK so each transposed point written
+ * shares its cache line with the rest of the block rather than missing every time.
+ * @param local_weather The weather to change.
+ * @param lower 0 for the upper triangle, 1 for the lower.
+ * @param lx_start The first row, best a multiple of WEATHER_BLOCK.
+ * @param lx_end One past the last row.
+ * @return The part of the total pressure from these rows.
+ */
+n_c_uint weather_triangle(n_weather * local_weather, n_byte lower, n_int lx_start, n_int lx_end)
+{
+    n_c_int   * atmosphere  = local_weather->atmosphere;
+    n_int       local_delta = local_weather->total_pressure >> (MAP_BITS-1);
+    n_c_uint    total = 0;
+    n_int       block = lx_start;
+
+    if (lower && (lx_end > (WEATHER_DIMENSION-1)))
+    {
+        lx_end = WEATHER_DIMENSION-1;
+    }
+
+    while (block < lx_end)
+    {
+        n_int   block_end = block + WEATHER_BLOCK;
+        n_int   ly, ly_end;
+
+        if (block_end > lx_end)
+        {
+            block_end = lx_end;
+        }
+        if (lower)
+        {
+            ly = 1;
+            ly_end = block_end - 2;
+        }
+        else
+        {
+            ly = block + 2;
+            ly_end = WEATHER_DIMENSION - 1;
+        }
+        while (ly < ly_end)
+        {
+            n_int   square_end = ly + WEATHER_BLOCK;
+            n_byte  square = ((block_end - block) == WEATHER_BLOCK) && ((ly & (WEATHER_BLOCK-1)) == 0) && (square_end <= ly_end);
+            if (square)
+            {
+                square = lower ? ((square_end + 1) <= block) : (ly >= (block_end + 1));
+            }
+            if (square)
             {
-                n_uint  new_location = WEATHER_MEM(ly,lx,0);
-                if (atmosphere[ new_location ] >= WEATHER_RAIN)
+                total += weather_square(atmosphere, local_delta, block, ly);
+                ly = square_end;
+            }
+            else
+            {
+                n_int   lx = block;
+                n_int   lx_end_row = block_end;
+                n_int   ly_val = WEATHER_MEM(0,ly,0);
+                n_int   ly_row = WEATHER_MEM(ly,0,0);
+                if (lower)
                 {
-                    atmosphere[ new_location ] -= WATER_RELEASE_RAIN;
+                    if (lx < (ly + 2))
+                    {
+                        lx = ly + 2;
+                    }
                 }
+                else
+                {
+                    if (lx_end_row > (ly - 1))
+                    {
+                        lx_end_row = ly - 1;
+                    }
+                }
+                while (lx < lx_end_row)
+                {
+                    n_int	lx_val = WEATHER_MEM(lx,0,0);
+                    n_int	local_atm =
+                        atmosphere[ lx_val | ly_val | CONST_BACK ]
+                        - atmosphere[ WEATHER_MEM(lx + 1, 0, 0) | ly_val ]
+                        + atmosphere[ WEATHER_MEM(lx - 1, 0, 0) | ly_val ]
+                        - atmosphere[ lx_val | (ly_val + 2) ]
+                        + atmosphere[ lx_val | (ly_val - 2) ];
+
+                    atmosphere[ ly_row | (lx << 1) ] += (local_atm - local_delta) >> (MAP_BITS-1);
+                    total += (n_c_uint)local_atm;
+                    lx++;
+                }
+                ly++;
             }
-            
+        }
+        block = block_end;
+    }
+    return total;
+}
+
+/**
+ * Updates the pressure on the diagonal and the wrapped edges in the original order.
+ * @param local_weather The weather to change.
+ * @return The part of the total pressure from these points.
+ */
+n_c_uint weather_diagonal(n_weather * local_weather)
+{
+    n_c_int   * atmosphere  = local_weather->atmosphere;
+    n_int       local_delta = local_weather->total_pressure >> (MAP_BITS-1);
+    n_c_uint    total = 0;
+    n_int       lx = 0;
+    while (lx < (WEATHER_DIMENSION-1))
+    {
+        n_int   ly = (lx > 2) ? (lx - 1) : 1;
+        n_int   ly_end = (lx < (WEATHER_DIMENSION-3)) ? (lx + 1) : (WEATHER_DIMENSION-2);
+        total += weather_point(atmosphere, local_delta, lx, 0);
+        while (ly <= ly_end)
+        {
+            total += weather_point(atmosphere, local_delta, lx, ly);
             ly++;
         }
+        total += weather_point(atmosphere, local_delta, lx, WEATHER_DIMENSION-1);
         lx++;
     }
-    
-    lx = 0;
-    while ( lx < (MAP_DIMENSION/2) )
     {
-        n_int	lx_min = WEATHER_MEM((lx + ((MAP_DIMENSION/2)-1) ) & ((MAP_DIMENSION/2)-1), 0, 0);
-        n_int	lx_plu = WEATHER_MEM((lx + 1 ) & ((MAP_DIMENSION/2)-1), 0, 0);
-        n_int	lx_val = WEATHER_MEM(lx,0,0);
-        n_int	ly = 0;
-        while ( ly < (MAP_DIMENSION/2) )
+        n_int   ly = 0;
+        while (ly < WEATHER_DIMENSION)
         {
-            n_int	ly_val = WEATHER_MEM(0,ly,0);
-            n_int	local_atm =
-                atmosphere[ lx_val | ly_val | CONST_BACK ]
-                - atmosphere[ lx_plu | ly_val ]
-                + atmosphere[ lx_min| ly_val ]
-                - atmosphere[ lx_val| WEATHER_MEM(0, ( ly + 1 ) & ((MAP_DIMENSION/2)-1), 0 ) ]
-                + atmosphere[ lx_val| WEATHER_MEM(0, ( ly + ((MAP_DIMENSION/2)-1) ) & ((MAP_DIMENSION/2)-1), 0 ) ];
-
-            atmosphere[ WEATHER_MEM(ly,lx,0) ] += (local_atm - local_delta) >> (MAP_BITS-1);
-            total_pressure += local_atm;
+            total += weather_point(atmosphere, local_delta, lx, ly);
             ly++;
         }
-        lx++;
     }
-    local_weather->total_pressure = total_pressure;
-    
-    
+    return total;
+}
+
+void weather_cycle(n_land * local_land, n_weather * local_weather)
+{
+    n_c_uint      total_pressure;
+
+    weather_evaporate(local_land, local_weather);
+
+    total_pressure  = weather_triangle(local_weather, 0, 0, WEATHER_DIMENSION);
+    total_pressure += weather_diagonal(local_weather);
+    total_pressure += weather_triangle(local_weather, 1, 0, WEATHER_DIMENSION);
+
+    local_weather->total_pressure = (n_c_int)total_pressure;
+
 #ifdef WEATHER_DEBUG
     weather_debug(local_weather);
 #endif
-    
 }
 
 void weather_init(n_weather * local_weather, n_land * local_land)
@@ -398,7 +686,15 @@ void land_cycle(n_land * local_land)
 
 #define	WATER_MAP2									(WATER_MAP * 2)
 
-static n_int land_operator(n_land * local_land, n_weather * local_weather, n_int locx, n_int locy, n_byte *specific_kind)
+/* a point where the salt rules out the operator whatever the other terms */
+#define LAND_OPERATOR_ZERO                          (7)
+
+/*
+ The terms of an operator that depend only on the land are summed and packed with
+ the number of terms (sum * 8 + number) so they can be kept for each map point.
+ The moving sun depends on the time and the weather so is added in land_operator_value.
+ */
+static n_int land_operator_fixed(n_land * local_land, n_int locx, n_int locy, n_byte *specific_kind)
 {
     n_int	fg  = QUICK_LAND(local_land, locx, locy);
     n_int	dfg = QUICK_LAND(local_land, locx + 1, locy);
@@ -439,27 +735,6 @@ static n_int land_operator(n_land * local_land, n_weather * local_weather, n_int
         else
             temp += WATER_MAP2 - temp_add;
     }
-    if(specific_kind[3] != '.')
-    {
-        if(IS_NIGHT(local_land->time) == 0)
-        {
-            /* 180 is minutes in the day / 8 */
-            n_int hr = ((((local_land->time << 6) / 180) + 32) & 255);
-
-            n_int weather = weather_seven_values(local_land, local_weather, MAPSPACE_TO_APESPACE(locx), MAPSPACE_TO_APESPACE(locy));
-
-            n_int weather_divide = (105 + ((weather % 3) * 30));
-            n_int ct = (840 + OLD_SD_NEW_SD(hr+64)) / weather_divide;
-            n_int st = (840 + OLD_SD_NEW_SD(hr)) / weather_divide;
-
-            number_sum ++;
-            temp_add = OPERATOR_SUN(fg, dfg, fdg, ct, st); /* O */
-            if(specific_kind[3] == '+')
-                temp += temp_add;
-            else
-                temp += WATER_MAP2 - temp_add;
-        }
-    }
     if(specific_kind[4] != '.')
     {
         number_sum ++;
@@ -474,7 +749,7 @@ static n_int land_operator(n_land * local_land, n_weather * local_weather, n_int
         n_int fs = -(fg - TIDE_AMPLITUDE_LUNAR - TIDE_AMPLITUDE_SOLAR);
         if ((fs < 0) || (fs > (TIDE_AMPLITUDE_LUNAR + TIDE_AMPLITUDE_SOLAR)*2))
         {
-            if(specific_kind[5] == '+') temp=0;
+            if(specific_kind[5] == '+') return LAND_OPERATOR_ZERO;
         }
         else
         {
@@ -483,6 +758,48 @@ static n_int land_operator(n_land * local_land, n_weather * local_weather, n_int
                 temp += OPERATOR_SALT(fg, dfg, fdg, fs); /* S */
         }
     }
+    return (temp * 8) + number_sum;
+}
+
+static n_int land_operator_value(n_land * local_land, n_weather * local_weather, n_int locx, n_int locy, n_byte *specific_kind, n_int fixed)
+{
+    n_int   number_sum = fixed & 7;
+    n_int   temp;
+
+    if (number_sum == LAND_OPERATOR_ZERO)
+    {
+        return 0;
+    }
+
+    temp = (fixed - number_sum) / 8;
+
+    if(specific_kind[3] != '.')
+    {
+        if(IS_NIGHT(local_land->time) == 0)
+        {
+            n_int	fg  = QUICK_LAND(local_land, locx, locy);
+            n_int	dfg = (QUICK_LAND(local_land, locx + 1, locy) - fg) * 8;
+
+            /* 180 is minutes in the day / 8 */
+            n_int hr = ((((local_land->time << 6) / 180) + 32) & 255);
+
+            n_int weather = weather_seven_values(local_land, local_weather, MAPSPACE_TO_APESPACE(locx), MAPSPACE_TO_APESPACE(locy));
+
+            n_int weather_divide = (105 + ((weather % 3) * 30));
+            n_int ct = (840 + OLD_SD_NEW_SD(hr+64)) / weather_divide;
+            n_int st = (840 + OLD_SD_NEW_SD(hr)) / weather_divide;
+            n_int temp_add;
+
+            fg = fg - WATER_MAP;
+
+            number_sum ++;
+            temp_add = OPERATOR_SUN(fg, dfg, 0, ct, st); /* O */
+            if(specific_kind[3] == '+')
+                temp += temp_add;
+            else
+                temp += WATER_MAP2 - temp_add;
+        }
+    }
     if(number_sum != 0)
     {
         temp = temp / number_sum;
@@ -490,7 +807,17 @@ static n_int land_operator(n_land * local_land, n_weather * local_weather, n_int
     return (temp);
 }
 
-n_int land_operator_interpolated(n_land * local_land, n_weather * local_weather, n_int locx, n_int locy, n_byte * kind)
+static n_int land_operator(n_land * local_land, n_weather * local_weather, n_c_int * fixed, n_int locx, n_int locy, n_byte *specific_kind)
+{
+    if (fixed != 0L)
+    {
+        return land_operator_value(local_land, local_weather, locx, locy, specific_kind, fixed[locx | (locy << MAP_BITS)]);
+    }
+    return land_operator_value(local_land, local_weather, locx, locy, specific_kind,
+                               land_operator_fixed(local_land, locx, locy, specific_kind));
+}
+
+static n_int land_operator_linear(n_land * local_land, n_weather * local_weather, n_c_int * fixed, n_int locx, n_int locy, n_byte * kind)
 {
     n_int map_x = APESPACE_TO_MAPSPACE(locx);
     n_int map_y = APESPACE_TO_MAPSPACE(locy);
@@ -498,16 +825,190 @@ n_int land_operator_interpolated(n_land * local_land, n_weather * local_weather,
     /*  Not bilinear interpolation but linear interpolation. Probably should replace with bilinear (ie each value has x and y dependency) */
     n_int interpolated;
     interpolated = APESPACE_TO_MAPSPACE(
-                       land_operator(local_land, local_weather, (map_x+1)&(MAP_DIMENSION-1), map_y, kind)*(locx-MAPSPACE_TO_APESPACE(map_x)));
+                       land_operator(local_land, local_weather, fixed, (map_x+1)&(MAP_DIMENSION-1), map_y, kind)*(locx-MAPSPACE_TO_APESPACE(map_x)));
     interpolated += APESPACE_TO_MAPSPACE(
-                        land_operator(local_land, local_weather, (map_x-1)&(MAP_DIMENSION-1), map_y, kind)*(MAPSPACE_TO_APESPACE(map_x+1)-locx));
+                        land_operator(local_land, local_weather, fixed, (map_x-1)&(MAP_DIMENSION-1), map_y, kind)*(MAPSPACE_TO_APESPACE(map_x+1)-locx));
     interpolated += APESPACE_TO_MAPSPACE(
-                        land_operator(local_land, local_weather, map_x, (map_y+1)&(MAP_DIMENSION-1), kind)*(locy-MAPSPACE_TO_APESPACE(map_y)));
+                        land_operator(local_land, local_weather, fixed, map_x, (map_y+1)&(MAP_DIMENSION-1), kind)*(locy-MAPSPACE_TO_APESPACE(map_y)));
     interpolated += APESPACE_TO_MAPSPACE(
-                        land_operator(local_land, local_weather, map_x, (map_y-1)&(MAP_DIMENSION-1), kind)*(MAPSPACE_TO_APESPACE(map_y+1)-locy));
+                        land_operator(local_land, local_weather, fixed, map_x, (map_y-1)&(MAP_DIMENSION-1), kind)*(MAPSPACE_TO_APESPACE(map_y+1)-locy));
     return interpolated >> 1;
 }
 
+n_int land_operator_interpolated(n_land * local_land, n_weather * local_weather, n_int locx, n_int locy, n_byte * kind)
+{
+    return land_operator_linear(local_land, local_weather, 0L, locx, locy, kind);
+}
+
+/**
+ * Fills a map of the terms of an operator that only change with the land.
+ * @param local_land The land the map is made from.
+ * @param kind The operator.
+ * @param fixed MAP_AREA values to fill.
+ */
+void land_operator_map(n_land * local_land, n_byte * kind, n_c_int * fixed)
+{
+    n_int   loop_y = 0;
+    while (loop_y < MAP_DIMENSION)
+    {
+        n_int   loop_x = 0;
+        while (loop_x < MAP_DIMENSION)
+        {
+            fixed[loop_x | (loop_y << MAP_BITS)] = (n_c_int)land_operator_fixed(local_land, loop_x, loop_y, kind);
+            loop_x++;
+        }
+        loop_y++;
+    }
+}
+
+/**
+ * The same as land_operator_interpolated but with the land terms from land_operator_map.
+ * @param local_land The land.
+ * @param local_weather The weather for the moving sun.
+ * @param fixed The map made by land_operator_map for this operator.
+ * @param locx X ape coordinate.
+ * @param locy Y ape coordinate.
+ * @param kind The operator.
+ * @return The operator value at the location.
+ */
+n_int land_operator_mapped(n_land * local_land, n_weather * local_weather, n_c_int * fixed, n_int locx, n_int locy, n_byte * kind)
+{
+    return land_operator_linear(local_land, local_weather, fixed, locx, locy, kind);
+}
+
+/* chamfer steps of the water field, three to the side and four on the diagonal */
+#define WATER_STEP_SIDE     (3)
+#define WATER_STEP_DIAGONAL (4)
+#define WATER_FAR           (0xffff)
+
+#define WATER_INDEX(px, py) (((px) & (MAP_DIMENSION-1)) | (((py) & (MAP_DIMENSION-1)) << MAP_BITS))
+
+static void land_water_step(n_byte2 * distance, n_int loc, n_int px, n_int py, n_int step)
+{
+    n_uint  possible = distance[WATER_INDEX(px, py)] + step;
+    if (possible < distance[loc])
+    {
+        distance[loc] = (n_byte2)possible;
+    }
+}
+
+static n_int land_water_signed(n_land * local_land, n_byte tide, n_byte2 * distance, n_int px, n_int py)
+{
+    n_int   loc = WATER_INDEX(px, py);
+    if (WATER_TEST(local_land->map[loc], tide))
+    {
+        return 0 - distance[loc];
+    }
+    return distance[loc];
+}
+
+/**
+ * Fills the water field of the land at one tide level. Each map point gets two
+ * bytes. The first is the distance to the water's edge in map points about
+ * LAND_WATER_EDGE, below it in the water and above it on the land. The second is
+ * the facing away from the water, or towards the land when in the water.
+ * @param local_land The land the field is made from.
+ * @param tide The tide level of the field.
+ * @param field 2 * MAP_AREA bytes to fill.
+ * @param distance MAP_AREA values of scratch space.
+ */
+void land_water_field(n_land * local_land, n_byte tide, n_byte * field, n_byte2 * distance)
+{
+    n_byte * map = local_land->map;
+    n_int    pass = 0;
+    n_int    loop_y = 0;
+
+    /* the map points either side of the water's edge start the distances */
+    while (loop_y < MAP_DIMENSION)
+    {
+        n_int   loop_x = 0;
+        while (loop_x < MAP_DIMENSION)
+        {
+            n_int   loc = WATER_INDEX(loop_x, loop_y);
+            n_byte  wet = (n_byte)WATER_TEST(map[loc], tide);
+            distance[loc] = WATER_FAR;
+            if ((wet != WATER_TEST(map[WATER_INDEX(loop_x + 1, loop_y)], tide)) ||
+                    (wet != WATER_TEST(map[WATER_INDEX(loop_x - 1, loop_y)], tide)) ||
+                    (wet != WATER_TEST(map[WATER_INDEX(loop_x, loop_y + 1)], tide)) ||
+                    (wet != WATER_TEST(map[WATER_INDEX(loop_x, loop_y - 1)], tide)))
+            {
+                distance[loc] = WATER_STEP_SIDE;
+            }
+            loop_x++;
+        }
+        loop_y++;
+    }
+
+    /* the land wraps so the forward and backward passes are made twice */
+    while (pass < 2)
+    {
+        loop_y = 0;
+        while (loop_y < MAP_DIMENSION)
+        {
+            n_int   loop_x = 0;
+            while (loop_x < MAP_DIMENSION)
+            {
+                n_int   loc = WATER_INDEX(loop_x, loop_y);
+                land_water_step(distance, loc, loop_x - 1, loop_y,     WATER_STEP_SIDE);
+                land_water_step(distance, loc, loop_x - 1, loop_y - 1, WATER_STEP_DIAGONAL);
+                land_water_step(distance, loc, loop_x,     loop_y - 1, WATER_STEP_SIDE);
+                land_water_step(distance, loc, loop_x + 1, loop_y - 1, WATER_STEP_DIAGONAL);
+                loop_x++;
+            }
+            loop_y++;
+        }
+        loop_y = MAP_DIMENSION - 1;
+        while (loop_y > -1)
+        {
+            n_int   loop_x = MAP_DIMENSION - 1;
+            while (loop_x > -1)
+            {
+                n_int   loc = WATER_INDEX(loop_x, loop_y);
+                land_water_step(distance, loc, loop_x + 1, loop_y,     WATER_STEP_SIDE);
+                land_water_step(distance, loc, loop_x + 1, loop_y + 1, WATER_STEP_DIAGONAL);
+                land_water_step(distance, loc, loop_x,     loop_y + 1, WATER_STEP_SIDE);
+                land_water_step(distance, loc, loop_x - 1, loop_y + 1, WATER_STEP_DIAGONAL);
+                loop_x--;
+            }
+            loop_y--;
+        }
+        pass++;
+    }
+
+    loop_y = 0;
+    while (loop_y < MAP_DIMENSION)
+    {
+        n_int   loop_x = 0;
+        while (loop_x < MAP_DIMENSION)
+        {
+            n_int   loc = WATER_INDEX(loop_x, loop_y);
+            n_int   points = (distance[loc] + 1) / WATER_STEP_SIDE;
+            n_int   gradient_x = land_water_signed(local_land, tide, distance, loop_x + 1, loop_y)
+                                 - land_water_signed(local_land, tide, distance, loop_x - 1, loop_y);
+            n_int   gradient_y = land_water_signed(local_land, tide, distance, loop_x, loop_y + 1)
+                                 - land_water_signed(local_land, tide, distance, loop_x, loop_y - 1);
+            if (points > (LAND_WATER_EDGE - 1))
+            {
+                points = LAND_WATER_EDGE - 1;
+            }
+            if (WATER_TEST(map[loc], tide))
+            {
+                points = 0 - points;
+            }
+            /* far from any edge the field is flat, so go uphill instead */
+            if ((gradient_x == 0) && (gradient_y == 0))
+            {
+                gradient_x = map[WATER_INDEX(loop_x + 1, loop_y)] - map[WATER_INDEX(loop_x - 1, loop_y)];
+                gradient_y = map[WATER_INDEX(loop_x, loop_y + 1)] - map[WATER_INDEX(loop_x, loop_y - 1)];
+            }
+            field[(loc << 1)]     = (n_byte)(LAND_WATER_EDGE + points);
+            field[(loc << 1) | 1] = math_turn_towards(gradient_x, gradient_y, 0, 0);
+            loop_x++;
+        }
+        loop_y++;
+    }
+}
+
 void land_clear(n_land * local, KIND_OF_USE kind, n_byte2 start)
 {
     n_byte *local_map = local->map;
@@ -422,6 +422,46 @@ n_uint math_hash(n_byte * values, n_uint length)
     return round[0] | (round[1]<<16);
 }
 
+/**
+ A Fletcher checksum of a block of data. It is much quicker than
+ math_hash and gives the same value on any platform, so it is used
+ to check large blocks of saved data.
+ @param values The data in byte chunks.
+ @param length The length of the data in bytes.
+ @return The checksum produced.
+ */
+n_c_uint math_checksum(n_byte * values, n_uint length)
+{
+    n_c_uint sum0 = 0xffff, sum1 = 0xffff;
+    n_uint   words = length >> 1;
+    n_uint   loop = 0;
+
+    while (words > 0)
+    {
+        /* 359 words is the most that can be summed before the sums overflow */
+        n_uint block = (words > 359) ? 359 : words;
+        words -= block;
+        while (block--)
+        {
+            sum0 += (n_c_uint)values[loop] | ((n_c_uint)values[loop + 1] << 8);
+            sum1 += sum0;
+            loop += 2;
+        }
+        sum0 = (sum0 & 0xffff) + (sum0 >> 16);
+        sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+    }
+    if (length & 1)
+    {
+        sum0 += values[loop];
+        sum1 += sum0;
+        sum0 = (sum0 & 0xffff) + (sum0 >> 16);
+        sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+    }
+    sum0 = (sum0 & 0xffff) + (sum0 >> 16);
+    sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+    return (sum1 << 16) | sum0;
+}
+
 #define		NUMBER_TURN_TOWARDS_POINTS	8
 
 /**
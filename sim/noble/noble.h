@@ -177,6 +177,23 @@ typedef	struct
 }
 noble_file_entry;
 
+#define FILE_INDEX_SIZE     (2048)
+
+/*! @struct
+ @field commands The command table the index was built from.
+ @field seed     The multiplier that gives every command its own slot.
+ @field slot     One more than the command number in each slot, zero if empty.
+ @discussion A perfect hash of the command characters, so reading a file finds
+ each command with one hash and one comparison.
+ */
+typedef	struct
+{
+    const noble_file_entry * commands;
+    n_uint                   seed;
+    n_byte2                  slot[FILE_INDEX_SIZE];
+}
+noble_file_index;
+
 /* include externally, if needed */
 #define	FILE_TYPE_BYTE			0x01
 #define	FILE_TYPE_BYTE2			0x02
@@ -295,6 +312,44 @@ typedef struct
 }
 n_file_chain;
 
+/* the most sections a snapshot file holds */
+#define SNAPSHOT_SECTIONS_MAX   (16)
+/* every snapshot section starts on this boundary in the file */
+#define SNAPSHOT_ALIGN          (64)
+
+/*! @struct
+ @field id The identity of the section, each section in a snapshot is different.
+ @field element_bytes The size of each element, so a reader can tell if its
+ structures match those of the writer.
+ @field offset Where the section starts in the file, aligned to SNAPSHOT_ALIGN.
+ @field bytes The size of the section.
+ @field checksum The math_checksum of the section.
+ @field data The section in memory, in the file once it is opened.
+ @discussion A snapshot is a little-endian binary file with a header, a table of
+ sections and the sections themselves aligned so they can be used straight out of
+ a mapped file.
+ */
+typedef struct
+{
+    n_c_uint  id;
+    n_c_uint  element_bytes;
+    n_uint    offset;
+    n_uint    bytes;
+    n_c_uint  checksum;
+    void    * data;
+}
+n_snapshot_section;
+
+typedef struct
+{
+    n_byte           * base;
+    n_uint             bytes;
+    n_byte             mapped;
+    n_uint             count;
+    n_snapshot_section section[SNAPSHOT_SECTIONS_MAX];
+}
+n_snapshot;
+
 /** \brief new_sd stands for new sine dump and hold the sine and cosine values for the simulation */
 const static n_int	new_sd[256] =
 {
@@ -474,6 +529,7 @@ void  vect2_offset(n_vect2 * initial, n_int dx, n_int dy);
 void  vect2_back_byte2(n_vect2 * converter, n_byte2 * output);
 
 n_uint  math_hash(n_byte * values, n_uint length);
+n_c_uint math_checksum(n_byte * values, n_uint length);
 void    math_bilinear_512_4096(n_byte * side512, n_byte * data);
 n_uint  math_newton_root(n_uint squ);
 n_uint  math_root(n_uint squ);
@@ -507,15 +563,20 @@ void       io_search_file_format(const noble_file_entry * format, n_string compa
 void       io_string_write(n_string dest, n_string insert, n_int * pos);
 n_int      io_read_bin(n_file * fil, n_byte * local_byte);
 n_int      io_file_write(n_file * fil, n_byte byte);
+n_int      io_file_write_span(n_file * fil, n_byte * bytes, n_uint length);
 void       io_file_reused(n_file * fil);
 n_int      io_write(n_file * fil, n_string ch, n_byte new_line);
 n_int      io_writenumber(n_file * fil, n_int loc_val, n_uint numer, n_uint denom);
 n_int      io_length(n_string value, n_int max);
 n_int      io_find(n_string check, n_int from, n_int max, n_string value_find, n_int value_find_length);
 n_int      io_read_buff(n_file * fil, n_byte * data, const noble_file_entry * commands);
+n_int      io_file_index(const noble_file_entry * commands, noble_file_index * index);
+n_int      io_read_buff_index(n_file * fil, n_byte * data, const noble_file_index * index);
 n_int      io_write_buff(n_file * fil, void * data, const noble_file_entry * commands, n_byte command_num, n_file_specific * func);
 n_int      io_write_csv(n_file * fil, n_byte * data, const noble_file_entry * commands, n_byte command_num, n_byte initial) ;
 void       io_copy(n_byte * from, n_byte * to, n_uint number);
+n_byte     io_same(n_byte * first, n_byte * second, n_uint number);
+n_uint     io_nanoseconds(void);
 void *     io_new(n_uint bytes);
 void       io_free(void * ptr);
 void *     io_new_range(n_uint memory_min, n_uint *memory_allocated);
@@ -557,6 +618,15 @@ n_int          file_chain_read_validate(n_string name, n_file_chain *initial);
 
 void           file_chain_bin_name(n_string original, n_string bin_file);
 
+n_int          io_snapshot_write(n_string name, n_snapshot_section * sections, n_uint count);
+n_int          io_snapshot_open(n_string name, n_snapshot * snapshot, n_byte validate);
+n_snapshot_section * io_snapshot_find(n_snapshot * snapshot, n_c_uint id);
+void           io_snapshot_close(n_snapshot * snapshot);
+
+void *         io_shared_open(n_string name, n_uint bytes, n_byte create);
+void           io_shared_close(void * shared, n_uint bytes, n_string name);
+void           io_barrier(void);
+
 n_int      io_aiff_test(void * ptr, n_string response, n_console_output output_function);
 
 n_int      io_quit(void * ptr, n_string response, n_console_output output_function);
@@ -658,6 +728,13 @@ void       io_console_quit(void);
 #define TIDE_AMPLITUDE_SOLAR  2
 
 #define TIDE_MAX              (WATER_MAP + TIDE_AMPLITUDE_LUNAR + TIDE_AMPLITUDE_SOLAR)
+#define TIDE_MIN              (WATER_MAP - TIDE_AMPLITUDE_LUNAR - TIDE_AMPLITUDE_SOLAR)
+
+/* the tide levels a water field can be made for */
+#define LAND_TIDE_LEVELS      (TIDE_MAX - TIDE_MIN + 1)
+
+/* the water field distance of the water's edge, water is below and land above */
+#define LAND_WATER_EDGE       (128)
 
 /* Night/Day definitions */
 #define IS_NIGHT(num)		((((num)>>5) <  (11))||(((num)>>5) >  (36)))
@@ -725,6 +802,15 @@ n_int weather_pressure(n_weather * wea, n_int px, n_int py);
 n_int weather_temperature(n_land * local_land, n_weather * wea, n_int px, n_int py);
 void  weather_wind_vector(n_weather * wea, n_int px, n_int py, n_int * wind_dx, n_int * wind_dy);
 void weather_cycle(n_land * local_land, n_weather * local_weather);
+
+/* rows of the atmosphere updated together by weather_triangle */
+#define  WEATHER_BLOCK   (8)
+
+n_int    weather_cycle_init(void);
+void     weather_evaporate(n_land * local_land, n_weather * local_weather);
+n_c_uint weather_triangle(n_weather * local_weather, n_byte lower, n_int lx_start, n_int lx_end);
+n_c_uint weather_diagonal(n_weather * local_weather);
+
 n_int weather_seven_values(n_land * local_land, n_weather * local_weather, n_int px, n_int py);
 
 void  land_init(n_land * local, n_byte * scratch);
@@ -732,6 +818,9 @@ void  land_clear(n_land * local, KIND_OF_USE kind, n_byte2 start);
 void  land_cycle(n_land * local_land);
 void  land_vect2(n_vect2 * output, n_int * actual_z, n_land * local, n_vect2 * location);
 n_int land_operator_interpolated(n_land * local_land, n_weather * local_weather, n_int locx, n_int locy, n_byte * kind);
+void  land_operator_map(n_land * local_land, n_byte * kind, n_c_int * fixed);
+n_int land_operator_mapped(n_land * local_land, n_weather * local_weather, n_c_int * fixed, n_int locx, n_int locy, n_byte * kind);
+void  land_water_field(n_land * local_land, n_byte tide, n_byte * field, n_byte2 * distance);
 
 
 /*0*/
@@ -876,6 +965,8 @@ it is the function name "being".
 @field sc_output This is the function pointer to the output handling function which is external to ApeScript.
 @field specific This defines which specific ApeScript instance is being run and is defined outside ApeScript and
 remains constant through the execution cycle.
+@field owner This is what the ApeScript is run on, it is defined outside ApeScript and is found through the code
+by the input and output handling functions.
 @field location         DOX_TEXT_MISSING
 @field leave            DOX_TEXT_MISSING
 @field localized_leave  DOX_TEXT_MISSING
@@ -905,6 +996,7 @@ typedef struct
     script_output   *sc_output;
 
     n_int			specific;
+    void          * owner;
 
     n_int           location;
     n_int           leave;
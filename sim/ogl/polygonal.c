@@ -51,6 +51,7 @@
 #include "../noble/noble.h"
 #include "../universe/universe.h"
 #include "../universe/universe_internal.h"
+#include "../entity/entity.h"
 #include "../gui/gui.h"
 
 #else
@@ -58,6 +59,7 @@
 #include "..\noble\noble.h"
 #include "..\universe\universe.h"
 #include "..\universe\universe_internal.h"
+#include "..\entity\entity.h"
 #include "..\gui\gui.h"
 
 #endif
@@ -211,12 +213,20 @@ static void polygonal_terrain_init()
 static void polygonal_terrain(void)
 {
     noble_simulation * local_sim = sim_sim();
-    noble_being * loc_being = &(local_sim->beings[local_sim->select]);
-    n_int turn = GET_F(loc_being);
-    n_int co_x = APESPACE_TO_HR_MAPSPACE(GET_X(loc_being));
-    n_int co_y = APESPACE_TO_HR_MAPSPACE(GET_Y(loc_being));
-    n_int modified_turn = ((32+64+8) + turn) & 255;
-    GLdouble rotating_angle = (modified_turn * 360.0)/256.0;
+    noble_being * loc_being = being_selected(local_sim);
+    n_int turn, co_x, co_y, modified_turn;
+    GLdouble rotating_angle;
+
+    if (loc_being == 0L)
+    {
+        return;
+    }
+
+    turn = GET_F(loc_being);
+    co_x = APESPACE_TO_HR_MAPSPACE(GET_X(loc_being));
+    co_y = APESPACE_TO_HR_MAPSPACE(GET_Y(loc_being));
+    modified_turn = ((32+64+8) + turn) & 255;
+    rotating_angle = (modified_turn * 360.0)/256.0;
 
     if (polygonal_terrain_first_run)
     {
@@ -0,0 +1,132 @@
+/****************************************************************
+
+	telemetry.c
+
+	=============================================================
+
+    Copyright 1996-2013 Tom Barbalet. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or
+	sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+
+    This software and Noble Ape are a continuing work of Tom Barbalet,
+    begun on 13 June 1996. No apes or cats were harmed in the writing
+    of this software.
+
+****************************************************************/
+
+/*
+    Shows the telemetry a running simulation publishes to shared memory with
+    the telemetry on console command.
+
+    natelemetry [seconds]
+
+    Without a number of seconds the telemetry is shown once, otherwise it is
+    shown again every number of seconds until interrupted. The reader never
+    makes the simulation wait.
+*/
+
+#define CONSOLE_ONLY
+#define CONSOLE_REQUIRED
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "noble/noble.h"
+#include "universe/universe.h"
+#include "entity/entity.h"
+
+n_int draw_error(n_string error_text)
+{
+    fprintf(stderr, "ERROR: %s\n", (const n_string) error_text);
+    return -1;
+}
+
+static void telemetry_show(noble_telemetry * copy)
+{
+    n_c_uint values[INDICATORS_COLUMNS];
+    n_int    phase = 0;
+    n_int    column = 0;
+
+    printf("Cycles %u, day %u, time %02u:%02u, population %u of %u\n",
+           (unsigned int)copy->cycles, (unsigned int)copy->date,
+           (unsigned int)(copy->time / 60), (unsigned int)(copy->time % 60),
+           (unsigned int)copy->population, (unsigned int)copy->max);
+
+    printf("%-11s %10s\n", "Phase (us)", "Last");
+    while (phase < PROFILE_PHASES)
+    {
+        printf("%-11s %10.1f\n", sim_profile_name(phase), (double)copy->phase[phase] / 1000);
+        phase++;
+    }
+
+    if (copy->indicators_complete == 0)
+    {
+        printf("No indicators complete yet\n");
+        return;
+    }
+    sim_indicators_values(&(copy->indicators[(copy->indicator_index + INDICATORS_BUFFER_SIZE - 1) % INDICATORS_BUFFER_SIZE]), values);
+    printf("Indicators %u\n", (unsigned int)copy->indicators_complete);
+    while (column < INDICATORS_COLUMNS)
+    {
+        printf("  %-38s %u\n", sim_indicators_log_name(column), (unsigned int)values[column]);
+        column++;
+    }
+}
+
+int main(int argc, n_string argv[])
+{
+    noble_telemetry * shared;
+    noble_telemetry   copy;
+    n_int             seconds = 0;
+
+    if ((argc > 2) || ((argc == 2) && ((seconds = atoi(argv[1])) < 1)))
+    {
+        fprintf(stderr, "usage: natelemetry [seconds]\n");
+        return 1;
+    }
+    shared = (noble_telemetry *)io_shared_open(TELEMETRY_NAME, sizeof(noble_telemetry), 0);
+    if (shared == 0L)
+    {
+        fprintf(stderr, "natelemetry: no telemetry at %s, turn it on with telemetry on\n", TELEMETRY_NAME);
+        return 1;
+    }
+    do
+    {
+        if (sim_telemetry_read(shared, &copy) != 0)
+        {
+            io_shared_close(shared, sizeof(noble_telemetry), 0L);
+            return 1;
+        }
+        telemetry_show(&copy);
+        fflush(stdout);
+        if (seconds)
+        {
+            sleep((unsigned int)seconds);
+            printf("\n");
+        }
+    }
+    while (seconds);
+    io_shared_close(shared, sizeof(noble_telemetry), 0L);
+    return 0;
+}
@@ -79,17 +79,25 @@ n_uint save_interval_steps = 60 * 24;
 n_int          console_file_interaction = 0;
 n_string_block console_file_name;
 
+/** background checkpoints, taken between cycles while the simulation runs */
+#define CHECKPOINT_NAME_SIZE (STRING_BLOCK_SIZE / 2)
+
+static char           checkpoint_file_name[CHECKPOINT_NAME_SIZE];
+static n_uint         checkpoint_interval_steps = 0;
+static n_uint         checkpoint_steps = 0;
+static n_int          checkpoint_requested = 0;
+
 n_int console_executing(void)
 {
     return simulation_executing;
 }
 
-void console_external_watch(void)
+void console_external_watch(noble_simulation * local_sim)
 {    
     if (io_command_line_execution())
     {
         n_string_block output;
-        sprintf(output,"External Action -> Watching %s\n", being_get_select_name(sim_sim()));
+        sprintf(output,"External Action -> Watching %s\n", being_get_select_name(local_sim));
         io_console_out(output);
     }
 }
@@ -487,10 +495,9 @@ n_int console_list(void * ptr, n_string response, n_console_output output_functi
 
 void console_populate_braincode(noble_simulation * local_sim, line_braincode function)
 {
-    if (local_sim->select != NO_BEINGS_FOUND)
+    noble_being * local_being = being_selected(local_sim);
+    if (local_being != 0L)
     {
-
-        noble_being * local_being = &(local_sim->beings[local_sim->select]);
         n_byte *internal_bc = GET_BRAINCODE_INTERNAL(local_sim, local_being);
         n_byte *external_bc = GET_BRAINCODE_EXTERNAL(local_sim, local_being);
         n_int           loop = 0;
@@ -651,12 +658,13 @@ static void watch_appearance(void *ptr, n_string beingname, noble_being * local_
 static void watch_vascular(void *ptr, n_string beingname, noble_being * local_being, n_string result)
 {
 #ifdef METABOLISM_ON
+    noble_simulation * local_sim = (noble_simulation *) ptr;
     n_int i,j,radius;
     n_string_block str;
     const n_int col[] = {24,32,41,53};
 
     io_string_write(result, "\nHeart rate: ", &watch_string_length);
-    sprintf(str,"%d bpm  %.1f Hz\n",GET_MT(local_being,METABOLISM_HEART_RATE)*60/1000,GET_MT(local_being,METABOLISM_HEART_RATE)/1000.0f);
+    sprintf(str,"%d bpm  %.1f Hz\n",GET_MT(local_sim, local_being,METABOLISM_HEART_RATE)*60/1000,GET_MT(local_sim, local_being,METABOLISM_HEART_RATE)/1000.0f);
     io_string_write(result, str, &watch_string_length);
 
     io_string_write(result, "\nVessel                  Radius    Flow   Pressure    Temp C\n", &watch_string_length);
@@ -674,7 +682,7 @@ static void watch_vascular(void *ptr, n_string beingname, noble_being * local_be
             io_string_write(result, " ", &watch_string_length);
         }
 
-        radius = metabolism_vascular_radius(local_being, i);
+        radius = metabolism_vascular_radius(local_sim, local_being, i);
         sprintf(str,"%02d.%02d",
                 (int)radius/100,
                 (int)radius%100);
@@ -687,7 +695,7 @@ static void watch_vascular(void *ptr, n_string beingname, noble_being * local_be
         }
 
         sprintf(str,"%06u",
-                (unsigned int)(local_being->vessel[i].flow_rate));
+                (unsigned int)(GET_V(local_sim, local_being)[i].flow_rate));
         io_string_write(result, str, &watch_string_length);
         j+=io_length(str,STRING_BLOCK_SIZE);
         while (j<col[2])
@@ -697,7 +705,7 @@ static void watch_vascular(void *ptr, n_string beingname, noble_being * local_be
         }
 
         sprintf(str,"%10u",
-                (unsigned int)(local_being->vessel[i].pressure));
+                (unsigned int)(GET_V(local_sim, local_being)[i].pressure));
         io_string_write(result, str, &watch_string_length);
         j+=io_length(str,STRING_BLOCK_SIZE);
         while (j<col[3])
@@ -707,8 +715,8 @@ static void watch_vascular(void *ptr, n_string beingname, noble_being * local_be
         }
 
         sprintf(str,"%02u.%02u",
-                (unsigned int)(local_being->vessel[i].temperature/1000),
-                (unsigned int)(local_being->vessel[i].temperature%1000)/10);
+                (unsigned int)(GET_V(local_sim, local_being)[i].temperature/1000),
+                (unsigned int)(GET_V(local_sim, local_being)[i].temperature%1000)/10);
         io_string_write(result, str, &watch_string_length);
 
         io_string_write(result, "\n", &watch_string_length);
@@ -726,25 +734,26 @@ static void watch_vascular(void *ptr, n_string beingname, noble_being * local_be
 static void watch_respiration(void *ptr, n_string beingname, noble_being * local_being, n_string result)
 {
 #ifdef METABOLISM_ON
+    noble_simulation * local_sim = (noble_simulation *) ptr;
     n_string_block str;
 
     io_string_write(result, "\nBreathing rate: ", &watch_string_length);
-    sprintf(str,"%d Vf   %.1f Hz\n",GET_MT(local_being,METABOLISM_BREATHING_RATE)*60/1000,GET_MT(local_being,METABOLISM_BREATHING_RATE)/1000.0f);
+    sprintf(str,"%d Vf   %.1f Hz\n",GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE)*60/1000,GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE)/1000.0f);
     io_string_write(result, str, &watch_string_length);
     io_string_write(result, "Lung Capacity:  ", &watch_string_length);
-    sprintf(str,"%d cm^3\n",GET_MT(local_being,METABOLISM_LUNG_CAPACITY));
+    sprintf(str,"%d cm^3\n",GET_MT(local_sim, local_being,METABOLISM_LUNG_CAPACITY));
     io_string_write(result, str, &watch_string_length);
     sprintf(str,"%s %05u   %s %05u\n",
             metabolism_description(METABOLISM_OXYGEN),
-            GET_MT(local_being,METABOLISM_OXYGEN),
+            GET_MT(local_sim, local_being,METABOLISM_OXYGEN),
             metabolism_description(METABOLISM_CO2),
-            GET_MT(local_being,METABOLISM_CO2));
+            GET_MT(local_sim, local_being,METABOLISM_CO2));
     io_string_write(result, str, &watch_string_length);
     sprintf(str,"%s %05u   %s %05u\n",
             metabolism_description(METABOLISM_GLUCOSE),
-            GET_MT(local_being,METABOLISM_GLUCOSE),
+            GET_MT(local_sim, local_being,METABOLISM_GLUCOSE),
             metabolism_description(METABOLISM_PYRUVATE),
-            GET_MT(local_being,METABOLISM_PYRUVATE));
+            GET_MT(local_sim, local_being,METABOLISM_PYRUVATE));
     io_string_write(result, str, &watch_string_length);
 #endif
 }
@@ -759,93 +768,94 @@ static void watch_respiration(void *ptr, n_string beingname, noble_being * local
 static void watch_metabolism(void *ptr, n_string beingname, noble_being * local_being, n_string result)
 {
 #ifdef METABOLISM_ON
+    noble_simulation * local_sim = (noble_simulation *) ptr;
     n_string_block str;
 
     io_string_write(result, "\nStomach:\n", &watch_string_length);
     sprintf(str,"  %s:   %d\t%s: %d\n  %s:  %d\t%s:     %d\n  %s:   %d\t%s:   %d\n  %s:  %d\t%s: %d\n",
             metabolism_description(METABOLISM_WATER),
-            GET_MT(local_being,METABOLISM_WATER),
+            GET_MT(local_sim, local_being,METABOLISM_WATER),
             metabolism_description(METABOLISM_PROTEIN),
-            GET_MT(local_being,METABOLISM_PROTEIN),
+            GET_MT(local_sim, local_being,METABOLISM_PROTEIN),
             metabolism_description(METABOLISM_STARCH),
-            GET_MT(local_being,METABOLISM_STARCH),
+            GET_MT(local_sim, local_being,METABOLISM_STARCH),
             metabolism_description(METABOLISM_FAT),
-            GET_MT(local_being,METABOLISM_FAT),
+            GET_MT(local_sim, local_being,METABOLISM_FAT),
             metabolism_description(METABOLISM_SUGAR),
-            GET_MT(local_being,METABOLISM_SUGAR),
+            GET_MT(local_sim, local_being,METABOLISM_SUGAR),
             metabolism_description(METABOLISM_BILE),
-            GET_MT(local_being,METABOLISM_BILE),
+            GET_MT(local_sim, local_being,METABOLISM_BILE),
             metabolism_description(METABOLISM_LEPTIN),
-            GET_MT(local_being,METABOLISM_LEPTIN),
+            GET_MT(local_sim, local_being,METABOLISM_LEPTIN),
             metabolism_description(METABOLISM_GHRELIN),
-            GET_MT(local_being,METABOLISM_GHRELIN));
+            GET_MT(local_sim, local_being,METABOLISM_GHRELIN));
     io_string_write(result, str, &watch_string_length);
 
     io_string_write(result, "Liver:\n", &watch_string_length);
     sprintf(str,"  %s: %d\n  %s:  %d\n  %s: %d\n  %s: %d\n  %s: %d\n",
             metabolism_description(METABOLISM_GLUCOGEN),
-            GET_MT(local_being,METABOLISM_GLUCOGEN),
+            GET_MT(local_sim, local_being,METABOLISM_GLUCOGEN),
             metabolism_description(METABOLISM_GLYCOGEN),
-            GET_MT(local_being,METABOLISM_GLYCOGEN),
+            GET_MT(local_sim, local_being,METABOLISM_GLYCOGEN),
             metabolism_description(METABOLISM_ADRENALIN),
-            GET_MT(local_being,METABOLISM_ADRENALIN),
+            GET_MT(local_sim, local_being,METABOLISM_ADRENALIN),
             metabolism_description(METABOLISM_AMMONIA),
-            GET_MT(local_being,METABOLISM_AMMONIA),
+            GET_MT(local_sim, local_being,METABOLISM_AMMONIA),
             metabolism_description(METABOLISM_LACTATE),
-            GET_MT(local_being,METABOLISM_LACTATE));
+            GET_MT(local_sim, local_being,METABOLISM_LACTATE));
     io_string_write(result, str, &watch_string_length);
 
     io_string_write(result, "Kidneys:\n", &watch_string_length);
     sprintf(str,"  %s: %d\n",
             metabolism_description(METABOLISM_UREA),
-            GET_MT(local_being,METABOLISM_UREA));
+            GET_MT(local_sim, local_being,METABOLISM_UREA));
     io_string_write(result, str, &watch_string_length);
 
     io_string_write(result, "Lungs:\n", &watch_string_length);
     sprintf(str,"  %s: %d\n  %s:    %d\n",
             metabolism_description(METABOLISM_OXYGEN),
-            GET_MT(local_being,METABOLISM_OXYGEN),
+            GET_MT(local_sim, local_being,METABOLISM_OXYGEN),
             metabolism_description(METABOLISM_CO2),
-            GET_MT(local_being,METABOLISM_CO2));
+            GET_MT(local_sim, local_being,METABOLISM_CO2));
     io_string_write(result, str, &watch_string_length);
 
     io_string_write(result, "Pancreas:\n", &watch_string_length);
     sprintf(str,"  %s: %d\n  %s: %d\n  %s: %d\n",
             metabolism_description(METABOLISM_FATTY_ACIDS),
-            GET_MT(local_being,METABOLISM_FATTY_ACIDS),
+            GET_MT(local_sim, local_being,METABOLISM_FATTY_ACIDS),
             metabolism_description(METABOLISM_TRIGLYCERIDE),
-            GET_MT(local_being,METABOLISM_TRIGLYCERIDE),
+            GET_MT(local_sim, local_being,METABOLISM_TRIGLYCERIDE),
             metabolism_description(METABOLISM_INSULIN),
-            GET_MT(local_being,METABOLISM_INSULIN));
+            GET_MT(local_sim, local_being,METABOLISM_INSULIN));
     io_string_write(result, str, &watch_string_length);
 
     sprintf(str,"%s: %d\n",
             metabolism_description(METABOLISM_ADIPOSE),
-            GET_MT(local_being,METABOLISM_ADIPOSE));
+            GET_MT(local_sim, local_being,METABOLISM_ADIPOSE));
     io_string_write(result, str, &watch_string_length);
 
     io_string_write(result, "Tissue:\n", &watch_string_length);
     sprintf(str,"  %s: %d   %s: %d\n  %s: %d   %s: %d\n  %s: %d   %s: %d\n  %s: %d   %s: %d\n  %s: %d\n  %s: %d\n",
             metabolism_description(METABOLISM_PROLACTIN),
-            GET_MT(local_being,METABOLISM_PROLACTIN),
+            GET_MT(local_sim, local_being,METABOLISM_PROLACTIN),
             metabolism_description(METABOLISM_MILK),
-            GET_MT(local_being,METABOLISM_MILK),
+            GET_MT(local_sim, local_being,METABOLISM_MILK),
             metabolism_description(METABOLISM_AMINO_ACIDS),
-            GET_MT(local_being,METABOLISM_AMINO_ACIDS),
+            GET_MT(local_sim, local_being,METABOLISM_AMINO_ACIDS),
             metabolism_description(METABOLISM_MUSCLE),
-            GET_MT(local_being,METABOLISM_MUSCLE),
+            GET_MT(local_sim, local_being,METABOLISM_MUSCLE),
             metabolism_description(METABOLISM_GLUCOSE),
-            GET_MT(local_being,METABOLISM_GLUCOSE),
+            GET_MT(local_sim, local_being,METABOLISM_GLUCOSE),
             metabolism_description(METABOLISM_PYRUVATE),
-            GET_MT(local_being,METABOLISM_PYRUVATE),
+            GET_MT(local_sim, local_being,METABOLISM_PYRUVATE),
             metabolism_description(METABOLISM_ADP),
-            GET_MT(local_being,METABOLISM_ADP),
+            GET_MT(local_sim, local_being,METABOLISM_ADP),
             metabolism_description(METABOLISM_ATP),
-            GET_MT(local_being,METABOLISM_ATP),
+            GET_MT(local_sim, local_being,METABOLISM_ATP),
             metabolism_description(METABOLISM_ENERGY),
-            GET_MT(local_being,METABOLISM_ENERGY),
+            GET_MT(local_sim, local_being,METABOLISM_ENERGY),
             metabolism_description(METABOLISM_HEAT),
-            GET_MT(local_being,METABOLISM_HEAT));
+            GET_MT(local_sim, local_being,METABOLISM_HEAT));
     io_string_write(result, str, &watch_string_length);
 #endif
 }
@@ -867,11 +877,12 @@ static void watch_line_braincode(n_string string, n_int line)
  */
 static void watch_braincode(void *ptr, n_string beingname, noble_being * local_being, n_string result)
 {
+    noble_simulation * local_sim = (noble_simulation *) ptr;
     n_int i;
     io_string_write(result, "\nRegisters:\n", &watch_string_length);
     for (i=0; i<BRAINCODE_PSPACE_REGISTERS; i++)
     {
-        result[watch_string_length++]=(char)(65+(local_being->braincode_register[i]%60));
+        result[watch_string_length++]=(char)(65+(GET_BR(local_sim, local_being)[i]%60));
     }
     result[watch_string_length++]='\n';
     result[watch_string_length++]='\n';
@@ -995,6 +1006,8 @@ static void watch_genome(void *ptr, n_string beingname, noble_being * local_bein
  */
 static void watch_brainprobes(void *ptr, n_string beingname, noble_being * local_being, n_string result)
 {
+    noble_simulation * local_sim = (noble_simulation *) ptr;
+    noble_brain_probe * brainprobe = GET_BP(local_sim, local_being);
     n_int i;
     n_string_block str2;
     char type_str[8];
@@ -1010,15 +1023,15 @@ static void watch_brainprobes(void *ptr, n_string beingname, noble_being * local
 
     for (i = 0; i < BRAINCODE_PROBES; i++)
     {
-        if (local_being->brainprobe[i].type == 0)
+        if (brainprobe[i].type == 0)
         {
             sprintf((n_string)str2,"  %s  %03d   %02d   %03d    %03d  %d\n",
                     type_str,
-                    local_being->brainprobe[i].position,
-                    local_being->brainprobe[i].frequency,
-                    local_being->brainprobe[i].offset,
-                    local_being->brainprobe[i].address,
-                    local_being->brainprobe[i].state);
+                    brainprobe[i].position,
+                    brainprobe[i].frequency,
+                    brainprobe[i].offset,
+                    brainprobe[i].address,
+                    brainprobe[i].state);
             io_string_write(result, (n_string)str2, &watch_string_length);
         }
     }
@@ -1027,15 +1040,15 @@ static void watch_brainprobes(void *ptr, n_string beingname, noble_being * local
 
     for (i = 0; i < BRAINCODE_PROBES; i++)
     {
-        if (local_being->brainprobe[i].type == 1)
+        if (brainprobe[i].type == 1)
         {
             sprintf((n_string)str2,"  %s  %03d   %02d   %03d    %03d  %d\n",
                     type_str,
-                    local_being->brainprobe[i].position,
-                    local_being->brainprobe[i].frequency,
-                    local_being->brainprobe[i].offset,
-                    local_being->brainprobe[i].address,
-                    local_being->brainprobe[i].state);
+                    brainprobe[i].position,
+                    brainprobe[i].frequency,
+                    brainprobe[i].offset,
+                    brainprobe[i].address,
+                    brainprobe[i].state);
             io_string_write(result, (n_string)str2, &watch_string_length);
         }
     }
@@ -1063,8 +1076,8 @@ static void watch_stats(void *ptr, n_string beingname, noble_being * local_being
     }
 
 #ifdef METABOLISM_ON
-    heart_rate = GET_MT(local_being,METABOLISM_HEART_RATE)*60/1000;
-    breathing_rate = GET_MT(local_being,METABOLISM_BREATHING_RATE)*60/1000;
+    heart_rate = GET_MT(local_sim, local_being,METABOLISM_HEART_RATE)*60/1000;
+    breathing_rate = GET_MT(local_sim, local_being,METABOLISM_BREATHING_RATE)*60/1000;
 #endif
 
     being_state_description(local_being->state, status);
@@ -1117,7 +1130,7 @@ static n_int console_duplicate(void * ptr, n_string response, n_console_output o
 
     watch_string_length=0;
 
-    if ((response == 0) && local_sim->select != NO_BEINGS_FOUND)
+    if ((response == 0) && (being_selected(local_sim) != 0L))
     {
         response = being_get_select_name(local_sim);
         if (title != 0L)
@@ -1401,10 +1414,9 @@ static void watch_being(void * ptr, n_console_output output_function)
         return;
     }
 
-    if (local_sim->select != NO_BEINGS_FOUND)
+    local_being = being_selected(local_sim);
+    if (local_being != 0L)
     {
-        local_being = &(local_sim->beings[local_sim->select]);
-
         watch_string_length = 0;
 
         switch(watch_type)
@@ -1529,16 +1541,33 @@ n_int console_event(void * ptr, n_string response, n_console_output output_funct
 /**
  * Enable or disable logging
  * @param ptr pointer to noble_simulation object
- * @param response command parameters - off/on/0/1/yes/no
+ * @param response command parameters - off/on/0/1/yes/no, or csv/binary for the indicator log format
  * @param output_function function to be used to display output
  * @return 0
  */
 n_int console_logging(void * ptr, n_string response, n_console_output output_function)
 {
+    noble_simulation * local_sim = (noble_simulation *) ptr;
     n_int return_response = console_on_off(response);
     
     if (return_response == -1)
     {
+        n_int length;
+        if (response == 0)
+        {
+            return 0;
+        }
+        length = io_length(response, STRING_BLOCK_SIZE);
+        if (io_find(response, 0, length, "bin", 3) > -1)
+        {
+            sim_indicators_log_format(local_sim, 1);
+            output_function("Indicators logged in the binary format");
+        }
+        else if (io_find(response, 0, length, "csv", 3) > -1)
+        {
+            sim_indicators_log_format(local_sim, 0);
+            output_function("Indicators logged as CSV");
+        }
         return 0;
     }
     if (return_response == 0)
@@ -1625,7 +1654,7 @@ n_int console_idea(void * ptr, n_string response, n_console_output output_functi
 		histogram[i]=0;
 	}
 
-    if (local_sim->select != NO_BEINGS_FOUND)
+    if (being_selected(local_sim) != 0L)
     {
         n_int loop = 0;
         while (loop < local_sim->num)
@@ -1749,7 +1778,7 @@ n_int console_watch(void * ptr, n_string response, n_console_output output_funct
     }
     else
     {
-        if (local_sim->select != NO_BEINGS_FOUND)
+        if (being_selected(local_sim) != 0L)
         {
             if (io_find(response,0,length,"braincode",9)>-1)
             {
@@ -1896,6 +1925,188 @@ n_int console_interval(void * ptr, n_string response, n_console_output output_fu
     return 0;
 }
 
+/**
+ * Set the number of threads used to cycle the beings
+ * @param ptr pointer to noble_simulation object
+ * @param response command parameters - the number of threads
+ * @param output_function function used to display the output
+ * @return 0
+ */
+n_int console_threads(void * ptr, n_string response, n_console_output output_function)
+{
+    noble_simulation * local_sim = (noble_simulation *) ptr;
+    n_string_block     output;
+
+    if (response != 0)
+    {
+        if (io_length(response, STRING_BLOCK_SIZE) > 0)
+        {
+            n_int number = 0, divisor = 0;
+            if ((io_number(response, &number, &divisor) > -1) && (number >= 0) && (divisor == 0))
+            {
+                sim_threads(local_sim, (n_uint)number);
+            }
+            else
+            {
+                output_function("Number of threads not recognised");
+                return 0;
+            }
+        }
+    }
+
+    if (local_sim->threads == 0)
+    {
+        output_function("Beings cycled without threads");
+    }
+    else
+    {
+        sprintf(output, "Beings cycled with %d thread(s)", (int)local_sim->threads);
+        output_function(output);
+    }
+    return 0;
+}
+
+/**
+ * Set how often the slowly changing phases of the simulation cycle run
+ * @param ptr pointer to noble_simulation object
+ * @param response full, fast, (phase) (minutes) (offset) or nothing to show the schedule
+ * @param output_function function to be used to display output
+ * @return 0
+ */
+n_int console_schedule(void * ptr, n_string response, n_console_output output_function)
+{
+    noble_simulation * local_sim = (noble_simulation *) ptr;
+    n_string_block     output;
+    n_string_block     words[3];
+    n_int              count = 0, characters = 0, loop = 0, length = 0;
+    n_int              phase = 0;
+
+    if (response != 0L)
+    {
+        length = io_length(response, STRING_BLOCK_SIZE);
+    }
+
+    /* the phase, the period and the offset */
+    while ((loop < length) && (count < 3))
+    {
+        if ((response[loop] != ' ') && (characters < (STRING_BLOCK_SIZE - 1)))
+        {
+            words[count][characters++] = response[loop];
+        }
+        if (((response[loop] == ' ') || (loop == (length - 1))) && (characters > 0))
+        {
+            words[count++][characters] = 0;
+            characters = 0;
+        }
+        loop++;
+    }
+
+    if ((count == 1) && (io_find(words[0], 0, 4, "full", 4) > -1))
+    {
+        sim_schedule_profile(&(local_sim->schedule), SCHEDULE_FULL);
+    }
+    else if ((count == 1) && (io_find(words[0], 0, 4, "fast", 4) > -1))
+    {
+        sim_schedule_profile(&(local_sim->schedule), SCHEDULE_FAST);
+    }
+    else if (count > 0)
+    {
+        n_int period = 0, offset = 0, divisor = 0;
+
+        phase = sim_schedule_find(words[0]);
+
+        if ((phase == -1) || (count == 1) ||
+                (io_number(words[1], &period, &divisor) < 0) || (divisor != 0) ||
+                ((count == 3) && ((io_number(words[2], &offset, &divisor) < 0) || (divisor != 0))) ||
+                (period < 1) || (offset < 0))
+        {
+            output_function("Schedule not recognised, examples: schedule fast, schedule weather 4 0");
+            return 0;
+        }
+        if (sim_schedule_set(local_sim, phase, (n_uint)period, (n_uint)offset) != 0)
+        {
+            return 0;
+        }
+    }
+
+    phase = 0;
+    while (phase < SCHEDULE_PHASES)
+    {
+        sprintf(output, "%-11s every %4d min(s) at minute %d", sim_schedule_name(phase),
+                (int)local_sim->schedule.period[phase], (int)local_sim->schedule.offset[phase]);
+        output_function(output);
+        phase++;
+    }
+    return 0;
+}
+
+/**
+ * Time each phase of the simulation cycle
+ * @param ptr pointer to noble_simulation object
+ * @param response on, csv, off or nothing to show the profile
+ * @param output_function function to be used to display output
+ * @return 0
+ */
+n_int console_profile(void * ptr, n_string response, n_console_output output_function)
+{
+    noble_simulation * local_sim = (noble_simulation *) ptr;
+    n_int return_response = console_on_off(response);
+
+    if (return_response == -1)
+    {
+        if ((response != 0) && (io_find(response, 0, io_length(response,STRING_BLOCK_SIZE), "csv", 3) > -1))
+        {
+            sim_profile(local_sim, 1, 1);
+            output_function("Profile turned on with output to profile.csv");
+        }
+        else
+        {
+            sim_profile_output(local_sim, output_function);
+        }
+        return 0;
+    }
+    if (return_response == 0)
+    {
+        sim_profile(local_sim, 0, 0);
+        output_function("Profile turned off");
+    }
+    else
+    {
+        sim_profile(local_sim, 1, 0);
+        output_function("Profile turned on");
+    }
+    return 0;
+}
+
+/**
+ * Publish the indicators, phase timings and population to shared memory
+ * @param ptr pointer to noble_simulation object
+ * @param response on or off
+ * @param output_function function to be used to display output
+ * @return 0
+ */
+n_int console_telemetry(void * ptr, n_string response, n_console_output output_function)
+{
+    noble_simulation * local_sim = (noble_simulation *) ptr;
+    n_int return_response = console_on_off(response);
+
+    if (return_response == -1)
+    {
+        output_function("Telemetry is on or off");
+        return 0;
+    }
+    if (return_response == 0)
+    {
+        (void)sim_telemetry(local_sim, 0);
+        output_function("Telemetry turned off");
+    }
+    else if (sim_telemetry(local_sim, 1) == 0)
+    {
+        output_function("Telemetry published to " TELEMETRY_NAME);
+    }
+    return 0;
+}
+
 n_int console_stop(void * ptr, n_string response, n_console_output output_function)
 {
     simulation_running = 0;
@@ -1918,6 +2129,32 @@ n_int console_file(void * ptr, n_string response, n_console_output output_functi
     return 0;
 }
 
+/* reports finished checkpoints and starts the requested or periodic ones */
+static void console_checkpoint_cycle(noble_simulation * local_sim, n_console_output output_function)
+{
+    n_string_block output;
+
+    if (file_checkpoint_report(local_sim, output) && output_function)
+    {
+        output_function(output);
+    }
+    if (checkpoint_interval_steps != 0)
+    {
+        checkpoint_steps++;
+        if (checkpoint_steps >= checkpoint_interval_steps)
+        {
+            checkpoint_requested = 1;
+        }
+    }
+    /* a checkpoint still being written holds the next one back */
+    if (checkpoint_requested && (file_checkpoint_busy(local_sim, 0) == 0))
+    {
+        checkpoint_requested = 0;
+        checkpoint_steps = 0;
+        (void)file_checkpoint_write(local_sim, checkpoint_file_name);
+    }
+}
+
 /**
  * Run the simulation for a single time interval
  * @param ptr pointer to noble_simulation object
@@ -1953,6 +2190,7 @@ n_int console_step(void * ptr, n_string response, n_console_output output_functi
     {
         sim_cycle();
         watch_being(local_sim, output_function);
+        console_checkpoint_cycle(local_sim, output_function);
         if (local_sim->num == 0)
         {
             simulation_running = 0;
@@ -2114,7 +2352,11 @@ n_int console_speak(void * ptr, n_string response, n_console_output output_funct
 {
     n_string_block paragraph = {0};
     noble_simulation * local_sim = (noble_simulation*) ptr;
-    noble_being * local = &(local_sim->beings[local_sim->select]);
+    noble_being * local = being_selected(local_sim);
+    if (local == 0L)
+    {
+        return 0;
+    }
     watch_speech(ptr, 0L, local, paragraph);
     watch_string_length = 0;
     speak_out(response, paragraph);
@@ -2146,7 +2388,7 @@ n_int console_save(void * ptr, n_string response, n_console_output output_functi
     
     console_stop(ptr,"",output_function);
     
-    file_opened = file_out();
+    file_opened = file_out((noble_simulation *) ptr);
     if (file_opened == 0L)
     {
         return -1;
@@ -2157,7 +2399,7 @@ n_int console_save(void * ptr, n_string response, n_console_output output_functi
     io_disk_write(file_opened, response);
     io_file_free(file_opened);
 
-    if (file_bin_write(response) == -1)
+    if (file_bin_write((noble_simulation *) ptr, response) == -1)
     {
         console_file_interaction = 0;
         return -1;
@@ -2213,14 +2455,14 @@ static n_int console_base_open(void * ptr, n_string response, n_console_output o
         }
         else
         {
-            if (file_in(file_opened) != 0)
+            if (file_in((noble_simulation *) ptr, file_opened) != 0)
             {
                 io_file_free(file_opened);
                 return -1;
             }
             sim_init(KIND_LOAD_FILE, 0, MAP_AREA, 0);
             io_file_free(file_opened);
-            if (file_bin_read(response) == -1)
+            if (file_bin_read((noble_simulation *) ptr, response) == -1)
             {
                 return -1;
             }
@@ -2249,6 +2491,188 @@ n_int console_script(void * ptr, n_string response, n_console_output output_func
     return console_base_open(ptr, response, output_function, 1);
 }
 
+/* save and restore binary snapshots */
+static n_int console_base_snapshot(void * ptr, n_string response, n_console_output output_function, n_byte restore)
+{
+    n_uint         start;
+    n_int          result;
+    n_string_block output_string;
+
+    if (response==0) return 0;
+
+    if (console_file_interaction)
+    {
+        if (output_function)
+        {
+            output_function("File interaction in use");
+        }
+        return 0;
+    }
+
+    console_stop(ptr,"",output_function);
+    console_file_interaction = 1;
+
+    start = io_nanoseconds();
+    if (restore)
+    {
+        result = file_snapshot_read((noble_simulation *) ptr, response);
+        if (result == 0)
+        {
+            sim_world_select((noble_simulation *) ptr, being_selected_index((noble_simulation *) ptr));
+        }
+    }
+    else
+    {
+        result = file_snapshot_write((noble_simulation *) ptr, response);
+    }
+
+    console_file_interaction = 0;
+
+    if (result != 0)
+    {
+        return -1;
+    }
+    if (output_function)
+    {
+        sprintf(console_file_name,"%s",response);
+        sprintf(output_string, "Snapshot file %s %s in %ld ms\n", response,
+                restore ? "open" : "saved", (long)((io_nanoseconds() - start) / 1000000));
+        output_function(output_string);
+    }
+    return 0;
+}
+
+/* save a binary snapshot */
+n_int console_snapshot(void * ptr, n_string response, n_console_output output_function)
+{
+    return console_base_snapshot(ptr, response, output_function, 0);
+}
+
+/* load a binary snapshot */
+n_int console_restore(void * ptr, n_string response, n_console_output output_function)
+{
+    return console_base_snapshot(ptr, response, output_function, 1);
+}
+
+/**
+ * Snapshot the simulation in the background, once or every time interval
+ * @param ptr pointer to noble_simulation object
+ * @param response file name followed by an optional time interval, or off
+ * @param output_function function used to display the output
+ * @return 0 on success, -1 if the checkpoint could not be started
+ */
+n_int console_checkpoint(void * ptr, n_string response, n_console_output output_function)
+{
+    noble_simulation * local_sim = (noble_simulation *) ptr;
+    n_string_block     output;
+    n_int              length = 0, name_length = 0;
+    n_int              number = 0, interval = INTERVAL_DAYS;
+
+    if (response != 0L)
+    {
+        length = io_length(response, STRING_BLOCK_SIZE);
+    }
+
+    if (length <= 0)
+    {
+        if (checkpoint_interval_steps != 0)
+        {
+            sprintf(output, "Checkpoint file %s every %d mins", checkpoint_file_name, (int)checkpoint_interval_steps);
+        }
+        else
+        {
+            sprintf(output, "No periodic checkpoint");
+        }
+        output_function(output);
+        if (file_checkpoint_busy(local_sim, 0))
+        {
+            output_function("Checkpoint being written");
+        }
+        return 0;
+    }
+
+    if (io_find(response, 0, length, "off", 3) > -1)
+    {
+        checkpoint_interval_steps = 0;
+        checkpoint_requested = 0;
+        output_function("Periodic checkpoint off");
+        return 0;
+    }
+
+    while ((name_length < length) && (response[name_length] != ' '))
+    {
+        name_length++;
+    }
+
+    if (name_length >= CHECKPOINT_NAME_SIZE)
+    {
+        (void)SHOW_ERROR("Checkpoint file name too long");
+        return 0;
+    }
+
+    if (name_length < length)
+    {
+        if ((get_time_interval(&response[name_length + 1], &number, &interval) <= -1) || (number <= 0))
+        {
+            (void)SHOW_ERROR("Time not specified, examples: checkpoint run.nap 2 days");
+            return 0;
+        }
+    }
+
+    io_copy((n_byte *)response, (n_byte *)checkpoint_file_name, name_length);
+    checkpoint_file_name[name_length] = 0;
+    checkpoint_steps = 0;
+    checkpoint_interval_steps = number * interval_steps[interval];
+
+    if (checkpoint_interval_steps != 0)
+    {
+        sprintf(output, "Checkpoint file %s every %d %s", checkpoint_file_name, (int)number, interval_description[interval]);
+        output_function(output);
+    }
+
+    /* while running the checkpoint is taken between cycles */
+    if (simulation_executing)
+    {
+        checkpoint_requested = 1;
+        return 0;
+    }
+
+    if (file_checkpoint_write(local_sim, checkpoint_file_name) != 0)
+    {
+        return -1;
+    }
+    (void)file_checkpoint_busy(local_sim, 1);
+    if (file_checkpoint_report(local_sim, output))
+    {
+        output_function(output);
+    }
+    return 0;
+}
+
+/**
+ * Fold the deltas of a checkpoint into its base
+ * @param ptr pointer to noble_simulation object
+ * @param response the name of the checkpoint base
+ * @param output_function function used to display the output
+ * @return 0 on success, -1 on failure
+ */
+n_int console_compact(void * ptr, n_string response, n_console_output output_function)
+{
+    n_string_block output;
+    n_int          folded;
+
+    if (response == 0L) return 0;
+
+    folded = file_checkpoint_compact((noble_simulation *) ptr, response);
+    if (folded < 0)
+    {
+        return -1;
+    }
+    sprintf(output, "Checkpoint file %s compacted, %d deltas folded in", response, (int)folded);
+    output_function(output);
+    return 0;
+}
+
 /**
  * Displays beings in descending order of honor value
  * @param ptr pointer to noble_simulation object
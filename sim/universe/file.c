@@ -41,6 +41,7 @@
 #include "..\noble\noble.h"
 #endif
 
+#include <stdio.h>
 #include "universe.h"
 #include "universe_internal.h"
 
@@ -50,13 +51,25 @@
 #include "..\entity\entity.h"
 #endif
 
+#ifndef	_WIN32
+#include <pthread.h>
+#endif
+
+
+/* the being and its cold parts together, as the file offsets expect them */
+static void file_being_gather(noble_simulation * local_sim, noble_being * local, noble_being_file * gathered)
+{
+    io_copy((n_byte *)local, (n_byte *)&(gathered->being), sizeof(noble_being));
+    io_copy((n_byte *)GET_COLD(local_sim, local), (n_byte *)&(gathered->cold), sizeof(noble_being_cold));
+}
 
 /* does not appear to be used here */
 
-void sim_debug_csv(n_file * fil, n_byte initial)
+void sim_debug_csv(noble_simulation * local_sim, n_file * fil, n_byte initial)
 {
-    noble_simulation * local_sim = sim_sim();
-    io_write_csv(fil, (n_byte *)(&(local_sim->beings[0])), noble_file_format, FIL_BEI, initial);
+    noble_being_file   gathered;
+    file_being_gather(local_sim, &(local_sim->beings[0]), &gathered);
+    io_write_csv(fil, (n_byte *)&gathered, noble_file_format, FIL_BEI, initial);
 }
 
 /* provide an output file buffer to be written */
@@ -75,17 +88,31 @@ static void fileout_land(n_file * file_out, noble_simulation * value, noble_file
 #ifdef USE_FIL_WEA
     io_write_buff(file_out, value->weather, format, FIL_WEA, 0L);
 #endif
+#ifdef USE_FIL_SCH
+    io_write_buff(file_out, &(value->schedule), format, FIL_SCH, 0L);
+#endif
 }
 
+/*
+ the memory written is found through the brain memory location of the being
+ and is read back in the order of the beings. The episodic memory of a being
+ starts a social graph past its location, so each being writes the episodic
+ memory of the being before it, the first being the block before them all.
+ */
 static void fileout_being(n_file * file_out, noble_simulation * value, n_int being, noble_file_entry * format)
 {
-    n_int loop = (SOCIAL_SIZE * being);
+    n_int loop = (SOCIAL_SIZE * value->beings[being].brain_memory_location);
     n_int loop_end = loop + SOCIAL_SIZE;
-    n_int loop_episodic = (EPISODIC_SIZE * being);
-    n_int loop_episodic_end = loop + EPISODIC_SIZE;
-
+    n_int loop_episodic = (being == 0) ? 0 :
+                          ((EPISODIC_SIZE * value->beings[being - 1].brain_memory_location) + SOCIAL_SIZE);
+    n_int loop_episodic_end = loop_episodic + EPISODIC_SIZE;
 #ifdef USE_FIL_BEI
-    io_write_buff(file_out, &(value->beings[being]), format, FIL_BEI, 0L);
+    noble_being_file gathered;
+
+    file_being_gather(value, &(value->beings[being]), &gathered);
+    /* the memory is written in the order of the beings */
+    gathered.being.brain_memory_location = (n_byte2)being;
+    io_write_buff(file_out, &gathered, format, FIL_BEI, 0L);
 #endif
 #ifdef USE_FIL_SOE
     while (loop < loop_end)
@@ -104,9 +131,8 @@ static void fileout_being(n_file * file_out, noble_simulation * value, n_int bei
 }
 
 
-n_file * file_out(void)
+n_file * file_out(noble_simulation * local_sim)
 {
-    noble_simulation *local_sim = sim_sim();
     n_file           *returnFile = io_file_new();
     n_uint	          loop = 0;    
     n_string fluff[5] = {SHORT_VERSION_NAME, FULL_DATE, COPYRIGHT_DATE, COPYRIGHT_NAME, COPYRIGHT_FOLLOW };
@@ -135,53 +161,25 @@ n_file * file_out(void)
     return returnFile;
 }
 
-n_byte * sim_fileout(n_uint * len)
-{
-    noble_simulation *local_sim = sim_sim();
-
-    n_uint	loop = 0;
-    n_file	file_pass;
-
-    n_string fluff[5] = {SHORT_VERSION_NAME, FULL_DATE, COPYRIGHT_DATE, COPYRIGHT_NAME, COPYRIGHT_FOLLOW };
-
-    file_pass . size = 2048;
-    file_pass . location = 0;
-    file_pass . data = io_new(2048);
-    if(file_pass . data == 0L)
-        return 0L;
-
-    io_write_buff(&file_pass, fluff, 0L, FILE_COPYRIGHT, 0L);
-
-    fileout_land(&file_pass, local_sim, (noble_file_entry *)noble_file_format);
-
-    while (loop < local_sim->num)
-    {
-        fileout_being(&file_pass, local_sim, loop, (noble_file_entry *)noble_file_format);
-        loop++;
-    }
-
-    /* TODO: Brain block */
-    
-    * len = file_pass.location;
-    return file_pass.data;
-}
-
-n_int	file_in(n_file * input_file)
+n_int	file_in(noble_simulation * local_sim, n_file * input_file)
 {
     n_int  ret_val;
     n_byte temp_store[LARGEST_INIT_PTR];
     n_uint ape_count = 0;
     n_uint social_count = 0;
     n_uint episodic_count = 0;
-    
-    noble_simulation * local_sim = sim_sim();
+    noble_file_index index;
     
     input_file->size = input_file->location;
     input_file->location = 0;
     
-    io_whitespace(input_file);
+    if (io_file_index(noble_file_format, &index) != 0)
+        return SHOW_ERROR("File format could not be indexed");
     
-    ret_val = io_read_buff(input_file, temp_store, noble_file_format);
+    /* what the file leaves out of each struct is loaded the same every time */
+    io_erase(temp_store, LARGEST_INIT_PTR);
+    
+    ret_val = io_read_buff_index(input_file, temp_store, &index);
     
     if(ret_val != FIL_VER) /* signature must be first */
         return SHOW_ERROR("Signature not first in file");
@@ -196,10 +194,15 @@ n_int	file_in(n_file * input_file)
             return SHOW_ERROR("File newer than Simulation");
     }
     
+#ifdef BRAINCODE_ON
+    /* the social graphs are replaced so none of their braincode stays decoded */
+    brain_braincode_reset(local_sim);
+#endif
+    
     do
     {
         n_byte *temp = 0L;
-        ret_val = io_read_buff(input_file, temp_store, noble_file_format);
+        ret_val = io_read_buff_index(input_file, temp_store, &index);
         if (ret_val == -1)
             SHOW_ERROR("Failure in file load");
         if (ret_val < FILE_EOF)
@@ -215,9 +218,15 @@ n_int	file_in(n_file * input_file)
                     temp = (n_byte*)(local_sim->weather);
                     loop_end = sizeof(n_int);
                     break;
+                case FIL_SCH:
+                    temp = (n_byte*)&(local_sim->schedule);
+                    loop_end = sizeof(noble_schedule);
+                    break;
                 case FIL_BEI:
                     temp = (n_byte*) &(local_sim->beings[ape_count]);
                     loop_end = sizeof(noble_being);
+                    /* the memory is read in the order of the beings */
+                    io_copy(&temp_store[sizeof(noble_being)], (n_byte *)&(local_sim->cold_base[ape_count]), sizeof(noble_being_cold));
                     break;
                 case FIL_SOE:
                     temp = (n_byte*) &(local_sim->social_base[social_count]);
@@ -235,8 +244,13 @@ n_int	file_in(n_file * input_file)
             {
                 io_copy(temp_store, temp, loop_end);
             }
+            if (ret_val == FIL_SCH)
+            {
+                sim_schedule_check(&(local_sim->schedule));
+            }
             if (ret_val == FIL_BEI)
             {
+                local_sim->beings[ape_count].brain_memory_location = (n_byte2)ape_count;
                 ape_count ++;
                 if (ape_count == local_sim->max)
                 {
@@ -264,242 +278,1148 @@ n_int	file_in(n_file * input_file)
             }
             
         }
-        
+        
+    }
+    while (ret_val < FILE_EOF);
+    
+    if (ret_val == FILE_EOF)
+    {
+        local_sim->num = ape_count;
+        return 0;
+    }
+    return SHOW_ERROR("Process file failed");
+}
+
+/*
+ read:
+ io_disk_check
+ file_chain_new
+ add pointers to "to be read"
+ file_chain_read_header
+ file_chain_read_validate
+ file_chain_read
+ file_chain_free
+ */
+n_int file_bin_read(noble_simulation * local, n_string name)
+{
+    n_file_chain     * start = 0L;
+    /* weather, brain, social, episodic */
+    const n_uint       total_ptrs = 2;
+    n_string_block     bin_name;
+    
+    file_chain_bin_name(name, bin_name);
+    
+    if (io_disk_check(name) != 1)
+    {
+        return -1; /* This is legit for no output error */
+    }
+   
+    start = file_chain_new(total_ptrs);
+    
+    if (start == 0L)
+    {
+        return SHOW_ERROR("Header not allocated");
+    }
+    
+    start[1].expected_bytes = sizeof(n_weather);
+    start[1].data           = local->weather;
+    
+    start[2].expected_bytes = local->num * DOUBLE_BRAIN;
+    start[2].data           = local->brain_base;
+    
+    if (file_chain_read_header(bin_name, start, total_ptrs) != 0)
+    {
+        file_chain_free(start);
+        return -1; /* Error already out */
+    }
+    
+    if (file_chain_read_validate(bin_name, start) != 0)
+    {
+        file_chain_free(start);
+        return -1; /* Error already out */
+    }
+    if (file_chain_read(bin_name, start) != 0)
+    {
+        file_chain_free(start);
+        return -1; /* Error already out */
+    }
+    
+    file_chain_free(start);
+    return 0;
+}
+
+/*
+ write:
+ file_chain_new
+ add pointers to "to be written"
+ file_chain_write_generate_header
+ file_chain_write
+ file_chain_free
+ */
+
+/* the brains in the order of the beings, they are copied out only if beings have died */
+static n_byte * file_bin_brains(noble_simulation * local, n_byte ** copy)
+{
+    n_uint loop = 0;
+
+    *copy = 0L;
+    while ((loop < local->num) &&
+           ((local->beings[loop].brain_memory_location == loop) ||
+            (local->beings[loop].brain_memory_location == NO_BRAIN_MEMORY_LOCATION)))
+    {
+        loop++;
+    }
+    if (loop == local->num)
+    {
+        return local->brain_base;
+    }
+    *copy = (n_byte *)io_new(local->num * DOUBLE_BRAIN);
+    if (*copy == 0L)
+    {
+        return 0L;
+    }
+    loop = 0;
+    while (loop < local->num)
+    {
+        io_copy(GET_B(local, &(local->beings[loop])), &((*copy)[loop * DOUBLE_BRAIN]), DOUBLE_BRAIN);
+        loop++;
+    }
+    return *copy;
+}
+
+n_int file_bin_write(noble_simulation * local, n_string name)
+{
+    n_file_chain     * start = 0L;
+    n_byte           * brains_copy = 0L;
+    /* weather, brain, social, episodic */
+    const n_uint       total_ptrs = 2;
+    n_string_block     bin_name;
+    
+    file_chain_bin_name(name, bin_name);
+    
+    start = file_chain_new(total_ptrs);
+    
+    if (start == 0L)
+    {
+        return SHOW_ERROR("Header not allocated");
+    }
+    
+    start[1].expected_bytes = sizeof(n_weather);
+    start[1].data           = local->weather;
+    
+    start[2].expected_bytes = local->num * DOUBLE_BRAIN;
+    start[2].data           = file_bin_brains(local, &brains_copy);
+    
+    if (start[2].data == 0L)
+    {
+        file_chain_free(start);
+        return SHOW_ERROR("Brains not copied");
+    }
+    
+    if (file_chain_write_generate_header(start) != 0)
+    {
+        file_chain_free(start);
+        io_free(brains_copy);
+        return -1; /* Error already out */
+    }
+    
+    if (file_chain_write(bin_name, start) != 0)
+    {
+        file_chain_free(start);
+        io_free(brains_copy);
+        return -1; /* Error already out */
+    }
+    file_chain_free(start);
+    io_free(brains_copy);
+    return 0;
+}
+
+
+/*
+ snapshot:
+ the whole simulation as its memory blocks, see io_snapshot_write
+ */
+
+#define SNAPSHOT_COUNT  (10)
+
+/* checkpoint deltas hold runs of changed bytes, shorter unchanged gaps than this stay in the run */
+#define CHECKPOINT_RUN_GAP      (2 * sizeof(n_c_uint))
+
+static void file_snapshot_section(n_snapshot_section * section, n_c_uint id, void * data, n_uint element_bytes, n_uint elements)
+{
+    section->id = id;
+    section->element_bytes = (n_c_uint)element_bytes;
+    section->bytes = element_bytes * elements;
+    section->data = data;
+}
+
+/* the sections point at the simulation, the simulation section at the structure passed in */
+static n_uint file_snapshot_sections(noble_simulation * local_sim, n_snapshot_section * sections, noble_snapshot_simulation * simulation)
+{
+    n_uint count = 0;
+    /* the memory of the beings alive can be past num after some have died */
+    n_uint locations = being_locations(local_sim);
+
+    io_erase((n_byte *)simulation, sizeof(noble_snapshot_simulation));
+    simulation->num = local_sim->num;
+    simulation->max = local_sim->max;
+    simulation->select = being_selected_index(local_sim);
+    simulation->indicator_index = local_sim->indicator_index;
+    io_copy((n_byte *)&(local_sim->schedule), (n_byte *)&(simulation->schedule), sizeof(noble_schedule));
+
+    file_snapshot_section(&sections[count++], SNAPSHOT_SIMULATION, simulation, sizeof(noble_snapshot_simulation), 1);
+    file_snapshot_section(&sections[count++], SNAPSHOT_LAND, local_sim->land, sizeof(n_land), 1);
+    file_snapshot_section(&sections[count++], SNAPSHOT_MAP, local_sim->land->map, 1, MAP_AREA);
+    file_snapshot_section(&sections[count++], SNAPSHOT_WEATHER, local_sim->weather, sizeof(n_weather), 1);
+    file_snapshot_section(&sections[count++], SNAPSHOT_BEINGS, local_sim->beings, sizeof(noble_being), local_sim->num);
+    file_snapshot_section(&sections[count++], SNAPSHOT_COLD, local_sim->cold_base, sizeof(noble_being_cold), locations);
+    file_snapshot_section(&sections[count++], SNAPSHOT_SOCIAL, local_sim->social_base, SOCIAL_SIZE * sizeof(social_link), locations);
+    file_snapshot_section(&sections[count++], SNAPSHOT_EPISODIC, local_sim->episodic_base, EPISODIC_SIZE * sizeof(episodic_memory), locations);
+#ifdef BRAIN_ON
+    file_snapshot_section(&sections[count++], SNAPSHOT_BRAIN, local_sim->brain_base, DOUBLE_BRAIN, locations);
+#endif
+    file_snapshot_section(&sections[count++], SNAPSHOT_INDICATORS, local_sim->indicators_base, sizeof(noble_indicators), INDICATORS_BUFFER_SIZE);
+
+    return count;
+}
+
+/**
+ * Writes the simulation as a binary snapshot.
+ * @param local_sim The simulation to write.
+ * @param name The name of the snapshot file.
+ * @return 0 on success, -1 on failure.
+ */
+n_int file_snapshot_write(noble_simulation * local_sim, n_string name)
+{
+    n_snapshot_section        sections[SNAPSHOT_COUNT];
+    noble_snapshot_simulation simulation;
+    n_uint                    count = file_snapshot_sections(local_sim, sections, &simulation);
+
+    return io_snapshot_write(name, sections, count);
+}
+
+/* the section has to be there and made of the same structures as this build */
+static n_snapshot_section * file_snapshot_expect(n_snapshot * snapshot, n_c_uint id, n_uint element_bytes, n_uint elements)
+{
+    n_snapshot_section * section = io_snapshot_find(snapshot, id);
+    if ((section == 0L) || (section->element_bytes != element_bytes) || (section->bytes != (element_bytes * elements)))
+    {
+        return 0L;
+    }
+    return section;
+}
+
+/* the snapshot is checked completely before any of the simulation is changed */
+static n_int file_snapshot_apply(noble_simulation * local_sim, n_snapshot * snapshot)
+{
+    n_snapshot_section        * section[SNAPSHOT_COUNT];
+    noble_snapshot_simulation * simulation;
+    n_land                    * land;
+    noble_being               * beings;
+    n_snapshot_section        * social;
+    n_byte                    * used;
+    n_uint                      num, locations = 0, loop = 0;
+
+    section[0] = file_snapshot_expect(snapshot, SNAPSHOT_SIMULATION, sizeof(noble_snapshot_simulation), 1);
+    if (section[0] == 0L)
+    {
+        return SHOW_ERROR("Snapshot from a different build");
+    }
+    simulation = (noble_snapshot_simulation *)section[0]->data;
+    num = simulation->num;
+    if (num > local_sim->max)
+    {
+        return SHOW_ERROR("Snapshot has too many apes");
+    }
+
+    section[1] = file_snapshot_expect(snapshot, SNAPSHOT_LAND, sizeof(n_land), 1);
+    section[2] = file_snapshot_expect(snapshot, SNAPSHOT_MAP, 1, MAP_AREA);
+    section[3] = file_snapshot_expect(snapshot, SNAPSHOT_WEATHER, sizeof(n_weather), 1);
+    section[4] = file_snapshot_expect(snapshot, SNAPSHOT_BEINGS, sizeof(noble_being), num);
+    /* the memory of the beings is for as many locations as the beings used */
+    social = io_snapshot_find(snapshot, SNAPSHOT_SOCIAL);
+    if (social != 0L)
+    {
+        locations = social->bytes / (SOCIAL_SIZE * sizeof(social_link));
+    }
+    if ((locations < num) || (locations > local_sim->max))
+    {
+        return SHOW_ERROR("Snapshot ape memory does not fit");
+    }
+    section[5] = file_snapshot_expect(snapshot, SNAPSHOT_SOCIAL, SOCIAL_SIZE * sizeof(social_link), locations);
+    section[6] = file_snapshot_expect(snapshot, SNAPSHOT_EPISODIC, EPISODIC_SIZE * sizeof(episodic_memory), locations);
+    section[7] = file_snapshot_expect(snapshot, SNAPSHOT_INDICATORS, sizeof(noble_indicators), INDICATORS_BUFFER_SIZE);
+    section[9] = file_snapshot_expect(snapshot, SNAPSHOT_COLD, sizeof(noble_being_cold), locations);
+#ifdef BRAIN_ON
+    section[8] = file_snapshot_expect(snapshot, SNAPSHOT_BRAIN, DOUBLE_BRAIN, locations);
+#else
+    section[8] = section[0];
+#endif
+    while (loop < SNAPSHOT_COUNT)
+    {
+        if (section[loop++] == 0L)
+        {
+            return SHOW_ERROR("Snapshot from a different build");
+        }
+    }
+
+    /* the memory of each ape is found through its brain memory location, no two apes share one */
+    beings = (noble_being *)section[4]->data;
+    used = (n_byte *)io_new(locations + 1);
+    if (used == 0L)
+    {
+        return SHOW_ERROR("Snapshot check not allocated");
+    }
+    io_erase(used, locations + 1);
+    loop = 0;
+    while (loop < num)
+    {
+        n_uint location = beings[loop].brain_memory_location;
+        if ((location != NO_BRAIN_MEMORY_LOCATION) && ((location >= locations) || used[location]))
+        {
+            io_free(used);
+            return SHOW_ERROR("Snapshot ape memory outside the snapshot");
+        }
+        if (location != NO_BRAIN_MEMORY_LOCATION)
+        {
+            used[location] = 1;
+        }
+        loop++;
+    }
+    io_free(used);
+
+    land = (n_land *)section[1]->data;
+    local_sim->land->time = land->time;
+    local_sim->land->date[0] = land->date[0];
+    local_sim->land->date[1] = land->date[1];
+    local_sim->land->genetics[0] = land->genetics[0];
+    local_sim->land->genetics[1] = land->genetics[1];
+    local_sim->land->tide_level = land->tide_level;
+    io_copy((n_byte *)section[2]->data, local_sim->land->map, MAP_AREA);
+    food_map_rebuild(local_sim);
+    being_water_rebuild(local_sim);
+#ifndef SMALL_LAND
+    sim_tide_block(local_sim->land->map, local_sim->highres, local_sim->highres_tide);
+#endif
+    io_copy((n_byte *)section[3]->data, (n_byte *)local_sim->weather, section[3]->bytes);
+    io_copy((n_byte *)section[4]->data, (n_byte *)local_sim->beings, section[4]->bytes);
+    io_copy((n_byte *)section[5]->data, (n_byte *)local_sim->social_base, section[5]->bytes);
+    io_copy((n_byte *)section[6]->data, (n_byte *)local_sim->episodic_base, section[6]->bytes);
+    io_copy((n_byte *)section[7]->data, (n_byte *)local_sim->indicators_base, section[7]->bytes);
+    io_copy((n_byte *)section[9]->data, (n_byte *)local_sim->cold_base, section[9]->bytes);
+#ifdef BRAIN_ON
+    io_copy((n_byte *)section[8]->data, local_sim->brain_base, section[8]->bytes);
+#endif
+
+    local_sim->num = num;
+    being_slots_rebuild(local_sim, 0);
+    being_select(local_sim, (simulation->select < num) ? simulation->select : 0);
+    local_sim->indicator_index = simulation->indicator_index % INDICATORS_BUFFER_SIZE;
+    io_copy((n_byte *)&(simulation->schedule), (n_byte *)&(local_sim->schedule), sizeof(noble_schedule));
+    sim_schedule_check(&(local_sim->schedule));
+
+    /* the beings are replaced so the indexes are stale */
+    local_sim->space_num = NO_BEINGS_FOUND;
+    local_sim->index_num = NO_BEINGS_FOUND;
+    if (local_sim->brain_rest != 0L)
+    {
+        io_erase((n_byte *)local_sim->brain_rest, local_sim->max * sizeof(noble_brain_rest));
+    }
+#ifdef BRAINCODE_ON
+    brain_braincode_reset(local_sim);
+#endif
+
+    return 0;
+}
+
+
+/* room left after a checkpoint name for the sequence of a delta */
+#define SNAPSHOT_DELTA_SUFFIX (24)
+
+/* the name of a checkpoint delta, names that leave no room for the sequence are refused */
+static n_int file_snapshot_delta_name(n_string name, n_uint sequence, n_string delta_name)
+{
+    char   suffix[SNAPSHOT_DELTA_SUFFIX];
+    n_int  length = io_length(name, STRING_BLOCK_SIZE);
+
+    if ((length < 0) || (length > (STRING_BLOCK_SIZE - SNAPSHOT_DELTA_SUFFIX)))
+    {
+        return SHOW_ERROR("Checkpoint file name too long");
+    }
+    sprintf(suffix, ".%ld", (long)sequence);
+    io_copy((n_byte *)name, (n_byte *)delta_name, (n_uint)length);
+    io_copy((n_byte *)suffix, (n_byte *)&delta_name[length], (n_uint)io_length(suffix, SNAPSHOT_DELTA_SUFFIX) + 1);
+    return 0;
+}
+
+/* the sections of a snapshot that are replayed are copied out of the file */
+static n_int file_snapshot_writable(n_snapshot_section * section, n_byte ** copy, n_uint bytes)
+{
+    n_byte * replacement;
+
+    if ((*copy != 0L) && (bytes <= section->bytes))
+    {
+        section->bytes = bytes;
+        return 0;
+    }
+    replacement = (n_byte *)io_new(bytes + 1);
+    if (replacement == 0L)
+    {
+        return SHOW_ERROR("Snapshot replay not allocated");
+    }
+    io_erase(replacement, bytes);
+    io_copy((n_byte *)section->data, replacement, (section->bytes < bytes) ? section->bytes : bytes);
+    if (*copy != 0L)
+    {
+        io_free(*copy);
+    }
+    *copy = replacement;
+    section->data = replacement;
+    section->bytes = bytes;
+    return 0;
+}
+
+/* a delta section is its size, the number of runs, the offset and length of each run and then the runs */
+static n_int file_snapshot_delta_apply(n_snapshot * snapshot, n_snapshot_section * delta, n_byte ** copies)
+{
+    n_uint             * header = (n_uint *)delta->data;
+    n_snapshot_section * section = io_snapshot_find(snapshot, delta->id & (SNAPSHOT_DELTA - 1));
+    n_uint               bytes, runs, used, loop = 0;
+    n_c_uint           * run;
+    n_byte             * run_data;
+
+    if ((section == 0L) || (section->element_bytes != delta->element_bytes) || (delta->bytes < (2 * sizeof(n_uint))))
+    {
+        return SHOW_ERROR("Checkpoint delta from a different build");
+    }
+    bytes = header[0];
+    runs = header[1];
+    if (runs > ((delta->bytes - (2 * sizeof(n_uint))) / (2 * sizeof(n_c_uint))))
+    {
+        return SHOW_ERROR("Checkpoint delta size wrong");
+    }
+    if (file_snapshot_writable(section, &copies[section - snapshot->section], bytes) != 0)
+    {
+        return -1;
+    }
+    run = (n_c_uint *)&header[2];
+    run_data = (n_byte *)&run[2 * runs];
+    used = (n_uint)(run_data - (n_byte *)header);
+    while (loop < runs)
+    {
+        n_uint offset = run[(2 * loop)];
+        n_uint length = run[(2 * loop) + 1];
+        if ((offset > bytes) || (length > (bytes - offset)) || (length > (delta->bytes - used)))
+        {
+            return SHOW_ERROR("Checkpoint delta run outside the section");
+        }
+        io_copy(run_data, &((n_byte *)section->data)[offset], length);
+        run_data += length;
+        used += length;
+        loop++;
+    }
+    if (used != delta->bytes)
+    {
+        return SHOW_ERROR("Checkpoint delta size wrong");
+    }
+    return 0;
+}
+
+/**
+ * Replays the deltas that follow a checkpoint base onto its sections. The
+ * replay stops at the first missing delta or a delta from another chain.
+ * @param snapshot The open base, its sections are changed to the replayed copies.
+ * @param name The name of the base.
+ * @param copies The copies made, to be freed after the snapshot is used.
+ * @return The number of deltas replayed or -1 on failure.
+ */
+static n_int file_snapshot_replay(n_snapshot * snapshot, n_string name, n_byte ** copies)
+{
+    n_snapshot_section   * section = io_snapshot_find(snapshot, SNAPSHOT_CHAIN);
+    noble_snapshot_chain * chain;
+    n_string_block         delta_name;
+    n_int                  replayed = 0;
+
+    if ((section == 0L) || (section->bytes != sizeof(noble_snapshot_chain)))
+    {
+        return 0;
+    }
+    chain = (noble_snapshot_chain *)section->data;
+
+    while (1)
+    {
+        n_snapshot             delta;
+        noble_snapshot_chain * delta_chain;
+        n_uint                 loop = 0;
+
+        if (file_snapshot_delta_name(name, chain->sequence + 1, delta_name) != 0)
+        {
+            return -1;
+        }
+        if (io_disk_check(delta_name) == 0)
+        {
+            return replayed;
+        }
+        if (io_snapshot_open(delta_name, &delta, 1) != 0)
+        {
+            return -1;
+        }
+        section = io_snapshot_find(&delta, SNAPSHOT_CHAIN);
+        delta_chain = (section != 0L) ? (noble_snapshot_chain *)section->data : 0L;
+        if ((delta_chain == 0L) || (section->bytes != sizeof(noble_snapshot_chain)) ||
+            (delta_chain->chain != chain->chain) || (delta_chain->sequence != (chain->sequence + 1)))
+        {
+            /* left over from an earlier chain */
+            io_snapshot_close(&delta);
+            return replayed;
+        }
+        while (loop < delta.count)
+        {
+            if (delta.section[loop].id & SNAPSHOT_DELTA)
+            {
+                if (file_snapshot_delta_apply(snapshot, &delta.section[loop], copies) != 0)
+                {
+                    io_snapshot_close(&delta);
+                    return -1;
+                }
+            }
+            loop++;
+        }
+        section = io_snapshot_find(snapshot, SNAPSHOT_CHAIN);
+        if (file_snapshot_writable(section, &copies[section - snapshot->section], sizeof(noble_snapshot_chain)) != 0)
+        {
+            io_snapshot_close(&delta);
+            return -1;
+        }
+        chain = (noble_snapshot_chain *)section->data;
+        chain->sequence = delta_chain->sequence;
+        io_snapshot_close(&delta);
+        replayed++;
+    }
+}
+
+static void file_snapshot_replay_free(n_byte ** copies)
+{
+    n_uint loop = 0;
+    while (loop < SNAPSHOT_SECTIONS_MAX)
+    {
+        if (copies[loop] != 0L)
+        {
+            io_free(copies[loop]);
+            copies[loop] = 0L;
+        }
+        loop++;
+    }
+}
+
+/**
+ * Replaces the simulation with a binary snapshot. A checkpoint base has its
+ * deltas replayed on to it first.
+ * @param local_sim The simulation to replace.
+ * @param name The name of the snapshot file.
+ * @return 0 on success, -1 on failure.
+ */
+n_int file_snapshot_read(noble_simulation * local_sim, n_string name)
+{
+    n_snapshot snapshot;
+    n_byte   * copies[SNAPSHOT_SECTIONS_MAX] = {0L};
+    n_int      result = -1;
+
+    if (io_snapshot_open(name, &snapshot, 1) != 0)
+    {
+        return -1;
+    }
+    if (file_snapshot_replay(&snapshot, name, copies) > -1)
+    {
+        result = file_snapshot_apply(local_sim, &snapshot);
+    }
+    file_snapshot_replay_free(copies);
+    io_snapshot_close(&snapshot);
+    return result;
+}
+
+/*
+ checkpoint:
+ the snapshot sections are copied between cycles and a background thread
+ writes the copy while the simulation keeps cycling
+ */
+
+enum
+{
+    CHECKPOINT_IDLE = 0,
+    CHECKPOINT_COPYING,
+    CHECKPOINT_WRITING,
+    CHECKPOINT_DONE
+};
+
+/*! @struct
+ @field sections The sections of the checkpoint being written, pointing into its copy.
+ @field simulation The simulation section of the copy.
+ @field count The number of sections.
+ @field buffer The copies alternate so the last checkpoint written is kept to compare against.
+ @field buffer_bytes The space in each copy.
+ @field last The copy of the last checkpoint written.
+ @field name The file being written, then the file written.
+ @field start When the checkpoint started, in nanoseconds.
+ @field copy How long the simulation was held for the copy.
+ @field end When the checkpoint was written.
+ @field result How the write went.
+ @field state One of the CHECKPOINT states, shared with the writer thread.
+ @field chain_name The base of the chain being written.
+ @field chain The chain and sequence of the last checkpoint in it.
+ @field previous The sections of the last checkpoint in the chain.
+ @field delta The delta sections kept between checkpoints.
+ @field delta_bytes The space for the delta sections.
+ @field written The bytes written.
+ @discussion Each simulation has its own checkpoint so the writers of different
+ simulations can be busy at the same time.
+ */
+struct noble_checkpoint
+{
+    n_snapshot_section        sections[SNAPSHOT_COUNT];
+    noble_snapshot_simulation simulation;
+    n_uint                    count;
+
+    n_byte                  * buffer[2];
+    n_uint                    buffer_bytes[2];
+    n_byte                    last;
+
+    n_string_block            name;
+    n_uint                    start;
+    n_uint                    copy;
+    n_uint                    end;
+    n_int                     result;
+    n_byte                    state;
+
+#ifndef	_WIN32
+    pthread_mutex_t           mtx;
+    pthread_cond_t            cond;
+#endif
+
+    n_string_block            chain_name;
+    noble_snapshot_chain      chain;
+    n_snapshot_section        previous[SNAPSHOT_COUNT];
+
+    n_byte                  * delta;
+    n_uint                    delta_bytes;
+    n_uint                    written;
+};
+
+#ifndef	_WIN32
+
+#define CHECKPOINT_LOCK(cp)      pthread_mutex_lock(&((cp)->mtx))
+#define CHECKPOINT_UNLOCK(cp)    pthread_mutex_unlock(&((cp)->mtx))
+
+#else
+
+#define CHECKPOINT_LOCK(cp)
+#define CHECKPOINT_UNLOCK(cp)
+
+#endif
+
+/**
+ * Makes the checkpoint state of a simulation.
+ * @return The checkpoint state or 0L if there is not the memory for it.
+ */
+noble_checkpoint * file_checkpoint_new(void)
+{
+    noble_checkpoint * local_checkpoint = (noble_checkpoint *)io_new(sizeof(noble_checkpoint));
+    if (local_checkpoint == 0L)
+    {
+        return 0L;
+    }
+    io_erase((n_byte *)local_checkpoint, sizeof(noble_checkpoint));
+#ifndef	_WIN32
+    pthread_mutex_init(&(local_checkpoint->mtx), NULL);
+    pthread_cond_init(&(local_checkpoint->cond), NULL);
+#endif
+    return local_checkpoint;
+}
+
+/* grows a buffer kept between checkpoints */
+static n_int checkpoint_space(n_byte ** buffer, n_uint * space, n_uint bytes)
+{
+    if (bytes <= *space)
+    {
+        return 0;
+    }
+    if (*buffer != 0L)
+    {
+        io_free(*buffer);
+    }
+    *space = 0;
+    *buffer = (n_byte *)io_new(bytes);
+    if (*buffer == 0L)
+    {
+        return SHOW_ERROR("Not enough memory for checkpoint");
+    }
+    *space = bytes;
+    return 0;
+}
+
+/* finds the runs of a section that differ from the last checkpoint, only counting them without a run table */
+static n_uint checkpoint_runs(n_snapshot_section * previous, n_snapshot_section * section,
+                              n_c_uint * run, n_byte * run_data, n_uint * run_bytes)
+{
+    n_byte * before = (n_byte *)previous->data;
+    n_byte * after = (n_byte *)section->data;
+    n_uint   bytes = section->bytes;
+    n_uint   compare = (previous->bytes < bytes) ? previous->bytes : bytes;
+    n_uint   loop = 0, runs = 0;
+
+    *run_bytes = 0;
+    while (loop < bytes)
+    {
+        n_uint start, length, same = 0;
+
+        while ((loop < compare) && (before[loop] == after[loop]))
+        {
+            loop++;
+        }
+        if (loop == bytes)
+        {
+            break;
+        }
+        start = loop;
+        while ((loop < bytes) && (same < CHECKPOINT_RUN_GAP))
+        {
+            if ((loop < compare) && (before[loop] == after[loop]))
+            {
+                same++;
+            }
+            else
+            {
+                same = 0;
+            }
+            loop++;
+        }
+        length = loop - start - same;
+        if (run != 0L)
+        {
+            run[(2 * runs)] = (n_c_uint)start;
+            run[(2 * runs) + 1] = (n_c_uint)length;
+            io_copy(&after[start], &run_data[*run_bytes], length);
+        }
+        *run_bytes += length;
+        runs++;
+    }
+    return runs;
+}
+
+/* builds the delta sections of the runs that changed since the last checkpoint */
+static n_int checkpoint_delta_sections(noble_checkpoint * local_checkpoint, n_snapshot_section * sections)
+{
+    n_uint   runs[SNAPSHOT_COUNT], run_bytes[SNAPSHOT_COUNT];
+    n_uint   loop = 0, bytes = 0;
+    n_byte * location;
+
+    while (loop < local_checkpoint->count)
+    {
+        runs[loop] = checkpoint_runs(&local_checkpoint->previous[loop], &local_checkpoint->sections[loop], 0L, 0L, &run_bytes[loop]);
+        sections[loop].bytes = (2 * sizeof(n_uint)) + (runs[loop] * 2 * sizeof(n_c_uint)) + run_bytes[loop];
+        /* each section starts on an n_uint */
+        bytes += (sections[loop].bytes + sizeof(n_uint) - 1) & ~(sizeof(n_uint) - 1);
+        loop++;
+    }
+    if (checkpoint_space(&local_checkpoint->delta, &local_checkpoint->delta_bytes, bytes) != 0)
+    {
+        return -1;
+    }
+
+    location = local_checkpoint->delta;
+    loop = 0;
+    while (loop < local_checkpoint->count)
+    {
+        n_uint   * header = (n_uint *)location;
+        n_c_uint * run = (n_c_uint *)&header[2];
+
+        header[0] = local_checkpoint->sections[loop].bytes;
+        header[1] = runs[loop];
+        (void)checkpoint_runs(&local_checkpoint->previous[loop], &local_checkpoint->sections[loop], run, (n_byte *)&run[2 * runs[loop]], &run_bytes[loop]);
+
+        sections[loop].id = local_checkpoint->sections[loop].id | SNAPSHOT_DELTA;
+        sections[loop].element_bytes = local_checkpoint->sections[loop].element_bytes;
+        sections[loop].data = location;
+        location += (sections[loop].bytes + sizeof(n_uint) - 1) & ~(sizeof(n_uint) - 1);
+        loop++;
+    }
+    return 0;
+}
+
+/* removes the deltas after a sequence until one is missing */
+static void checkpoint_remove_deltas(n_string name, n_uint sequence)
+{
+    n_string_block delta_name;
+    do
+    {
+        if (file_snapshot_delta_name(name, ++sequence, delta_name) != 0)
+        {
+            return;
+        }
+    }
+    while (remove(delta_name) == 0);
+}
+
+/*
+ The first checkpoint to a name is a base with a new chain, the ones after
+ are deltas against the checkpoint before, named base.1, base.2 and so on.
+ */
+static n_int checkpoint_write_chain(noble_checkpoint * local_checkpoint)
+{
+    n_snapshot_section   sections[SNAPSHOT_COUNT + 1];
+    noble_snapshot_chain chain;
+    n_string_block       delta_name;
+    n_uint               loop = 0;
+    n_byte               delta = (local_checkpoint->chain_name[0] != 0) &&
+                                 (io_length(local_checkpoint->chain_name, STRING_BLOCK_SIZE) == io_length(local_checkpoint->name, STRING_BLOCK_SIZE)) &&
+                                 io_same((n_byte *)local_checkpoint->chain_name, (n_byte *)local_checkpoint->name, io_length(local_checkpoint->name, STRING_BLOCK_SIZE));
+
+    if (delta)
+    {
+        if (checkpoint_delta_sections(local_checkpoint, sections) != 0)
+        {
+            return -1;
+        }
+        chain.chain = local_checkpoint->chain.chain;
+        chain.sequence = local_checkpoint->chain.sequence + 1;
+    }
+    else
+    {
+        io_copy((n_byte *)local_checkpoint->sections, (n_byte *)sections, local_checkpoint->count * sizeof(n_snapshot_section));
+        chain.chain = io_nanoseconds() ^ math_hash((n_byte *)local_checkpoint->sections[1].data, local_checkpoint->sections[1].bytes);
+        chain.sequence = 0;
+    }
+    sections[local_checkpoint->count].id = SNAPSHOT_CHAIN;
+    sections[local_checkpoint->count].element_bytes = sizeof(noble_snapshot_chain);
+    sections[local_checkpoint->count].bytes = sizeof(noble_snapshot_chain);
+    sections[local_checkpoint->count].data = &chain;
+
+    if (delta)
+    {
+        if (file_snapshot_delta_name(local_checkpoint->name, chain.sequence, delta_name) != 0)
+        {
+            return -1;
+        }
     }
-    while (ret_val < FILE_EOF);
-    
-    if (ret_val == FILE_EOF)
+    else
     {
-        local_sim->num = ape_count;
-        return 0;
+        io_copy((n_byte *)local_checkpoint->name, (n_byte *)delta_name, STRING_BLOCK_SIZE);
     }
-    return SHOW_ERROR("Process file failed");
+    if (io_snapshot_write(delta_name, sections, local_checkpoint->count + 1) != 0)
+    {
+        return -1;
+    }
+    if (delta == 0)
+    {
+        checkpoint_remove_deltas(local_checkpoint->name, 0);
+        io_copy((n_byte *)local_checkpoint->name, (n_byte *)local_checkpoint->chain_name, STRING_BLOCK_SIZE);
+    }
+
+    /* the report gives the file written */
+    io_copy((n_byte *)delta_name, (n_byte *)local_checkpoint->name, STRING_BLOCK_SIZE);
+    local_checkpoint->written = 0;
+    while (loop <= local_checkpoint->count)
+    {
+        local_checkpoint->written += sections[loop++].bytes;
+    }
+    local_checkpoint->chain = chain;
+    io_copy((n_byte *)local_checkpoint->sections, (n_byte *)local_checkpoint->previous, local_checkpoint->count * sizeof(n_snapshot_section));
+    local_checkpoint->last = (n_byte)(1 - local_checkpoint->last);
+    return 0;
 }
 
-/* takes a file buffer and decodes the file into the global being and land variables */
-n_int	sim_filein(n_byte * buff, n_uint len)
+static void checkpoint_write(noble_checkpoint * local_checkpoint)
 {
-    n_int  ret_val;
-    n_byte temp_store[LARGEST_INIT_PTR];
-    n_uint ape_count = 0;
-    n_uint social_count = 0;
-    n_uint episodic_count = 0;
-    n_file local;
+    n_int result = checkpoint_write_chain(local_checkpoint);
+
+    CHECKPOINT_LOCK(local_checkpoint);
+    local_checkpoint->result = result;
+    local_checkpoint->end = io_nanoseconds();
+    local_checkpoint->state = CHECKPOINT_DONE;
+#ifndef	_WIN32
+    pthread_cond_broadcast(&(local_checkpoint->cond));
+#endif
+    CHECKPOINT_UNLOCK(local_checkpoint);
+}
 
-    noble_simulation * local_sim = sim_sim();
+#ifndef	_WIN32
 
-    local . size = len;
-    local . location = 0;
-    local . data = buff;
+static void * checkpoint_writer(void * id)
+{
+    checkpoint_write((noble_checkpoint *)id);
+    return 0L;
+}
 
-    io_whitespace(&local);
+#endif
 
+/* only one checkpoint is copied, written or compacted at a time */
+static n_byte checkpoint_acquire(noble_checkpoint * local_checkpoint)
+{
+    n_byte state;
 
-    ret_val = io_read_buff(&local, temp_store, noble_file_format);
+    CHECKPOINT_LOCK(local_checkpoint);
+    state = local_checkpoint->state;
+    if ((state != CHECKPOINT_COPYING) && (state != CHECKPOINT_WRITING))
+    {
+        local_checkpoint->state = CHECKPOINT_COPYING;
+    }
+    CHECKPOINT_UNLOCK(local_checkpoint);
 
-    if(ret_val != FIL_VER) /* signature must be first */
-        return SHOW_ERROR("Signature not first in file");
+    return (state == CHECKPOINT_COPYING) ? CHECKPOINT_WRITING : state;
+}
+
+/**
+ * Starts a binary snapshot of the simulation in the background. Call between
+ * cycles; the simulation is only held while its sections are copied. How the
+ * write went comes back through file_checkpoint_report.
+ * @param local_sim The simulation to write.
+ * @param name The name of the snapshot file.
+ * @return 0 if the checkpoint started, -1 if a checkpoint is still being
+ *         written or there is not the memory for the copy.
+ */
+n_int file_checkpoint_write(noble_simulation * local_sim, n_string name)
+{
+    noble_checkpoint * local_checkpoint = local_sim->checkpoint;
+    n_uint loop = 0, bytes = 0;
+    n_byte * location;
 
+    if (local_checkpoint == 0L)
     {
-        n_byte2	*signature = (n_byte2 *)temp_store;
+        return SHOW_ERROR("Not enough memory for checkpoint");
+    }
+    if (io_length(name, STRING_BLOCK_SIZE) > (STRING_BLOCK_SIZE - SNAPSHOT_DELTA_SUFFIX))
+    {
+        return SHOW_ERROR("Checkpoint file name too long");
+    }
 
-        if(signature[0] != NOBLE_APE_SIGNATURE) /* not a Noble Ape file */
-            return SHOW_ERROR("Not a Noble Ape File");
+    if (checkpoint_acquire(local_checkpoint) == CHECKPOINT_WRITING)
+    {
+        return SHOW_ERROR("Checkpoint still being written");
+    }
 
-        if(signature[1] > VERSION_NUMBER) /* file version greater than this version */
-            return SHOW_ERROR("File newer than Simulation");
+    local_checkpoint->start = io_nanoseconds();
+    local_checkpoint->count = file_snapshot_sections(local_sim, local_checkpoint->sections, &local_checkpoint->simulation);
+
+    while (loop < local_checkpoint->count)
+    {
+        bytes += local_checkpoint->sections[loop++].bytes;
+    }
+    if (checkpoint_space(&local_checkpoint->buffer[1 - local_checkpoint->last], &local_checkpoint->buffer_bytes[1 - local_checkpoint->last], bytes) != 0)
+    {
+        CHECKPOINT_LOCK(local_checkpoint);
+        local_checkpoint->state = CHECKPOINT_IDLE;
+        CHECKPOINT_UNLOCK(local_checkpoint);
+        return -1;
     }
 
-    do
+    location = local_checkpoint->buffer[1 - local_checkpoint->last];
+    loop = 0;
+    while (loop < local_checkpoint->count)
     {
-        n_byte *temp = 0L;
-        ret_val = io_read_buff(&local, temp_store, noble_file_format);
-        if (ret_val == -1)
-            SHOW_ERROR("Failure in file load");
-        if (ret_val < FILE_EOF)
-        {
-            n_uint	loop_end = 0;
-            switch (ret_val)
-            {
-            case FIL_LAN:
-                temp = (n_byte*)(local_sim->land);
-                loop_end = NON_PTR_LAND;
-                break;
-            case FIL_WEA:
-                temp = (n_byte*)(local_sim->weather);
-                loop_end = sizeof(n_int);
-                break;
-            case FIL_BEI:
-                temp = (n_byte*) &(local_sim->beings[ape_count]);
-                loop_end = sizeof(noble_being);
-                break;
-            case FIL_SOE:
-                temp = (n_byte*) &(local_sim->social_base[social_count]);
-                loop_end = sizeof(social_link);
-                break;
-            case FIL_EPI:
-                temp = (n_byte*) &(local_sim->episodic_base[social_count]);
-                loop_end = sizeof(social_link);
-                break;
-            default:
-                return SHOW_ERROR("Unknown kind in file"); /*unkown kind*/
-                break;
-            }
-            if(temp != 0L)
-            {
-                io_copy(temp_store, temp, loop_end);
-            }
-            if (ret_val == FIL_BEI)
-            {
-                ape_count ++;
-                if (ape_count == local_sim->max)
-                {
-                    local_sim->num = ape_count;
-                    return SHOW_ERROR("Too many apes for memory");
-                }
-            }
-            if (ret_val == FIL_SOE)
-            {
-                social_count ++;
-                if (social_count == (local_sim->max * SOCIAL_SIZE))
-                {
-                    local_sim->num = ape_count;
-                    return SHOW_ERROR("Too many social graph events for memory");
-                }
-            }
-            if (ret_val == FIL_EPI)
-            {
-                episodic_count ++;
-                if (episodic_count == (local_sim->max * EPISODIC_SIZE))
-                {
-                    local_sim->num = ape_count;
-                    return SHOW_ERROR("Too many episodic events for memory");
-                }
-            }
+        n_snapshot_section * section = &local_checkpoint->sections[loop++];
+        io_copy((n_byte *)section->data, location, section->bytes);
+        section->data = location;
+        location += section->bytes;
+    }
 
+    io_copy((n_byte *)name, (n_byte *)local_checkpoint->name, (n_uint)io_length(name, STRING_BLOCK_SIZE) + 1);
+    local_checkpoint->copy = io_nanoseconds() - local_checkpoint->start;
+    CHECKPOINT_LOCK(local_checkpoint);
+    local_checkpoint->state = CHECKPOINT_WRITING;
+    CHECKPOINT_UNLOCK(local_checkpoint);
+
+#ifndef	_WIN32
+    {
+        pthread_t      writer;
+        pthread_attr_t attributes;
+        n_int          created;
+
+        pthread_attr_init(&attributes);
+        pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+        created = (pthread_create(&writer, &attributes, checkpoint_writer, (void *)local_checkpoint) == 0);
+        pthread_attr_destroy(&attributes);
+        if (created)
+        {
+            return 0;
         }
+    }
+#endif
+    /* without a writer thread the checkpoint is written in place */
+    checkpoint_write(local_checkpoint);
+    return 0;
+}
+
+/**
+ * Reports a finished checkpoint once.
+ * @param local_sim The simulation the checkpoint was written from.
+ * @param output The report, if there is one.
+ * @return 1 if a checkpoint finished since the last report, 0 otherwise.
+ */
+n_int file_checkpoint_report(noble_simulation * local_sim, n_string output)
+{
+    noble_checkpoint * local_checkpoint = local_sim->checkpoint;
+    n_byte state;
 
+    if (local_checkpoint == 0L)
+    {
+        return 0;
     }
-    while (ret_val < FILE_EOF);
+    CHECKPOINT_LOCK(local_checkpoint);
+    state = local_checkpoint->state;
+    if (state == CHECKPOINT_DONE)
+    {
+        local_checkpoint->state = CHECKPOINT_IDLE;
+    }
+    CHECKPOINT_UNLOCK(local_checkpoint);
 
-    if (ret_val == FILE_EOF)
+    if (state != CHECKPOINT_DONE)
     {
-        local_sim->num = ape_count;
         return 0;
     }
-    return SHOW_ERROR("Process file failed");
+    if (local_checkpoint->result == 0)
+    {
+        sprintf(output, "Checkpoint file %s of %ld KB saved in %ld ms, simulation held for %ld ms", local_checkpoint->name,
+                (long)(local_checkpoint->written >> 10), (long)((local_checkpoint->end - local_checkpoint->start) / 1000000),
+                (long)(local_checkpoint->copy / 1000000));
+    }
+    else
+    {
+        sprintf(output, "Checkpoint file %s failed after %ld ms", local_checkpoint->name,
+                (long)((local_checkpoint->end - local_checkpoint->start) / 1000000));
+    }
+    return 1;
 }
 
-/*
- read:
- io_disk_check
- file_chain_new
- add pointers to "to be read"
- file_chain_read_header
- file_chain_read_validate
- file_chain_read
- file_chain_free
+/**
+ * Checks whether a checkpoint is being written and optionally waits for it.
+ * @param local_sim The simulation the checkpoint is written from.
+ * @param wait 1 to wait until the checkpoint is written.
+ * @return 1 if a checkpoint was being written, 0 otherwise.
  */
-n_int file_bin_read(n_string name)
+n_int file_checkpoint_busy(noble_simulation * local_sim, n_byte wait)
 {
-    noble_simulation * local = sim_sim();
-    n_file_chain     * start = 0L;
-    /* weather, brain, social, episodic */
-    const n_uint       total_ptrs = 2;
-    n_string_block     bin_name;
-    
-    file_chain_bin_name(name, bin_name);
-    
-    if (io_disk_check(name) != 1)
+    noble_checkpoint * local_checkpoint = local_sim->checkpoint;
+    n_int busy;
+
+    if (local_checkpoint == 0L)
     {
-        return -1; /* This is legit for no output error */
+        return 0;
     }
-   
-    start = file_chain_new(total_ptrs);
-    
-    if (start == 0L)
+    CHECKPOINT_LOCK(local_checkpoint);
+    busy = ((local_checkpoint->state == CHECKPOINT_COPYING) || (local_checkpoint->state == CHECKPOINT_WRITING));
+#ifndef	_WIN32
+    while (wait && (local_checkpoint->state == CHECKPOINT_WRITING))
     {
-        return SHOW_ERROR("Header not allocated");
+        pthread_cond_wait(&(local_checkpoint->cond), &(local_checkpoint->mtx));
     }
-    
-    start[1].expected_bytes = sizeof(n_weather);
-    start[1].data           = local->weather;
-    
-    start[2].expected_bytes = local->num * DOUBLE_BRAIN;
-    start[2].data           = local->brain_base;
-    
-    if (file_chain_read_header(bin_name, start, total_ptrs) != 0)
+#endif
+    CHECKPOINT_UNLOCK(local_checkpoint);
+    return busy;
+}
+
+/**
+ * Waits for any checkpoint being written and releases the checkpoint state.
+ * @param local_sim The simulation the checkpoints were written from.
+ */
+void file_checkpoint_close(noble_simulation * local_sim)
+{
+    noble_checkpoint * local_checkpoint = local_sim->checkpoint;
+    n_uint loop = 0;
+
+    if (local_checkpoint == 0L)
     {
-        file_chain_free(start);
-        return -1; /* Error already out */
+        return;
     }
-    
-    if (file_chain_read_validate(bin_name, start) != 0)
+    (void)file_checkpoint_busy(local_sim, 1);
+    while (loop < 2)
     {
-        file_chain_free(start);
-        return -1; /* Error already out */
+        if (local_checkpoint->buffer[loop] != 0L)
+        {
+            io_free(local_checkpoint->buffer[loop]);
+        }
+        loop++;
     }
-    if (file_chain_read(bin_name, start) != 0)
+    if (local_checkpoint->delta != 0L)
     {
-        file_chain_free(start);
-        return -1; /* Error already out */
+        io_free(local_checkpoint->delta);
     }
-    
-    file_chain_free(start);
-    return 0;
+#ifndef	_WIN32
+    pthread_cond_destroy(&(local_checkpoint->cond));
+    pthread_mutex_destroy(&(local_checkpoint->mtx));
+#endif
+    io_free((void *)local_checkpoint);
+    local_sim->checkpoint = 0L;
 }
 
-/*
- write:
- file_chain_new
- add pointers to "to be written"
- file_chain_write_generate_header
- file_chain_write
- file_chain_free
+/**
+ * Folds the deltas of a checkpoint into a new base, keeping the chain so
+ * later checkpoints carry on from it.
+ * @param local_sim The simulation the checkpoints are written from.
+ * @param name The name of the checkpoint base.
+ * @return The number of deltas folded in or -1 on failure.
  */
-
-n_int file_bin_write(n_string name)
+n_int file_checkpoint_compact(noble_simulation * local_sim, n_string name)
 {
-    noble_simulation * local = sim_sim();
-    n_file_chain     * start = 0L;
-    /* weather, brain, social, episodic */
-    const n_uint       total_ptrs = 2;
-    n_string_block     bin_name;
-    
-    file_chain_bin_name(name, bin_name);
-    
-    start = file_chain_new(total_ptrs);
-    
-    if (start == 0L)
+    noble_checkpoint   * local_checkpoint = local_sim->checkpoint;
+    n_snapshot           snapshot;
+    n_byte             * copies[SNAPSHOT_SECTIONS_MAX] = {0L};
+    n_snapshot_section * section;
+    noble_snapshot_chain chain;
+    n_uint               sequence;
+    n_int                folded;
+    n_byte               state;
+
+    if (local_checkpoint == 0L)
     {
-        return SHOW_ERROR("Header not allocated");
+        return SHOW_ERROR("Not enough memory for checkpoint");
     }
-    
-    start[1].expected_bytes = sizeof(n_weather);
-    start[1].data           = local->weather;
-    
-    start[2].expected_bytes = local->num * DOUBLE_BRAIN;
-    start[2].data           = local->brain_base;
-    
-    if (file_chain_write_generate_header(start) != 0)
+    state = checkpoint_acquire(local_checkpoint);
+    if (state == CHECKPOINT_WRITING)
     {
-        file_chain_free(start);
-        return -1; /* Error already out */
+        return SHOW_ERROR("Checkpoint still being written");
     }
-    
-    if (file_chain_write(bin_name, start) != 0)
+
+    folded = -1;
+    if (io_snapshot_open(name, &snapshot, 1) == 0)
     {
-        file_chain_free(start);
-        return -1; /* Error already out */
+        section = io_snapshot_find(&snapshot, SNAPSHOT_CHAIN);
+        if ((section == 0L) || (section->bytes != sizeof(noble_snapshot_chain)))
+        {
+            (void)SHOW_ERROR("Not a checkpoint");
+        }
+        else
+        {
+            sequence = ((noble_snapshot_chain *)section->data)->sequence;
+            folded = file_snapshot_replay(&snapshot, name, copies);
+            if (folded > 0)
+            {
+                /* the replayed chain section has the last sequence */
+                section = io_snapshot_find(&snapshot, SNAPSHOT_CHAIN);
+                io_copy((n_byte *)section->data, (n_byte *)&chain, sizeof(noble_snapshot_chain));
+                section->data = &chain;
+                if (io_snapshot_write(name, snapshot.section, snapshot.count) == 0)
+                {
+                    checkpoint_remove_deltas(name, sequence);
+                }
+                else
+                {
+                    folded = -1;
+                }
+            }
+        }
+        file_snapshot_replay_free(copies);
+        io_snapshot_close(&snapshot);
     }
-    file_chain_free(start);
-    return 0;
-}
 
+    CHECKPOINT_LOCK(local_checkpoint);
+    local_checkpoint->state = state;
+    CHECKPOINT_UNLOCK(local_checkpoint);
+    return folded;
+}
 
 n_int sketch_input(void *code, n_byte kind, n_int value)
 {
-    noble_simulation * local_sim = sim_sim();
+    noble_simulation * local_sim = (noble_simulation *)((n_interpret *)code)->owner;
     n_int *local_vr = ((n_interpret *)code)->variable_references;
     noble_being	*local_being = 0L;
     n_int temp_select = local_vr[ VARIABLE_SELECT_BEING - VARIABLE_VECT_ANGLE ];
@@ -540,6 +1460,7 @@ n_int sketch_input(void *code, n_byte kind, n_int value)
             if (local_brain != 0L)
             {
                 TRACK_BRAIN(local_brain, current_x, current_y, current_z) = (n_byte) value;
+                brain_wake(local_sim, &(local_sim->beings[((n_interpret *)code)->specific]));
             }
         }
         /* add brain value */
@@ -558,15 +1479,27 @@ n_int sketch_input(void *code, n_byte kind, n_int value)
         local_being->height = (n_byte2) value;
         break;
     case VARIABLE_FAMILY_NAME_ONE:
-        SET_FAMILY_NAME(local_sim, local_being,
-                        UNPACK_FAMILY_FIRST_NAME((n_byte2) value),
-                        UNPACK_FAMILY_SECOND_NAME(GET_NAME_FAMILY2(local_sim,local_being)));
-        break;
     case VARIABLE_FAMILY_NAME_TWO:
-        SET_FAMILY_NAME(local_sim,local_being,
-                        UNPACK_FAMILY_FIRST_NAME(GET_NAME_FAMILY2(local_sim,local_being)),
-                        UNPACK_FAMILY_SECOND_NAME((n_byte2) value));
+    {
+        n_byte2 family = (n_byte2)GET_NAME_FAMILY2(local_sim,local_being);
+        if (kind == VARIABLE_FAMILY_NAME_ONE)
+        {
+            SET_FAMILY_NAME(local_sim, local_being,
+                            UNPACK_FAMILY_FIRST_NAME((n_byte2) value),
+                            UNPACK_FAMILY_SECOND_NAME(family));
+        }
+        else
+        {
+            SET_FAMILY_NAME(local_sim,local_being,
+                            UNPACK_FAMILY_FIRST_NAME(family),
+                            UNPACK_FAMILY_SECOND_NAME((n_byte2) value));
+        }
+        if (GET_NAME_FAMILY2(local_sim,local_being) != family)
+        {
+            local_sim->index_num = NO_BEINGS_FOUND;
+        }
         break;
+    }
     case VARIABLE_GOAL_TYPE:
         local_being->goal[0] = (n_byte) (value % 3);
         break;
@@ -655,8 +1588,8 @@ n_int sketch_input(void *code, n_byte kind, n_int value)
 
 n_int sketch_output(void * vcode, n_byte * kind, n_int * number)
 {
-    noble_simulation * local_sim = sim_sim();
     n_interpret * code = (n_interpret *) vcode;
+    noble_simulation * local_sim = (noble_simulation *)code->owner;
     n_byte	first_value = kind[0];
     n_byte	second_value = kind[1];
     if(first_value == 'n')
@@ -705,6 +1638,8 @@ n_int sketch_output(void * vcode, n_byte * kind, n_int * number)
             case VARIABLE_LOCATION_Z:
             case VARIABLE_TEST_Z:
             case VARIABLE_IS_VISIBLE:
+            case VARIABLE_WATER_DISTANCE:
+            case VARIABLE_WATER_HEADING:
             case VARIABLE_BIOLOGY_OUTPUT:
             {
                 n_int	quick_x;
@@ -731,6 +1666,17 @@ n_int sketch_output(void * vcode, n_byte * kind, n_int * number)
                     /* range already checked */
                     local_number = being_los(local_sim->land, &(local_sim->beings[code->specific]), (n_byte2)quick_x, (n_byte2)quick_y);
                 }
+                else if ((second_value == VARIABLE_WATER_DISTANCE) || (second_value == VARIABLE_WATER_HEADING))
+                {
+                    n_byte * water_field = being_water_field(local_sim, local_sim->land->tide_level);
+                    n_int    loc = POSITIVE_LAND_COORD(APESPACE_TO_MAPSPACE(quick_x)) |
+                                   (POSITIVE_LAND_COORD(APESPACE_TO_MAPSPACE(quick_y)) << MAP_BITS);
+                    if (water_field == 0L)
+                    {
+                        return io_apescript_error(AE_VALUE_OUT_OF_RANGE);
+                    }
+                    local_number = water_field[(loc << 1) | (second_value == VARIABLE_WATER_HEADING)];
+                }
                 else
                 {
                     if(second_value == VARIABLE_BIOLOGY_OUTPUT)
@@ -740,8 +1686,7 @@ n_int sketch_output(void * vcode, n_byte * kind, n_int * number)
                         {
                             return io_apescript_error(AE_VALUE_OUT_OF_RANGE);
                         }
-                        local_number = land_operator_interpolated(local_sim->land, local_sim->weather,
-                                       (n_byte)quick_x, (n_byte)quick_y, (n_byte*)&operators[int_qu_op-VARIABLE_BIOLOGY_AREA]);
+                        local_number = food_operator(local_sim, (n_byte)quick_x, (n_byte)quick_y, int_qu_op);
                     }
                     else
                     {
@@ -1073,8 +2018,8 @@ n_int sketch_output(void * vcode, n_byte * kind, n_int * number)
 
 void sim_start_conditions(void * code, void * structure, n_int identifier)
 {
-    noble_simulation * local_sim = sim_sim();
     n_interpret * interp = (n_interpret *)code;
+    noble_simulation * local_sim = (noble_simulation *)interp->owner;
     n_int       * variables = interp->variable_references;
     noble_being * local_being = &(((noble_being*)structure)[identifier]);
 
@@ -1104,9 +2049,9 @@ void sim_start_conditions(void * code, void * structure, n_int identifier)
 
 void sim_end_conditions(void * code, void * structure, n_int identifier)
 {
-    noble_simulation * local_sim = sim_sim();
-
     n_interpret * interp = (n_interpret *)code;
+    noble_simulation * local_sim = (noble_simulation *)interp->owner;
+
     n_int       * variables = interp->variable_references;
     noble_being * local_being = &(((noble_being*)structure)[identifier]);
 
@@ -1179,7 +2124,12 @@ void sim_end_conditions(void * code, void * structure, n_int identifier)
     {
         local_being->drives[DRIVE_SEX]  = (n_byte)local_drive_sex;
     }
-    SET_FAMILY_NAME(local_sim,local_being,(n_byte)local_family_name1,(n_byte)local_family_name2);
+    /* the name index is only stale when the script has changed the name */
+    if (GET_NAME_FAMILY2(local_sim,local_being) != (n_byte2)GET_NAME_FAMILY((n_byte)local_family_name1,(n_byte)local_family_name2))
+    {
+        SET_FAMILY_NAME(local_sim,local_being,(n_byte)local_family_name1,(n_byte)local_family_name2);
+        local_sim->index_num = NO_BEINGS_FOUND;
+    }
 #ifdef PARASITES_ON
     local_being->honor = (n_byte)local_honor;
     local_being->parasites = (n_byte)local_parasites;
@@ -65,8 +65,6 @@
 
 /*NOBLEMAKE VAR=""*/
 
-static n_byte  braindisplay = 3;
-
 static variable_string	apescript_variable_codes[VARIABLE_MAX]=
 {
     /* 0 */ /* special "variables" */
@@ -115,6 +113,8 @@ static variable_string	apescript_variable_codes[VARIABLE_MAX]=
     /* 10 */
     "test_z",
     "is_visible",
+    "water_distance",
+    "water_heading",
     
     "time",
     "date",
@@ -236,8 +236,6 @@ n_byte	* offbuffer = 0L;
 
 static noble_simulation	sim;
 
-static n_interpret *interpret = 0L;
-
 /*NOBLEMAKE END=""*/
 
 #ifdef BRAIN_HASH
@@ -254,6 +252,7 @@ static void sim_brain(noble_simulation * local_sim);
 static void sim_brain_dialogue(noble_simulation * local_sim);
 static void sim_being(noble_simulation * local_sim);
 static void sim_time(noble_simulation * local_sim);
+static void sim_schedule(noble_simulation * local_sim);
 
 static n_int            thread_on = 0;
 
@@ -305,8 +304,12 @@ static void * sim_thread_land(void * id)
         pthread_mutex_unlock(&draw_mtx);
 
         land_cycle(sim.land);
+        sim_schedule(&sim);
 #ifdef WEATHER_ON
-        weather_cycle(sim.land, sim.weather);
+        if (SIM_SCHEDULED(&sim, SCHEDULE_WEATHER))
+        {
+            weather_cycle(sim.land, sim.weather);
+        }
 #endif
         pthread_mutex_lock(&draw_mtx);
         sim_done++;
@@ -332,7 +335,10 @@ static void * sim_thread_being(void * id)
         sim_being(&sim);    /* 2 */
         being_tidy(&sim);
         being_remove(&sim); /* 6 */
-        sim_social(&sim);
+        if (SIM_SCHEDULED(&sim, SCHEDULE_SOCIAL))
+        {
+            sim_social(&sim);
+        }
         sim_indicators(&sim);
         sim_time(&sim);
 
@@ -480,6 +486,227 @@ void sim_thread_console(void)
 
 #endif
 
+#ifndef	_WIN32
+
+/* a thread and the part of the range it works */
+typedef struct
+{
+    pthread_t       thread;
+    noble_workers * workers;
+    n_uint          part;
+}
+sim_worker_part;
+
+#endif
+
+/*! @struct
+ @field worker The threads working the parts after the first, the first part
+ is worked by the calling thread.
+ @field count The number of threads running.
+ @field mtx Guards the rest of the workers.
+ @field start Signalled when there is new work or the threads are to quit.
+ @field done Signalled when the last part is worked.
+ @field generation Counts the work given to the threads.
+ @field pending The threads still working.
+ @field quit The threads are to quit.
+ @field function The function each part is worked with.
+ @field total The size of the range.
+ @field parts The number of parts the range is split into.
+ @field local_sim The simulation the work is done on.
+ @discussion Each simulation has its own threads so simulations cycled at the
+ same time never wait on each other.
+ */
+struct noble_workers
+{
+#ifndef	_WIN32
+    sim_worker_part    worker[SIM_THREADS_MAX];
+    n_uint             count;
+
+    pthread_mutex_t    mtx;
+    pthread_cond_t     start;
+    pthread_cond_t     done;
+
+    n_uint             generation;
+    n_uint             pending;
+    n_int              quit;
+#endif
+    sim_work         * function;
+    n_uint             total;
+    n_uint             parts;
+    noble_simulation * local_sim;
+};
+
+/* each part is a fixed contiguous range so the split only depends on the number of threads */
+static void sim_work_part(noble_workers * workers, n_uint part)
+{
+    n_uint start = (workers->total * part) / workers->parts;
+    n_uint end   = (workers->total * (part + 1)) / workers->parts;
+    if (start < end)
+    {
+        (workers->function)(workers->local_sim, start, end);
+    }
+}
+
+#ifndef	_WIN32
+
+static void * sim_worker(void * id)
+{
+    noble_workers * workers = ((sim_worker_part *)id)->workers;
+    n_uint          part = ((sim_worker_part *)id)->part;
+    n_uint          generation = 0;
+    while (1)
+    {
+        pthread_mutex_lock(&(workers->mtx));
+        while ((workers->generation == generation) && (workers->quit == 0))
+        {
+            pthread_cond_wait(&(workers->start), &(workers->mtx));
+        }
+        if (workers->quit)
+        {
+            pthread_mutex_unlock(&(workers->mtx));
+            break;
+        }
+        generation = workers->generation;
+        pthread_mutex_unlock(&(workers->mtx));
+
+        if (part < workers->parts)
+        {
+            sim_work_part(workers, part);
+        }
+
+        pthread_mutex_lock(&(workers->mtx));
+        workers->pending--;
+        if (workers->pending == 0)
+        {
+            pthread_cond_signal(&(workers->done));
+        }
+        pthread_mutex_unlock(&(workers->mtx));
+    }
+    pthread_exit(NULL);
+}
+
+#endif
+
+/* stops the threads of a simulation */
+static void sim_workers_close(noble_simulation * local_sim)
+{
+    noble_workers * workers = local_sim->workers;
+    if (workers == 0L)
+    {
+        return;
+    }
+#ifndef	_WIN32
+    {
+        n_uint loop = 0;
+        pthread_mutex_lock(&(workers->mtx));
+        workers->quit = 1;
+        pthread_cond_broadcast(&(workers->start));
+        pthread_mutex_unlock(&(workers->mtx));
+        while (loop < workers->count)
+        {
+            pthread_join(workers->worker[loop].thread, NULL);
+            loop++;
+        }
+        pthread_cond_destroy(&(workers->done));
+        pthread_cond_destroy(&(workers->start));
+        pthread_mutex_destroy(&(workers->mtx));
+    }
+#endif
+    io_free((void *)workers);
+    local_sim->workers = 0L;
+}
+
+/**
+ * Splits a range of work over the threads of a simulation and waits for it
+ * to finish. The work function must only write to memory belonging to its
+ * own range.
+ * @param local_sim The simulation the work is done on
+ * @param function The function called with each part of the range
+ * @param total The size of the range
+ */
+void sim_parallel(noble_simulation * local_sim, sim_work * function, n_uint total)
+{
+#ifndef	_WIN32
+    noble_workers * workers = local_sim->workers;
+    if ((local_sim->threads > 1) && (workers != 0L) && (workers->count > 0) && (total > 1))
+    {
+        workers->local_sim = local_sim;
+        workers->function = function;
+        workers->total = total;
+        workers->parts = ((local_sim->threads - 1) < workers->count) ? local_sim->threads : (workers->count + 1);
+
+        pthread_mutex_lock(&(workers->mtx));
+        workers->pending = workers->count;
+        workers->generation++;
+        pthread_cond_broadcast(&(workers->start));
+        pthread_mutex_unlock(&(workers->mtx));
+
+        sim_work_part(workers, 0);
+
+        pthread_mutex_lock(&(workers->mtx));
+        while (workers->pending != 0)
+        {
+            pthread_cond_wait(&(workers->done), &(workers->mtx));
+        }
+        pthread_mutex_unlock(&(workers->mtx));
+        return;
+    }
+#endif
+    if (total > 0)
+    {
+        (function)(local_sim, 0, total);
+    }
+}
+
+/**
+ * Sets the number of threads used by a simulation and starts its workers.
+ * With no threads each being senses the others as it acts, in array order.
+ * With threads each being senses the others from the state at the start of the
+ * being cycle, split over the threads, then the beings act in array order on
+ * the calling thread. This gives the same result for any number of threads
+ * from one up, which differs from the result with none. The brains are
+ * independent of each other and are split over the threads the same way.
+ * @param local_sim The simulation
+ * @param count The number of threads
+ */
+void sim_threads(noble_simulation * local_sim, n_uint count)
+{
+    if (count > SIM_THREADS_MAX)
+    {
+        count = SIM_THREADS_MAX;
+    }
+#ifndef	_WIN32
+    if ((local_sim->workers == 0L) && (count > 1))
+    {
+        noble_workers * workers = (noble_workers *)io_new(sizeof(noble_workers));
+        if (workers != 0L)
+        {
+            io_erase((n_byte *)workers, sizeof(noble_workers));
+            pthread_mutex_init(&(workers->mtx), NULL);
+            pthread_cond_init(&(workers->start), NULL);
+            pthread_cond_init(&(workers->done), NULL);
+            local_sim->workers = workers;
+        }
+    }
+    if (local_sim->workers != 0L)
+    {
+        noble_workers * workers = local_sim->workers;
+        while ((workers->count + 1) < count)
+        {
+            sim_worker_part * worker = &(workers->worker[workers->count]);
+            worker->workers = workers;
+            worker->part = workers->count + 1;
+            if (pthread_create(&(worker->thread), NULL, sim_worker, (void *)worker) != 0)
+            {
+                break;
+            }
+            workers->count++;
+        }
+    }
+#endif
+    local_sim->threads = count;
+}
+
 
 noble_simulation * sim_sim(void)
 {
@@ -499,9 +726,9 @@ n_int	sim_interpret(n_byte * buff, n_uint len)
     local . location = 0;
     local . data = buff;
 
-    interpret = parse_convert(&local, VARIABLE_BEING, (variable_string *)apescript_variable_codes);
+    sim.interpret = parse_convert(&local, VARIABLE_BEING, (variable_string *)apescript_variable_codes);
 
-    if(interpret == 0L)
+    if(sim.interpret == 0L)
     {
         return -1;
     }
@@ -510,27 +737,56 @@ n_int	sim_interpret(n_byte * buff, n_uint len)
         SC_DEBUG_ON; /* turn on debugging after script loading */
     }
 
-    interpret->sc_input  = &sketch_input;
-    interpret->sc_output = &sketch_output;
+    sim.interpret->sc_input  = &sketch_input;
+    sim.interpret->sc_output = &sketch_output;
+    sim.interpret->owner     = &sim;
 
-    interpret->input_greater   = VARIABLE_WEATHER;
-    interpret->special_less    = VARIABLE_VECT_X;
+    sim.interpret->input_greater   = VARIABLE_WEATHER;
+    sim.interpret->special_less    = VARIABLE_VECT_X;
 
-    interpret->location = 0;
-    interpret->leave = 0;
-    interpret->localized_leave = 0;
+    sim.interpret->location = 0;
+    sim.interpret->leave = 0;
+    sim.interpret->localized_leave = 0;
 
     return 0;
 }
 
+/* takes a file buffer and decodes the file into the default simulation */
+n_int	sim_filein(n_byte * buff, n_uint len)
+{
+    n_file local;
+
+    local . size = len;
+    local . location = len;
+    local . data = buff;
+
+    return file_in(&sim, &local);
+}
+
+/* provides a file buffer of the default simulation to be written */
+n_byte * sim_fileout(n_uint * len)
+{
+    n_file * output = file_out(&sim);
+    n_byte * data;
+
+    if (output == 0L)
+    {
+        return 0L;
+    }
+    data = output->data;
+    * len = output->location;
+    io_free((void *)output);
+    return data;
+}
+
 n_int     file_interpret(n_file * input_file)
 {
     input_file->size = input_file->location;
     input_file->location = 0;
     
-    interpret = parse_convert(input_file, VARIABLE_BEING, (variable_string *)apescript_variable_codes);
+    sim.interpret = parse_convert(input_file, VARIABLE_BEING, (variable_string *)apescript_variable_codes);
     
-    if(interpret == 0L)
+    if(sim.interpret == 0L)
     {
         return -1;
     }
@@ -539,15 +795,16 @@ n_int     file_interpret(n_file * input_file)
         SC_DEBUG_ON; /* turn on debugging after script loading */
     }
     
-    interpret->sc_input  = &sketch_input;
-    interpret->sc_output = &sketch_output;
+    sim.interpret->sc_input  = &sketch_input;
+    sim.interpret->sc_output = &sketch_output;
+    sim.interpret->owner     = &sim;
     
-    interpret->input_greater   = VARIABLE_WEATHER;
-    interpret->special_less    = VARIABLE_VECT_X;
+    sim.interpret->input_greater   = VARIABLE_WEATHER;
+    sim.interpret->special_less    = VARIABLE_VECT_X;
     
-    interpret->location = 0;
-    interpret->leave = 0;
-    interpret->localized_leave = 0;
+    sim.interpret->location = 0;
+    sim.interpret->leave = 0;
+    sim.interpret->localized_leave = 0;
     
     return 0;
 }
@@ -556,8 +813,12 @@ static void sim_brain_no_return(noble_simulation * local_sim, noble_being * loca
 {
     n_byte2 local_brain_state[3];
 
-    if(being_awake_local(&sim, local_being) == 0)
+    if(being_awake_local(local_sim, local_being) == 0)
     {
+        if (SIM_SLEEP_TURN(local_sim, local_being) == 0)
+        {
+            return;
+        }
         local_brain_state[0] = GET_BS(local_being, 3);
         local_brain_state[1] = GET_BS(local_being, 4);
         local_brain_state[2] = GET_BS(local_being, 5);
@@ -569,14 +830,14 @@ static void sim_brain_no_return(noble_simulation * local_sim, noble_being * loca
         local_brain_state[2] = GET_BS(local_being, 2);
     }
     
-    if(braindisplay == 1)
+    if(local_sim->braindisplay == 1)
     {
         local_brain_state[0] = 0;
         local_brain_state[1] = 500;
         local_brain_state[2] = (5*local_brain_state[2])>>3;
     }
     
-    if(braindisplay == 2)
+    if(local_sim->braindisplay == 2)
     {
         local_brain_state[0] = (9*local_brain_state[0])>>3;
         local_brain_state[1] = 82;
@@ -588,16 +849,85 @@ static void sim_brain_no_return(noble_simulation * local_sim, noble_being * loca
         n_byte			*local_brain = GET_B(local_sim, local_being);
         if (local_brain != 0L)
         {
-            brain_cycle(local_brain, local_brain_state);
+            noble_brain_rest * local_rest = 0L;
+            if (local_sim->brain_rest != 0L)
+            {
+                local_rest = &(local_sim->brain_rest[local_being->brain_memory_location]);
+            }
+            brain_cycle_rest(local_brain, local_brain_state, local_rest);
         }
     }    
 }
 
+/* each part is a contiguous run of beings and so a contiguous run of brains */
+static void sim_brain_range(noble_simulation * local_sim, n_uint start, n_uint end)
+{
+    while (start < end)
+    {
+        sim_brain_no_return(local_sim, &(local_sim->beings[start++]));
+    }
+}
+
 static void sim_brain(noble_simulation * local_sim)
 {
-    being_loop_no_return(local_sim, sim_brain_no_return);
+    sim_parallel(local_sim, &sim_brain_range, local_sim->num);
+}
+
+#ifdef WEATHER_ON
+
+#define SIM_WEATHER_PAIRS   (MAP_DIMENSION/(4*WEATHER_BLOCK))
+
+/* the triangle rows get shorter across the atmosphere so each part is a block from either end */
+static void sim_weather_rows(noble_simulation * local_sim, n_uint start, n_uint end, n_byte lower)
+{
+    while (start < end)
+    {
+        n_int   first = (n_int)start * WEATHER_BLOCK;
+        n_int   last = (MAP_DIMENSION/2) - first - WEATHER_BLOCK;
+        local_sim->weather_rows[start] +=
+            weather_triangle(local_sim->weather, lower, first, first + WEATHER_BLOCK) +
+            weather_triangle(local_sim->weather, lower, last, last + WEATHER_BLOCK);
+        start++;
+    }
+}
+
+static void sim_weather_upper(noble_simulation * local_sim, n_uint start, n_uint end)
+{
+    sim_weather_rows(local_sim, start, end, 0);
+}
+
+static void sim_weather_lower(noble_simulation * local_sim, n_uint start, n_uint end)
+{
+    sim_weather_rows(local_sim, start, end, 1);
+}
+
+/**
+ * The same as weather_cycle with the triangles either side of the diagonal split
+ * over the simulation threads. The atmosphere and total pressure are the same
+ * for any number of threads.
+ * @param local_sim The simulation the weather is cycled in
+ */
+void sim_weather(noble_simulation * local_sim)
+{
+    n_c_uint    total_pressure;
+    n_uint      loop = 0;
+
+    io_erase((n_byte *)local_sim->weather_rows, sizeof(local_sim->weather_rows));
+
+    weather_evaporate(local_sim->land, local_sim->weather);
+    sim_parallel(local_sim, &sim_weather_upper, SIM_WEATHER_PAIRS);
+    total_pressure = weather_diagonal(local_sim->weather);
+    sim_parallel(local_sim, &sim_weather_lower, SIM_WEATHER_PAIRS);
+
+    while (loop < SIM_WEATHER_PAIRS)
+    {
+        total_pressure += local_sim->weather_rows[loop++];
+    }
+    local_sim->weather->total_pressure = (n_c_int)total_pressure;
 }
 
+#endif
+
 #ifdef BRAINCODE_ON
 
 static void sim_brain_dialogue_no_return(noble_simulation * local_sim, noble_being * local_being)
@@ -605,8 +935,12 @@ static void sim_brain_dialogue_no_return(noble_simulation * local_sim, noble_bei
     n_byte     awake = 1;
     n_byte    *local_internal = GET_BRAINCODE_INTERNAL(local_sim,local_being);
     n_byte    *local_external = GET_BRAINCODE_EXTERNAL(local_sim,local_being);
-    if(being_awake_local(&sim, local_being) == 0)
+    if(being_awake_local(local_sim, local_being) == 0)
     {
+        if (SIM_SLEEP_TURN(local_sim, local_being) == 0)
+        {
+            return;
+        }
         awake=0;
     }
     /* This should be independent of the brainstate/cognitive simulation code */
@@ -627,11 +961,12 @@ static void sim_brain_hash(noble_simulation * local_sim)
     brain_hash_count++;
     if((brain_hash_count & 63) == 0)
     {
-        n_byte * hash_brain = GET_B(local_sim, &(sim.beings[sim.select]));
+        noble_being * selected = being_selected(local_sim);
+        n_byte * hash_brain = (selected != 0L) ? GET_B(local_sim, selected) : 0L;
         
         brain_hash_count = 0;
         
-        if ((sim.select != NO_BEINGS_FOUND) && (hash_brain != 0L))
+        if (hash_brain != 0L)
         {
             brain_hash(hash_brain, brain_hash_out);
         }
@@ -642,16 +977,38 @@ static void sim_brain_hash(noble_simulation * local_sim)
 
 void sim_braindisplay(n_byte newval)
 {
-    braindisplay = newval;
+    sim.braindisplay = newval;
 }
 
 
+static void sim_being_sense(noble_simulation * local_sim, n_uint start, n_uint end)
+{
+    while (start < end)
+    {
+        being_sense(local_sim, start++);
+    }
+}
+
 static void sim_being(noble_simulation * local_sim)
 {
     n_uint loop = 0;
 
     local_sim->someone_speaking = 0;
 
+    being_space_rebuild(local_sim);
+    if (local_sim->index_num != local_sim->num)
+    {
+        being_index_rebuild(local_sim);
+    }
+
+    /* with threads all the beings sense each other before any of them act */
+    local_sim->senses_num = 0;
+    if ((local_sim->threads != 0) && (local_sim->senses != 0L))
+    {
+        sim_parallel(local_sim, &sim_being_sense, local_sim->num);
+        local_sim->senses_num = local_sim->num;
+    }
+
     while (loop < local_sim->num)
     {
         noble_being * local_being = &(local_sim->beings[loop]);
@@ -662,11 +1019,11 @@ static void sim_being(noble_simulation * local_sim)
         
         if (awake)
         {
-            if(interpret_cycle(interpret, -1, local_sim->beings, loop, &sim_start_conditions, &sim_end_conditions) == -1)
+            if(interpret_cycle(local_sim->interpret, -1, local_sim->beings, loop, &sim_start_conditions, &sim_end_conditions) == -1)
             {
-                interpret_cleanup(interpret);
+                interpret_cleanup(local_sim->interpret);
             }
-            if(interpret == 0L)
+            if(local_sim->interpret == 0L)
             {
                 being_cycle_awake(local_sim, loop);
             }
@@ -674,6 +1031,8 @@ static void sim_being(noble_simulation * local_sim)
 
         loop++;
     }
+
+    local_sim->senses_num = 0;
 }
 
 static void sim_time(noble_simulation * local_sim)
@@ -688,310 +1047,676 @@ static void sim_time(noble_simulation * local_sim)
     }
 }
 
-static void sim_indicators(noble_simulation * sim)
+/* the indicator log of a simulation stays open, with the rows kept with it until a flush */
+
+static const n_string indicators_log_names[INDICATORS_COLUMNS] =
 {
-    noble_indicators * indicators;
-    n_uint b;
-    n_int i,n,diff;
-    n_uint current_date;
-    n_uint average_cohesion=0,average_amorousness=0,average_familiarity=0,average_energy=0;
-    n_uint social_links=0;
-    n_byte x,y;
-    social_link * local_social_graph;
-    n_uint mean_genome[8*CHROMOSOMES];
-    noble_being * local_being;
-    n_uint local_dob;
-    FILE * fp;
-    n_string_block filename;
-    n_uint drives[DRIVES];
-    n_uint family[2],sd;
-    n_uint positive_affect=0,negative_affect=0;
-    n_uint average_first_person=0;
-    n_uint average_intentions=0;
-#ifdef IMMUNE_ON
-    n_uint average_antigens=0,average_antibodies=0;
-    noble_immune_system * immune;
-#endif
-#ifdef BRAINCODE_ON
-    n_uint mean_braincode[BRAINCODE_SIZE*2];
-#endif
+    "Population", "Drownings", "Parasites", "Average Parasite Mobility (x100)", "Average Chat (x100)",
+    "Average Age (days)", "Average Mobility", "Average Energy", "Average Energy Input", "Average Energy Output",
+    "Average Amorousness", "Average Cohesion (x100)", "Average Familiarity", "Average Social Links (x100)",
+    "Average Positive Affect (x100)", "Average Negative Affect (x100)", "Average Antigens", "Average Antibodies",
+    "Ideological Variation", "Genetic Variation", "Family Name Variation", "Average Shouts", "Average Listens",
+    "Average Grooming (x100)", "Average Brainprobe Activity (x100)", "Average Hunger", "Average Social Drive",
+    "Average Fatigue", "Average Sex Drive", "Food (Vegetable)", "Food (Fruit)", "Food (Shellfish)", "Food (Seaweed)",
+    "Average First Person Percent", "Average Intentions Percent", "Average Braincode Sensors",
+    "Average Braincode Actuators", "Average Braincode Operators", "Average Braincode Conditionals",
+    "Average Braincode Data", "Dormant Brains Percent"
+};
+
+/*! @struct
+ @field file The open log.
+ @field number The number in the name of the log.
+ @field binary The log is in the binary columnar format.
+ @field rows The rows kept since the last flush.
+ @field flushed When the log was last flushed, in nanoseconds.
+ @field values The rows kept since the last flush.
+ */
+struct noble_log
+{
+    FILE   * file;
+    n_uint   number;
+    n_byte   binary;
+    n_uint   rows;
+    n_uint   flushed;
+    n_c_uint values[INDICATORS_LOG_ROWS][INDICATORS_COLUMNS];
+};
 
-    if (sim->land->time%INDICATORS_FREQUENCY!=0) return;
+/**
+ * The values of the indicators in the order of the indicator log columns.
+ * @param indicators the indicators.
+ * @param values INDICATORS_COLUMNS values are written here.
+ */
+void sim_indicators_values(noble_indicators * indicators, n_c_uint * values)
+{
+    n_int count = 0;
+    values[count++] = indicators->population;
+    values[count++] = indicators->drownings;
+    values[count++] = (n_c_uint)indicators->parasites;
+    values[count++] = indicators->average_parasite_mobility;
+    values[count++] = indicators->average_chat;
+    values[count++] = (n_c_uint)indicators->average_age_days;
+    values[count++] = indicators->average_mobility;
+    values[count++] = indicators->average_energy;
+    values[count++] = (n_c_uint)indicators->average_energy_input;
+    values[count++] = (n_c_uint)indicators->average_energy_output;
+    values[count++] = indicators->average_amorousness;
+    values[count++] = indicators->average_cohesion;
+    values[count++] = indicators->average_familiarity;
+    values[count++] = indicators->average_social_links;
+    values[count++] = (n_c_uint)indicators->average_positive_affect;
+    values[count++] = (n_c_uint)indicators->average_negative_affect;
+    values[count++] = indicators->average_antigens;
+    values[count++] = indicators->average_antibodies;
+    values[count++] = indicators->ideology_sd;
+    values[count++] = indicators->genetics_sd;
+    values[count++] = indicators->family_name_sd;
+    values[count++] = indicators->average_shouts;
+    values[count++] = indicators->average_listens;
+    values[count++] = indicators->average_grooming;
+    values[count++] = (n_c_uint)indicators->average_brainprobe_activity;
+    values[count++] = indicators->drives[DRIVE_HUNGER];
+    values[count++] = indicators->drives[DRIVE_SOCIAL];
+    values[count++] = indicators->drives[DRIVE_FATIGUE];
+    values[count++] = indicators->drives[DRIVE_SEX];
+    values[count++] = indicators->food[FOOD_VEGETABLE];
+    values[count++] = indicators->food[FOOD_FRUIT];
+    values[count++] = indicators->food[FOOD_SHELLFISH];
+    values[count++] = indicators->food[FOOD_SEAWEED];
+    values[count++] = indicators->average_first_person;
+    values[count++] = indicators->average_intentions;
+    values[count++] = indicators->average_sensors;
+    values[count++] = indicators->average_actuators;
+    values[count++] = indicators->average_operators;
+    values[count++] = indicators->average_conditionals;
+    values[count++] = indicators->average_data;
+    values[count++] = indicators->dormant_brains;
+}
 
-    indicators = &(sim->indicators_base[sim->indicator_index]);
-    indicators->population = (n_byte2)(sim->num);
-    if (sim->num==0)
-    {
-        return;
-    }
+/**
+ * The name of a column of the indicator log, as the CSV header gives it.
+ * @param column from 0 to INDICATORS_COLUMNS - 1.
+ * @return the name.
+ */
+n_string sim_indicators_log_name(n_int column)
+{
+    return indicators_log_names[column];
+}
 
-    current_date = TIME_IN_DAYS(sim->land->date);
+/**
+ * Chooses the format of indicator log files opened from now on.
+ * @param local_sim the simulation logging its indicators.
+ * @param binary non-zero for the binary columnar format, zero for CSV.
+ */
+void sim_indicators_log_format(noble_simulation * local_sim, n_byte binary)
+{
+    local_sim->indicators_binary = binary;
+}
 
-    for (i=0; i<8*8; i++)
-    {
-        indicators->population_density[i]=0;
-    }
+/**
+ * Writes the rows kept since the last flush to the indicator log.
+ * @param local_sim the simulation logging its indicators.
+ */
+void sim_indicators_log_flush(noble_simulation * local_sim)
+{
+    noble_log * local_log = local_sim->indicators_log;
+    n_uint      row = 0;
 
-    for (n=0; n<8*CHROMOSOMES; n++)
+    if ((local_log == 0L) || (local_log->rows == 0))
     {
-        mean_genome[n]=0;
+        return;
     }
-    for (n=0; n<DRIVES; n++)
+    if (local_log->binary)
     {
-        drives[n]=0;
+        /* a block is the row count then each column in turn, as narrow as its values allow */
+        n_c_uint rows = (n_c_uint)local_log->rows;
+        n_c_uint column_values[INDICATORS_LOG_ROWS];
+        n_int    column = 0;
+        (void)fwrite(&rows, sizeof(n_c_uint), 1, local_log->file);
+        while (column < INDICATORS_COLUMNS)
+        {
+            n_c_uint largest = 0;
+            n_byte   width = 1;
+            row = 0;
+            while (row < local_log->rows)
+            {
+                largest |= local_log->values[row++][column];
+            }
+            if (largest > 0xffff)
+            {
+                width = 4;
+            }
+            else if (largest > 0xff)
+            {
+                width = 2;
+            }
+            row = 0;
+            while (row < local_log->rows)
+            {
+                n_c_uint value = local_log->values[row][column];
+                if (width == 1)
+                {
+                    ((n_byte *)column_values)[row] = (n_byte)value;
+                }
+                else if (width == 2)
+                {
+                    ((n_byte2 *)column_values)[row] = (n_byte2)value;
+                }
+                else
+                {
+                    column_values[row] = value;
+                }
+                row++;
+            }
+            (void)fwrite(&width, 1, 1, local_log->file);
+            (void)fwrite(column_values, width, local_log->rows, local_log->file);
+            column++;
+        }
     }
-    for (n=0; n<2; n++)
+    else
     {
-        family[n]=0;
+        n_file * text = io_file_new();
+        if (text == 0L)
+        {
+            return;
+        }
+        while (row < local_log->rows)
+        {
+            n_int column = 0;
+            while (column < INDICATORS_COLUMNS)
+            {
+                n_byte last = (column == (INDICATORS_COLUMNS - 1));
+                (void)io_writenum(text, (n_int)local_log->values[row][column], (n_byte)(last ? 0 : ','), last);
+                column++;
+            }
+            row++;
+        }
+        (void)fwrite(text->data, 1, text->location, local_log->file);
+        io_file_free(text);
     }
+    (void)fflush(local_log->file);
+    local_log->rows = 0;
+    local_log->flushed = io_nanoseconds();
+}
 
-#ifdef BRAINCODE_ON
-    for (n=0; n<BRAINCODE_SIZE*2; n++)
+/**
+ * Flushes and closes the indicator log.
+ * @param local_sim the simulation logging its indicators.
+ */
+void sim_indicators_log_close(noble_simulation * local_sim)
+{
+    noble_log * local_log = local_sim->indicators_log;
+    if (local_log)
     {
-        mean_braincode[n]=0;
+        sim_indicators_log_flush(local_sim);
+        fclose(local_log->file);
+        io_free((void *)local_log);
+        local_sim->indicators_log = 0L;
     }
-#endif
-
-    indicators->parasites=0;
-    indicators->average_antigens=0;
-    indicators->average_antibodies=0;
-    for (b=0; b<sim->num; b++)
-    {
-        local_being = &(sim->beings[b]);
-        local_dob = TIME_IN_DAYS(GET_D(local_being));
-        indicators->average_age_days += current_date - local_dob;
-        average_energy += (n_uint)GET_E(local_being);
-#ifdef EPISODIC_ON
-        average_first_person += (n_uint)episodic_first_person_memories_percent(sim,local_being,0);
-        average_intentions += (n_uint)episodic_first_person_memories_percent(sim,local_being,1);
-#endif
-#ifdef PARASITES_ON
-        indicators->parasites += local_being->parasites;
-#endif
+}
 
-        /* family */
-        family[0]+=GET_FAMILY_FIRST_NAME(sim,local_being);
-        family[1]+=GET_FAMILY_SECOND_NAME(sim,local_being);
+/* the indicator logs kept when an older log of the same number has other columns */
+#define INDICATORS_LOG_VERSIONS (16)
 
-        /* drives */
-        for (i=0; i<DRIVES; i++)
+/* if an existing log has the header this build writes, so its rows can be appended */
+static n_byte sim_indicators_log_matches(FILE * fp, n_byte binary)
+{
+    n_int column = 0;
+    if (binary)
+    {
+        n_byte   signature[8];
+        n_c_uint header[2];
+        if ((fread(signature, 1, 8, fp) != 8) ||
+                (io_same(signature, (n_byte *)INDICATORS_LOG_SIGNATURE, 8) == 0) ||
+                (fread(header, sizeof(n_c_uint), 2, fp) != 2) ||
+                (header[0] != INDICATORS_COLUMNS))
         {
-            drives[i] += local_being->drives[i];
+            return 0;
         }
-
-        /* population density */
-        x = (n_byte)(APESPACE_TO_MAPSPACE(local_being->x) * 8 / MAP_DIMENSION);
-        y = (n_byte)(APESPACE_TO_MAPSPACE(local_being->y) * 8 / MAP_DIMENSION);
-        indicators->population_density[y*8+x]++;
-
-        /* affect */
-        positive_affect += being_affect(sim,local_being,1);
-        negative_affect += being_affect(sim,local_being,0);
-
-        /* social graph indicators */
-        local_social_graph = GET_SOC(sim, local_being);
-        for (i=0; i<SOCIAL_SIZE; i++)
+    }
+    while (column < INDICATORS_COLUMNS)
+    {
+        n_string name = indicators_log_names[column];
+        n_int    loop = 0;
+        while (name[loop] != 0)
         {
-            if (!SOCIAL_GRAPH_ENTRY_EMPTY(local_social_graph,i))
+            if (fgetc(fp) != name[loop])
             {
-                social_links++;
-                average_cohesion += (n_uint)(local_social_graph[i].friend_foe);
-                average_familiarity += (n_uint)(local_social_graph[i].familiarity);
-                average_amorousness += (n_uint)(local_social_graph[i].attraction);
+                return 0;
             }
+            loop++;
         }
-
-        /* average genome */
-        for (n=0; n<8*CHROMOSOMES; n++)
+        if (fgetc(fp) != ((column == (INDICATORS_COLUMNS - 1)) ? '\n' : ','))
         {
-            mean_genome[n] += GET_NUCLEOTIDE(GET_G(local_being),n);
+            return 0;
         }
+        column++;
+    }
+    return 1;
+}
 
-#ifdef BRAINCODE_ON
-        /* average braincode */
-        for (n=0; n<BRAINCODE_SIZE; n++)
+static void sim_indicators_log_open(noble_simulation * local_sim, n_uint number)
+{
+    n_string_block filename;
+    FILE         * fp;
+    FILE         * log_file;
+    noble_log    * local_log;
+    n_byte         binary = local_sim->indicators_binary;
+    n_byte         matches = 0;
+    n_uint         version = 0;
+
+    /* a log with other columns is left alone and the rows go to the next version */
+    do
+    {
+        if (version == 0)
         {
-            mean_braincode[n] += (n_uint)GET_BRAINCODE_INTERNAL(sim,local_being)[n];
-            mean_braincode[n+BRAINCODE_SIZE] += (n_uint)GET_BRAINCODE_EXTERNAL(sim,local_being)[n];
+            sprintf((char*)filename, "indicators%u.%s", (unsigned int)number, binary ? "bin" : "csv");
         }
-#endif
-
-#ifdef IMMUNE_ON
-        /* immune system */
-        immune = &(local_being->immune_system);
-        for (n=0; n<IMMUNE_ANTIGENS; n++)
+        else
         {
-            average_antigens += (n_uint)immune->antigens[n];
+            sprintf((char*)filename, "indicators%u_%u.%s", (unsigned int)number, (unsigned int)version, binary ? "bin" : "csv");
         }
-        for (n=0; n<IMMUNE_POPULATION; n++)
+        fp = fopen(filename, binary ? "rb" : "r");
+        if (fp != NULL)
         {
-            average_antibodies += (n_uint)immune->antibodies[n];
+            matches = sim_indicators_log_matches(fp, binary);
+            fclose(fp);
         }
-#endif
+        version++;
     }
-    indicators->average_brainprobe_activity = indicators->average_brainprobe_activity/(n_uint)sim->num;
-    indicators->average_parasite_mobility = (n_byte2)((n_uint)indicators->average_parasite_mobility*100/sim->num);
-    indicators->average_grooming = (n_byte2)((n_uint)indicators->average_grooming*100/sim->num);
-    indicators->average_shouts = (n_byte2)(((n_uint)(indicators->average_shouts)*100)/sim->num);
-    indicators->average_listens = (n_byte2)(((n_uint)(indicators->average_shouts)*100)/sim->num);
-    indicators->average_chat = (n_byte2)((indicators->average_chat * 100) / sim->num);
-    indicators->average_age_days /= sim->num;
-    indicators->average_energy_input /= sim->num;
-    indicators->average_energy_output /= sim->num;
-    indicators->average_mobility /= (n_byte2)sim->num;
-    indicators->average_social_links = (n_byte2)((social_links*100) / sim->num);
-    indicators->average_positive_affect = (n_uint)((positive_affect*100) / sim->num);
-    indicators->average_negative_affect = (n_uint)((negative_affect*100) / sim->num);
-    indicators->average_energy = (n_byte2)(average_energy / sim->num);
-    indicators->average_first_person = (n_byte2)(average_first_person * 10 / sim->num);
-    indicators->average_intentions = (n_byte2)(average_intentions * 10 / sim->num);
-#ifdef BRAINCODE_ON
-    braincode_statistics(sim);
-#endif
-    if (social_links>0)
+    while ((fp != NULL) && (matches == 0) && (version < INDICATORS_LOG_VERSIONS));
+
+    if ((fp != NULL) && (matches == 0))
     {
-        indicators->average_cohesion = (n_byte2)((average_cohesion*100) / social_links);
-        indicators->average_familiarity = (n_byte)(average_familiarity / social_links);
-        indicators->average_amorousness = (n_byte)(average_amorousness / social_links);
+        (void)SHOW_ERROR("Indicator logs have other columns");
+        return;
     }
-    else
+
+    if (fp != NULL)
     {
-        indicators->average_cohesion = SOCIAL_RESPECT_NORMAL*100;
-        indicators->average_familiarity=0;
-        indicators->average_amorousness=0;
+        log_file = fopen(filename, binary ? "ab" : "a");
     }
-
-    /* family name variance */
-    for (i=0; i<2; i++)
+    else
     {
-        family[i]/=sim->num;
+        n_int column = 0;
+        log_file = fopen(filename, binary ? "wb" : "w");
+        if (log_file == NULL)
+        {
+            return;
+        }
+        if (binary)
+        {
+            n_c_uint header[2];
+            n_c_uint name_bytes = 0;
+            while (column < INDICATORS_COLUMNS)
+            {
+                name_bytes += (n_c_uint)io_length(indicators_log_names[column++], STRING_BLOCK_SIZE) + 1;
+            }
+            header[0] = INDICATORS_COLUMNS;
+            header[1] = name_bytes;
+            (void)fwrite(INDICATORS_LOG_SIGNATURE, 1, 8, log_file);
+            (void)fwrite(header, sizeof(n_c_uint), 2, log_file);
+            column = 0;
+        }
+        /* the names are the CSV header, and follow the binary header too */
+        while (column < INDICATORS_COLUMNS)
+        {
+            fprintf(log_file, "%s%c", indicators_log_names[column],
+                    (column == (INDICATORS_COLUMNS - 1)) ? '\n' : ',');
+            column++;
+        }
     }
-    sd = 0;
-    for (b=0; b<sim->num; b++)
+    if (log_file == NULL)
     {
-        local_being = &(sim->beings[b]);
-
-        diff = (n_int)ABS(GET_FAMILY_FIRST_NAME(sim,local_being) - (n_int)family[0]);
-        sd += (n_uint)diff;
-        diff = (n_int)ABS(GET_FAMILY_SECOND_NAME(sim,local_being) - (n_int)family[1]);
-        sd += (n_uint)diff;
+        return;
     }
-    indicators->family_name_sd = (n_byte2)((sd*100) / sim->num);
-
-    /* drives */
-    for (i=0; i<DRIVES; i++)
+    local_log = (noble_log *)io_new(sizeof(noble_log));
+    if (local_log == 0L)
     {
-        indicators->drives[i] = (n_byte2)((drives[i]*100) / sim->num);
+        fclose(log_file);
+        return;
     }
+    local_log->file = log_file;
+    local_log->rows = 0;
+    local_log->number = number;
+    local_log->binary = binary;
+    local_log->flushed = io_nanoseconds();
+    local_sim->indicators_log = local_log;
+}
 
-    /* genetics variance */
-    sd=0;
-    for (n=0; n<8*CHROMOSOMES; n++)
+/* keeps a row for the indicator log, flushing when the rows are full or have waited too long */
+static void sim_indicators_log(noble_simulation * local_sim, n_uint number, noble_indicators * indicators)
+{
+    noble_log * local_log = local_sim->indicators_log;
+    if ((local_log != 0L) &&
+            ((local_log->number != number) || (local_log->binary != local_sim->indicators_binary)))
     {
-        mean_genome[n] /= sim->num;
+        sim_indicators_log_close(local_sim);
     }
-    for (b=0; b<sim->num; b++)
+    if (local_sim->indicators_log == 0L)
     {
-        local_being = &(sim->beings[b]);
-        for (n=0; n<8*CHROMOSOMES; n++)
+        sim_indicators_log_open(local_sim, number);
+        if (local_sim->indicators_log == 0L)
         {
-            diff = (n_int)ABS(GET_NUCLEOTIDE(GET_G(local_being),n) - (n_int)mean_genome[n]);
-            sd += (n_uint)diff;
+            return;
         }
     }
-    indicators->genetics_sd = (n_byte2)((sd*100)/sim->num);
+    local_log = local_sim->indicators_log;
+    sim_indicators_values(indicators, local_log->values[local_log->rows++]);
 
-    sd = 0;
-#ifdef BRAINCODE_ON
-    /* ideology variance */
-    for (n=0; n<BRAINCODE_SIZE; n++)
+    if ((local_log->rows == INDICATORS_LOG_ROWS) ||
+            (((io_nanoseconds() - local_log->flushed) / 1000000) >= INDICATORS_LOG_MILLISECONDS))
     {
-        mean_braincode[n] /= (n_uint)sim->num;
-        mean_braincode[n+BRAINCODE_SIZE] /= (n_uint)sim->num;
+        sim_indicators_log_flush(local_sim);
     }
-    for (b=0; b<sim->num; b++)
+}
+
+/* the first and one past the last being of a part of the beings */
+static void sim_indicators_span(noble_simulation * sim, n_uint part, n_uint * first, n_uint * last)
+{
+    *first = (sim->num * part) / INDICATORS_PARTS;
+    *last = (sim->num * (part + 1)) / INDICATORS_PARTS;
+}
+
+/* sums everything the indicators need over each part of the beings in one look at each being */
+static void sim_indicators_sum(noble_simulation * sim, n_uint start, n_uint end)
+{
+    n_uint current_date = TIME_IN_DAYS(sim->land->date);
+    while (start < end)
     {
-        local_being = &(sim->beings[b]);
-        for (n=0; n<BRAINCODE_SIZE; n++)
+        noble_indicators_part * part = &(sim->indicators_parts[start]);
+        n_uint b, last;
+        n_int i, n;
+
+        io_erase((n_byte *)part, sizeof(noble_indicators_part));
+        sim_indicators_span(sim, start, &b, &last);
+
+        while (b < last)
         {
-            diff = ABS((n_int)(GET_BRAINCODE_INTERNAL(sim,local_being)[n]) - (n_int)mean_braincode[n]);
-            sd += (n_uint)diff;
+            noble_being * local_being = &(sim->beings[b]);
+            social_link * local_social_graph;
+            n_uint positive_affect, negative_affect;
+            n_byte x, y;
+#ifdef EPISODIC_ON
+            n_int first_person, intentions;
+#endif
+#ifdef IMMUNE_ON
+            noble_immune_system * immune;
+#endif
+            part->age_days += current_date - TIME_IN_DAYS(GET_D(local_being));
+            part->energy += (n_uint)GET_E(local_being);
+#ifdef EPISODIC_ON
+            episodic_first_person_percents(sim, local_being, &first_person, &intentions);
+            part->first_person += (n_uint)first_person;
+            part->intentions += (n_uint)intentions;
+#endif
+#ifdef PARASITES_ON
+            part->parasites += local_being->parasites;
+#endif
+            if ((sim->brain_rest != 0L) && (local_being->brain_memory_location != NO_BRAIN_MEMORY_LOCATION))
+            {
+                if (sim->brain_rest[local_being->brain_memory_location].state == BRAIN_DORMANT)
+                {
+                    part->dormant_brains++;
+                }
+            }
 
-            diff = ABS((n_int)(GET_BRAINCODE_EXTERNAL(sim,local_being)[n]) - (n_int)mean_braincode[n+BRAINCODE_SIZE]);
-            sd += (n_uint)diff;
-        }
-    }
-    indicators->ideology_sd = (n_byte2)(sd/sim->num);
+            /* family */
+            part->family[0] += GET_FAMILY_FIRST_NAME(sim,local_being);
+            part->family[1] += GET_FAMILY_SECOND_NAME(sim,local_being);
+
+            /* drives */
+            for (i=0; i<DRIVES; i++)
+            {
+                part->drives[i] += local_being->drives[i];
+            }
+
+            /* population density */
+            x = (n_byte)(APESPACE_TO_MAPSPACE(local_being->x) * 8 / MAP_DIMENSION);
+            y = (n_byte)(APESPACE_TO_MAPSPACE(local_being->y) * 8 / MAP_DIMENSION);
+            part->population_density[y*8+x]++;
+
+            /* affect */
+            being_affect_totals(sim, local_being, &positive_affect, &negative_affect);
+            part->positive_affect += positive_affect;
+            part->negative_affect += negative_affect;
+
+            /* social graph indicators */
+            local_social_graph = GET_SOC(sim, local_being);
+            for (i=0; i<SOCIAL_SIZE; i++)
+            {
+                if (!SOCIAL_GRAPH_ENTRY_EMPTY(local_social_graph,i))
+                {
+                    part->social_links++;
+                    part->cohesion += (n_uint)(local_social_graph[i].friend_foe);
+                    part->familiarity += (n_uint)(local_social_graph[i].familiarity);
+                    part->amorousness += (n_uint)(local_social_graph[i].attraction);
+                }
+            }
+
+            /* average genome */
+            for (n=0; n<8*CHROMOSOMES; n++)
+            {
+                part->genome[n] += GET_NUCLEOTIDE(GET_G(local_being),n);
+            }
+
+#ifdef BRAINCODE_ON
+            /* average braincode and the kinds of instruction */
+            for (n=0; n<BRAINCODE_SIZE; n++)
+            {
+                part->braincode[n] += (n_uint)GET_BRAINCODE_INTERNAL(sim,local_being)[n];
+                part->braincode[n+BRAINCODE_SIZE] += (n_uint)GET_BRAINCODE_EXTERNAL(sim,local_being)[n];
+            }
+            braincode_statistics_being(sim, local_being, part->braincode_kinds);
 #endif
 
 #ifdef IMMUNE_ON
-    indicators->average_antibodies = (n_byte2)(average_antibodies/sim->num);
-    indicators->average_antigens = (n_byte2)(average_antigens/sim->num);
+            /* immune system */
+            immune = GET_IM(sim, local_being);
+            for (n=0; n<IMMUNE_ANTIGENS; n++)
+            {
+                part->antigens += (n_uint)immune->antigens[n];
+            }
+            for (n=0; n<IMMUNE_POPULATION; n++)
+            {
+                part->antibodies += (n_uint)immune->antibodies[n];
+            }
 #endif
+            b++;
+        }
+        start++;
+    }
+}
 
-    if (sim->indicators_logging!=0)
+/* sums the deviations from the means in the total over each part of the beings */
+static void sim_indicators_deviation(noble_simulation * sim, n_uint start, n_uint end)
+{
+    noble_indicators_part * mean = &(sim->indicators_parts[INDICATORS_PARTS]);
+    while (start < end)
     {
-        sprintf((char*)filename,"indicators%u.csv",(unsigned int)sim->indicators_logging);
-        fp = fopen(filename,"r");
-        if (fp==NULL)
+        noble_indicators_part * part = &(sim->indicators_parts[start]);
+        n_uint b, last;
+        n_uint family_sd = 0, genetics_sd = 0, ideology_sd = 0;
+        n_int n, diff;
+
+        sim_indicators_span(sim, start, &b, &last);
+
+        while (b < last)
         {
-            fp = fopen(filename,"w");
-            if (fp!=NULL)
+            noble_being * local_being = &(sim->beings[b]);
+
+            diff = (n_int)ABS(GET_FAMILY_FIRST_NAME(sim,local_being) - (n_int)mean->family[0]);
+            family_sd += (n_uint)diff;
+            diff = (n_int)ABS(GET_FAMILY_SECOND_NAME(sim,local_being) - (n_int)mean->family[1]);
+            family_sd += (n_uint)diff;
+
+            for (n=0; n<8*CHROMOSOMES; n++)
             {
-                fprintf(fp,"%s","Population,Drownings,Parasites,Average Parasite Mobility (x100),Average Chat (x100),Average Age (days),Average Mobility,Average Energy,Average Energy Input,Average Energy Output,Average Amorousness,Average Cohesion (x100),Average Familiarity,Average Social Links (x100),Average Positive Affect (x100),Average Negative Affect (x100),Average Antigens,Average Antibodies,Ideological Variation,Genetic Variation,Family Name Variation,");
-                fprintf(fp,"%s","Average Shouts,Average Listens,Average Grooming (x100),Average Brainprobe Activity (x100),Average Hunger,Average Social Drive,Average Fatigue,Average Sex Drive,Food (Vegetable),Food (Fruit),Food (Shellfish),Food (Seaweed),Average First Person Percent,Average Intentions Percent,Average Braincode Sensors,Average Braincode Actuators,Average Braincode Operators,Average Braincode Conditionals,Average Braincode Data\n");
+                diff = (n_int)ABS(GET_NUCLEOTIDE(GET_G(local_being),n) - (n_int)mean->genome[n]);
+                genetics_sd += (n_uint)diff;
             }
+#ifdef BRAINCODE_ON
+            for (n=0; n<BRAINCODE_SIZE; n++)
+            {
+                diff = ABS((n_int)(GET_BRAINCODE_INTERNAL(sim,local_being)[n]) - (n_int)mean->braincode[n]);
+                ideology_sd += (n_uint)diff;
+
+                diff = ABS((n_int)(GET_BRAINCODE_EXTERNAL(sim,local_being)[n]) - (n_int)mean->braincode[n+BRAINCODE_SIZE]);
+                ideology_sd += (n_uint)diff;
+            }
+#endif
+            b++;
         }
-        else
-        {
-            fclose(fp);
-            fp  =fopen(filename,"a");
-        }
-        if (fp!=NULL)
+        part->family_sd = family_sd;
+        part->genetics_sd = genetics_sd;
+        part->ideology_sd = ideology_sd;
+        start++;
+    }
+}
+
+/* adds the parts of the beings together into the total after them */
+static noble_indicators_part * sim_indicators_total(noble_simulation * sim)
+{
+    noble_indicators_part * total = &(sim->indicators_parts[INDICATORS_PARTS]);
+    n_uint * total_sums = (n_uint *)total;
+    n_uint part = 0;
+    io_erase((n_byte *)total, sizeof(noble_indicators_part));
+    while (part < INDICATORS_PARTS)
+    {
+        n_uint * sums = (n_uint *)&(sim->indicators_parts[part]);
+        n_uint loop = 0;
+        while (loop < (sizeof(noble_indicators_part) / sizeof(n_uint)))
         {
-            fprintf(fp,"%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
-                    (unsigned int)indicators->population,
-                    (unsigned int)indicators->drownings,
-                    (unsigned int)indicators->parasites,
-                    (unsigned int)indicators->average_parasite_mobility,
-                    (unsigned int)indicators->average_chat,
-                    (unsigned int)indicators->average_age_days,
-                    (unsigned int)indicators->average_mobility,
-                    (unsigned int)indicators->average_energy,
-                    (unsigned int)indicators->average_energy_input,
-                    (unsigned int)indicators->average_energy_output,
-                    (unsigned int)indicators->average_amorousness,
-                    (unsigned int)indicators->average_cohesion,
-                    (unsigned int)indicators->average_familiarity,
-                    (unsigned int)indicators->average_social_links,
-                    (unsigned int)indicators->average_positive_affect,
-                    (unsigned int)indicators->average_negative_affect,
-                    (unsigned int)indicators->average_antigens,
-                    (unsigned int)indicators->average_antibodies,
-                    (unsigned int)indicators->ideology_sd,
-                    (unsigned int)indicators->genetics_sd,
-                    (unsigned int)indicators->family_name_sd,
-                    (unsigned int)indicators->average_shouts,
-                    (unsigned int)indicators->average_listens,
-                    (unsigned int)indicators->average_grooming,
-                    (unsigned int)indicators->average_brainprobe_activity,
-                    (unsigned int)indicators->drives[DRIVE_HUNGER],
-                    (unsigned int)indicators->drives[DRIVE_SOCIAL],
-                    (unsigned int)indicators->drives[DRIVE_FATIGUE],
-                    (unsigned int)indicators->drives[DRIVE_SEX],
-                    (unsigned int)indicators->food[FOOD_VEGETABLE],
-                    (unsigned int)indicators->food[FOOD_FRUIT],
-                    (unsigned int)indicators->food[FOOD_SHELLFISH],
-                    (unsigned int)indicators->food[FOOD_SEAWEED],
-                    (unsigned int)indicators->average_first_person,
-                    (unsigned int)indicators->average_intentions,
-                    (unsigned int)indicators->average_sensors,
-                    (unsigned int)indicators->average_actuators,
-                    (unsigned int)indicators->average_operators,
-                    (unsigned int)indicators->average_conditionals,
-                    (unsigned int)indicators->average_data);
-            fclose(fp);
+            total_sums[loop] += sums[loop];
+            loop++;
         }
+        part++;
+    }
+    return total;
+}
+
+/*
+ * The indicators are gathered in two looks at the beings split over the
+ * threads. The first sums everything over each part of the beings, the
+ * second the deviations from the means of those sums.
+ */
+static void sim_indicators(noble_simulation * sim)
+{
+    noble_indicators * indicators;
+    noble_indicators_part * total;
+    n_uint num = sim->num;
+    n_int i,n;
+
+    if (SIM_SCHEDULED(sim, SCHEDULE_INDICATORS) == 0) return;
+
+    indicators = &(sim->indicators_base[sim->indicator_index]);
+    indicators->population = (n_byte2)(sim->num);
+    if ((sim->num==0) || (sim->indicators_parts == 0L))
+    {
+        return;
+    }
+
+    sim_parallel(sim, &sim_indicators_sum, INDICATORS_PARTS);
+    total = sim_indicators_total(sim);
+
+    for (i=0; i<8*8; i++)
+    {
+        indicators->population_density[i] = (n_byte2)total->population_density[i];
+    }
+    indicators->average_age_days += total->age_days;
+#ifdef PARASITES_ON
+    indicators->parasites = total->parasites;
+#else
+    indicators->parasites = 0;
+#endif
+    indicators->average_antigens = 0;
+    indicators->average_antibodies = 0;
+
+    indicators->average_brainprobe_activity = indicators->average_brainprobe_activity/num;
+    indicators->average_parasite_mobility = (n_byte2)((n_uint)indicators->average_parasite_mobility*100/num);
+    indicators->average_grooming = (n_byte2)((n_uint)indicators->average_grooming*100/num);
+    indicators->average_shouts = (n_byte2)(((n_uint)(indicators->average_shouts)*100)/num);
+    indicators->average_listens = (n_byte2)(((n_uint)(indicators->average_shouts)*100)/num);
+    indicators->average_chat = (n_byte2)((indicators->average_chat * 100) / num);
+    indicators->average_age_days /= num;
+    indicators->average_energy_input /= num;
+    indicators->average_energy_output /= num;
+    indicators->average_mobility /= (n_byte2)num;
+    indicators->average_social_links = (n_byte2)((total->social_links*100) / num);
+    indicators->average_positive_affect = (n_uint)((total->positive_affect*100) / num);
+    indicators->average_negative_affect = (n_uint)((total->negative_affect*100) / num);
+    indicators->average_energy = (n_byte2)(total->energy / num);
+    indicators->average_first_person = (n_byte2)(total->first_person * 10 / num);
+    indicators->average_intentions = (n_byte2)(total->intentions * 10 / num);
+    indicators->dormant_brains = (n_byte2)(total->dormant_brains * 100 / num);
+#ifdef BRAINCODE_ON
+    indicators->average_sensors = (n_byte2)(total->braincode_kinds[3]*10/num);
+    indicators->average_actuators = (n_byte2)(total->braincode_kinds[4]*10/num);
+    indicators->average_operators = (n_byte2)(total->braincode_kinds[1]*10/num);
+    indicators->average_conditionals = (n_byte2)(total->braincode_kinds[2]*10/num);
+    indicators->average_data = (n_byte2)(total->braincode_kinds[0]*10/num);
+#endif
+    if (total->social_links>0)
+    {
+        indicators->average_cohesion = (n_byte2)((total->cohesion*100) / total->social_links);
+        indicators->average_familiarity = (n_byte)(total->familiarity / total->social_links);
+        indicators->average_amorousness = (n_byte)(total->amorousness / total->social_links);
+    }
+    else
+    {
+        indicators->average_cohesion = SOCIAL_RESPECT_NORMAL*100;
+        indicators->average_familiarity=0;
+        indicators->average_amorousness=0;
+    }
+
+    /* drives */
+    for (i=0; i<DRIVES; i++)
+    {
+        indicators->drives[i] = (n_byte2)((total->drives[i]*100) / num);
+    }
+
+#ifdef IMMUNE_ON
+    indicators->average_antibodies = (n_byte2)(total->antibodies/num);
+    indicators->average_antigens = (n_byte2)(total->antigens/num);
+#endif
+
+    /* the means the deviations are from */
+    for (i=0; i<2; i++)
+    {
+        total->family[i] /= num;
+    }
+    for (n=0; n<8*CHROMOSOMES; n++)
+    {
+        total->genome[n] /= num;
+    }
+#ifdef BRAINCODE_ON
+    for (n=0; n<BRAINCODE_SIZE*2; n++)
+    {
+        total->braincode[n] /= num;
+    }
+#endif
+
+    sim_parallel(sim, &sim_indicators_deviation, INDICATORS_PARTS);
+
+    total->family_sd = 0;
+    total->genetics_sd = 0;
+    total->ideology_sd = 0;
+    for (i=0; i<INDICATORS_PARTS; i++)
+    {
+        total->family_sd += sim->indicators_parts[i].family_sd;
+        total->genetics_sd += sim->indicators_parts[i].genetics_sd;
+        total->ideology_sd += sim->indicators_parts[i].ideology_sd;
+    }
+
+    /* family name, genetics and ideology variance */
+    indicators->family_name_sd = (n_byte2)((total->family_sd*100) / num);
+    indicators->genetics_sd = (n_byte2)((total->genetics_sd*100)/num);
+#ifdef BRAINCODE_ON
+    indicators->ideology_sd = (n_byte2)(total->ideology_sd/num);
+#endif
+
+    if (sim->indicators_logging!=0)
+    {
+        sim_indicators_log(sim, sim->indicators_logging, indicators);
     }
 
     /* increment index within the buffer */
@@ -1006,32 +1731,496 @@ static void sim_indicators(noble_simulation * sim)
     io_erase((n_byte *)indicators, sizeof(noble_indicators));
 }
 
+/* the time in nanoseconds each phase took over the last PROFILE_SAMPLES cycles */
+
+/*! @struct
+ @field on Each phase of the cycle is timed.
+ @field csv The statistics are appended to profile.csv every PROFILE_SAMPLES cycles.
+ @field count The cycles profiled.
+ @field sample The nanoseconds each phase took.
+ @field beings The beings of each cycle sampled.
+ @field last The nanoseconds each phase of the last cycle timed took.
+ @field telemetry The shared memory the telemetry is published to, 0L when it is not.
+ @field telemetry_index The index of the next indicators to publish.
+ */
+struct noble_profile
+{
+    n_byte            on;
+    n_byte            csv;
+    n_uint            count;
+    n_uint            sample[PROFILE_PHASES][PROFILE_SAMPLES];
+    n_uint            beings[PROFILE_SAMPLES];
+    n_uint            last[PROFILE_PHASES];
+
+    noble_telemetry * telemetry;
+    n_uint            telemetry_index;
+};
+
+static const n_string profile_names[PROFILE_PHASES] =
+{
+    "land", "being", "weather", "brain", "dialogue", "tidy", "remove", "social", "indicators", "cycle"
+};
+
+/**
+ * Turns the cycle profile on or off. Turning it on starts new statistics.
+ * @param local_sim the simulation to profile.
+ * @param on non-zero to time each phase of the cycle.
+ * @param csv non-zero to append the statistics to profile.csv every PROFILE_SAMPLES cycles.
+ */
+void sim_profile(noble_simulation * local_sim, n_byte on, n_byte csv)
+{
+    noble_profile * local_profile = local_sim->profile;
+    if (on && (local_profile->on == 0))
+    {
+        local_profile->count = 0;
+    }
+    local_profile->on = on;
+    local_profile->csv = (n_byte)(on && csv);
+}
+
+static n_uint sim_profile_mark(noble_profile * local_profile, n_int phase, n_uint start)
+{
+    n_uint now = io_nanoseconds();
+    local_profile->last[phase] = now - start;
+    if (local_profile->on)
+    {
+        local_profile->sample[phase][local_profile->count % PROFILE_SAMPLES] = now - start;
+    }
+    return now;
+}
+
+/**
+ * The name of a phase of the simulation cycle.
+ * @param phase one of SIM_PROFILE_PHASES.
+ * @return the name.
+ */
+n_string sim_profile_name(n_int phase)
+{
+    return profile_names[phase];
+}
+
+/**
+ * The mean, median, 99th percentile and maximum nanoseconds taken by a phase
+ * over the last PROFILE_SAMPLES cycles profiled.
+ * @param local_sim the simulation profiled.
+ * @param phase one of SIM_PROFILE_PHASES.
+ * @param statistics the four statistics are written here.
+ * @return the number of cycles sampled, 0 if there are no statistics.
+ */
+n_uint sim_profile_statistics(noble_simulation * local_sim, n_int phase, n_uint * statistics)
+{
+    noble_profile * local_profile = local_sim->profile;
+    n_uint sorted[PROFILE_SAMPLES];
+    n_uint count = (local_profile->count < PROFILE_SAMPLES) ? local_profile->count : PROFILE_SAMPLES;
+    n_uint loop = 0, total = 0;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+    while (loop < count)
+    {
+        n_uint value = local_profile->sample[phase][loop];
+        n_uint position = loop;
+        while ((position > 0) && (sorted[position - 1] > value))
+        {
+            sorted[position] = sorted[position - 1];
+            position--;
+        }
+        sorted[position] = value;
+        total += value;
+        loop++;
+    }
+    statistics[0] = total / count;
+    statistics[1] = sorted[count / 2];
+    statistics[2] = sorted[(count * 99) / 100];
+    statistics[3] = sorted[count - 1];
+    return count;
+}
+
+static n_uint sim_profile_beings(noble_profile * local_profile)
+{
+    n_uint count = (local_profile->count < PROFILE_SAMPLES) ? local_profile->count : PROFILE_SAMPLES;
+    n_uint loop = 0, total = 0;
+    while (loop < count)
+    {
+        total += local_profile->beings[loop++];
+    }
+    if (total == 0)
+    {
+        return 1;
+    }
+    return (total + (count / 2)) / count;
+}
+
+static void sim_profile_csv(noble_simulation * local_sim)
+{
+    FILE * fp = fopen("profile.csv", "r");
+    n_uint beings = sim_profile_beings(local_sim->profile);
+    n_int  phase = 0;
+
+    if (fp == NULL)
+    {
+        fp = fopen("profile.csv", "w");
+        if (fp != NULL)
+        {
+            fprintf(fp, "%s", "Cycle,Phase,Mean (ns),Median (ns),99th Percentile (ns),Maximum (ns),Mean Per Being (ns)\n");
+        }
+    }
+    else
+    {
+        fclose(fp);
+        fp = fopen("profile.csv", "a");
+    }
+    if (fp == NULL)
+    {
+        return;
+    }
+    while (phase < PROFILE_PHASES)
+    {
+        n_uint statistics[4];
+        if (sim_profile_statistics(local_sim, phase, statistics))
+        {
+            fprintf(fp, "%u,%s,%u,%u,%u,%u,%u\n", (unsigned int)local_sim->profile->count, profile_names[phase],
+                    (unsigned int)statistics[0], (unsigned int)statistics[1],
+                    (unsigned int)statistics[2], (unsigned int)statistics[3],
+                    (unsigned int)(statistics[0] / beings));
+        }
+        phase++;
+    }
+    fclose(fp);
+}
+
+/**
+ * Shows the cycle profile in microseconds.
+ * @param local_sim the simulation profiled.
+ * @param output_function the function each line is shown with.
+ */
+void sim_profile_output(noble_simulation * local_sim, n_console_output output_function)
+{
+    n_string_block output;
+    n_uint         beings = sim_profile_beings(local_sim->profile);
+    n_int          phase = 0;
+
+    if (local_sim->profile->count == 0)
+    {
+        output_function("No cycles profiled");
+        return;
+    }
+    sprintf(output, "%-11s %10s %10s %10s %10s %10s", "Phase (us)", "Mean", "Median", "99%", "Max", "Per Being");
+    output_function(output);
+    while (phase < PROFILE_PHASES)
+    {
+        n_uint statistics[4];
+        (void)sim_profile_statistics(local_sim, phase, statistics);
+        sprintf(output, "%-11s %10.1f %10.1f %10.1f %10.1f %10.3f", profile_names[phase],
+                (double)statistics[0] / 1000, (double)statistics[1] / 1000,
+                (double)statistics[2] / 1000, (double)statistics[3] / 1000,
+                (double)statistics[0] / (1000 * beings));
+        output_function(output);
+        phase++;
+    }
+}
+
+/* the telemetry is shared with other processes, which copy it between two reads of the sequence */
+
+/**
+ * Publishes the telemetry of a simulation to shared memory for other
+ * processes to read, or stops publishing it. Only one simulation on the
+ * machine can publish at a time.
+ * @param local_sim the simulation to publish.
+ * @param on non-zero to publish the telemetry.
+ * @return 0 on success, -1 if there is no shared memory.
+ */
+n_int sim_telemetry(noble_simulation * local_sim, n_byte on)
+{
+    noble_profile   * local_profile = local_sim->profile;
+    noble_telemetry * telemetry = local_profile->telemetry;
+
+    if (on == 0)
+    {
+        if (telemetry != 0L)
+        {
+            io_shared_close(telemetry, sizeof(noble_telemetry), TELEMETRY_NAME);
+            local_profile->telemetry = 0L;
+        }
+        return 0;
+    }
+    if (telemetry != 0L)
+    {
+        return 0;
+    }
+    telemetry = (noble_telemetry *)io_shared_open(TELEMETRY_NAME, sizeof(noble_telemetry), 1);
+    if (telemetry == 0L)
+    {
+        return SHOW_ERROR("Telemetry shared memory not available");
+    }
+    io_erase((n_byte *)telemetry, sizeof(noble_telemetry));
+    telemetry->bytes = sizeof(noble_telemetry);
+    if (local_sim->indicators_base != 0L)
+    {
+        io_copy((n_byte *)local_sim->indicators_base, (n_byte *)telemetry->indicators,
+                INDICATORS_BUFFER_SIZE * sizeof(noble_indicators));
+    }
+    local_profile->telemetry_index = local_sim->indicator_index;
+    telemetry->indicator_index = local_profile->telemetry_index;
+    io_barrier();
+    io_copy((n_byte *)TELEMETRY_SIGNATURE, telemetry->signature, 8);
+    local_profile->telemetry = telemetry;
+    return 0;
+}
+
+/* only the indicators completed since the last cycle are copied */
+static void sim_telemetry_publish(noble_simulation * local_sim)
+{
+    noble_profile   * local_profile = local_sim->profile;
+    noble_telemetry * telemetry = local_profile->telemetry;
+    n_uint            index = local_profile->telemetry_index;
+    n_uint            sequence = telemetry->sequence;
+
+    telemetry->sequence = sequence + 1;
+    io_barrier();
+
+    telemetry->cycles++;
+    telemetry->date = TIME_IN_DAYS(local_sim->land->date);
+    telemetry->time = local_sim->land->time;
+    telemetry->population = local_sim->num;
+    telemetry->max = local_sim->max;
+    io_copy((n_byte *)local_profile->last, (n_byte *)telemetry->phase, sizeof(local_profile->last));
+    while (index != local_sim->indicator_index)
+    {
+        io_copy((n_byte *)&(local_sim->indicators_base[index]),
+                (n_byte *)&(telemetry->indicators[index]), sizeof(noble_indicators));
+        index = (index + 1) % INDICATORS_BUFFER_SIZE;
+        telemetry->indicators_complete++;
+    }
+    telemetry->indicator_index = index;
+    local_profile->telemetry_index = index;
+
+    io_barrier();
+    telemetry->sequence = sequence + 2;
+}
+
+/**
+ * Copies telemetry published by a simulation in another process. This does
+ * not wait on the simulation, it tries again if the simulation wrote to the
+ * telemetry while it was being copied.
+ * @param shared the telemetry mapped from TELEMETRY_NAME.
+ * @param copy the consistent copy.
+ * @return 0 on success, -1 if the telemetry is not ready or kept changing.
+ */
+n_int sim_telemetry_read(noble_telemetry * shared, noble_telemetry * copy)
+{
+    n_uint attempts = 0;
+
+    if ((io_same(shared->signature, (n_byte *)TELEMETRY_SIGNATURE, 8) == 0) ||
+            (shared->bytes != sizeof(noble_telemetry)))
+    {
+        return SHOW_ERROR("Telemetry not from this version of the simulation");
+    }
+    while (attempts < 1000)
+    {
+        n_uint sequence = shared->sequence;
+        io_barrier();
+        if ((sequence & 1) == 0)
+        {
+            io_copy((n_byte *)shared, (n_byte *)copy, sizeof(noble_telemetry));
+            io_barrier();
+            if (shared->sequence == sequence)
+            {
+                copy->sequence = sequence;
+                return 0;
+            }
+        }
+        attempts++;
+    }
+    return SHOW_ERROR("Telemetry changed while it was read");
+}
+
+/*
+ each phase of the schedule runs on the minutes where the minutes since the start of the date, modulo its period, are its offset.
+ sleep is the exception, every minute some of the fully asleep beings have their turn at the brain probes, brain and dialogue,
+ the ones with their brain memory location the same modulo the period. The rest of the sleepers wait their turn with their
+ metabolism, immune response, energy and whether they wake kept up to date as for any being, a being that wakes is cycled in
+ full from that minute. the brain and dialogue minutes off a sleeper's turn are dropped and not made up when it wakes, so with a
+ sleep period of N they go about 1/N as far over a night as they would every minute. a sleep period of 1, as in the full
+ profile, cycles every sleeper every minute.
+ */
+
+static const n_string schedule_names[SCHEDULE_PHASES] =
+{
+    "weather", "social", "episodic", "metabolism", "immune", "indicators", "sleep"
+};
+
+/* the periods then the offsets of each fidelity profile, the fast profile runs the slow phases on different minutes */
+static const n_byte2 schedule_profiles[SCHEDULE_PROFILES][2][SCHEDULE_PHASES] =
+{
+    {{1, 1, 1, 1, 1, INDICATORS_FREQUENCY, 1}, {0, 0, 0, 0, 0, 0, 0}},
+    {{4, 10, 4, 1, 2, INDICATORS_FREQUENCY, 8}, {0, 5, 2, 0, 1, 0, 0}}
+};
+
+/**
+ * Sets a schedule to one of the fidelity profiles.
+ * @param schedule The schedule to be set.
+ * @param profile SCHEDULE_FULL runs every phase as often as it always has,
+ * SCHEDULE_FAST runs the slowly changing phases less often.
+ */
+void sim_schedule_profile(noble_schedule * schedule, n_int profile)
+{
+    n_int phase = 0;
+    while (phase < SCHEDULE_PHASES)
+    {
+        schedule->period[phase] = schedule_profiles[profile][0][phase];
+        schedule->offset[phase] = schedule_profiles[profile][1][phase];
+        phase++;
+    }
+}
+
+/**
+ * Brings a schedule read from a file into range.
+ * @param schedule The schedule to be checked.
+ */
+void sim_schedule_check(noble_schedule * schedule)
+{
+    n_int phase = 0;
+    while (phase < SCHEDULE_PHASES)
+    {
+        if ((schedule->period[phase] == 0) || (schedule->period[phase] > SCHEDULE_PERIOD_MAX))
+        {
+            schedule->period[phase] = schedule_profiles[SCHEDULE_FULL][0][phase];
+        }
+        schedule->offset[phase] = (n_byte2)(schedule->offset[phase] % schedule->period[phase]);
+        phase++;
+    }
+}
+
+/**
+ * Sets how often a phase of the cycle runs.
+ * @param local_sim The simulation.
+ * @param phase One of SIM_SCHEDULE_PHASES.
+ * @param period The minutes between each run, 1 to SCHEDULE_PERIOD_MAX.
+ * @param offset The minute within the period it runs on.
+ * @return 0 if the phase is scheduled, -1 if the values are out of range.
+ */
+n_int sim_schedule_set(noble_simulation * local_sim, n_int phase, n_uint period, n_uint offset)
+{
+    if ((phase < 0) || (phase >= SCHEDULE_PHASES))
+    {
+        return SHOW_ERROR("Schedule phase not found");
+    }
+    if ((period == 0) || (period > SCHEDULE_PERIOD_MAX) || (offset >= period))
+    {
+        return SHOW_ERROR("Schedule period or offset out of range");
+    }
+    local_sim->schedule.period[phase] = (n_byte2)period;
+    local_sim->schedule.offset[phase] = (n_byte2)offset;
+    return 0;
+}
+
+n_string sim_schedule_name(n_int phase)
+{
+    return schedule_names[phase];
+}
+
+/**
+ * Finds the scheduled phase with a name.
+ * @param name The name of the phase.
+ * @return One of SIM_SCHEDULE_PHASES or -1 if there is no phase with the name.
+ */
+n_int sim_schedule_find(n_string name)
+{
+    n_int phase = 0;
+    n_int length = io_length(name, STRING_BLOCK_SIZE);
+    while (phase < SCHEDULE_PHASES)
+    {
+        if ((io_length(schedule_names[phase], STRING_BLOCK_SIZE) == length) &&
+                (io_find(name, 0, length, schedule_names[phase], length) > -1))
+        {
+            return phase;
+        }
+        phase++;
+    }
+    return -1;
+}
+
+/* finds the phases run this cycle, after the land has moved on to its minute */
+static void sim_schedule(noble_simulation * local_sim)
+{
+    n_land * land = local_sim->land;
+    n_uint   minutes = (TIME_IN_DAYS(land->date) * TIME_DAY_MINUTES) + land->time;
+    n_uint   scheduled = 0;
+    n_int    phase = 0;
+
+    while (phase < SCHEDULE_PHASES)
+    {
+        if ((minutes % local_sim->schedule.period[phase]) == local_sim->schedule.offset[phase])
+        {
+            scheduled |= (1 << phase);
+        }
+        phase++;
+    }
+    local_sim->scheduled = scheduled;
+    local_sim->sleep_turn = (minutes + local_sim->schedule.period[SCHEDULE_SLEEP] - local_sim->schedule.offset[SCHEDULE_SLEEP])
+                            % local_sim->schedule.period[SCHEDULE_SLEEP];
+}
+
 /* this is a protoype for the order of these functions it is not used here explicitly */
 
-void sim_cycle(void)
+#define SIM_PROFILE(phase)  if (profile) profile_mark = sim_profile_mark(local_sim->profile, phase, profile_mark)
+
+static void sim_cycle_phases(noble_simulation * local_sim, n_byte profile)
 {
-#ifndef THREADED
+    n_uint profile_mark = 0;
 
-    land_cycle(sim.land);
-    sim_being(&sim);    /* 2 */
+    if (profile)
+    {
+        profile_mark = io_nanoseconds();
+    }
+
+    land_cycle(local_sim->land);
+    sim_schedule(local_sim);
+    SIM_PROFILE(PROFILE_LAND);
+    sim_being(local_sim);    /* 2 */
+    SIM_PROFILE(PROFILE_BEING);
 #ifdef WEATHER_ON
-    weather_cycle(sim.land, sim.weather);
+    if (SIM_SCHEDULED(local_sim, SCHEDULE_WEATHER))
+    {
+        sim_weather(local_sim);
+    }
 #endif
-    sim_brain(&sim);    /* 4 */
+    SIM_PROFILE(PROFILE_WEATHER);
+    sim_brain(local_sim);    /* 4 */
+    SIM_PROFILE(PROFILE_BRAIN);
 
 #ifdef BRAINCODE_ON
-    sim_brain_dialogue(&sim);
+    sim_brain_dialogue(local_sim);
 #endif
+    SIM_PROFILE(PROFILE_DIALOGUE);
     
 #ifdef BRAIN_HASH
-    sim_brain_hash(&sim)
+    if (local_sim == &sim)
+    {
+        sim_brain_hash(local_sim);
+    }
 #endif
-    being_tidy(&sim);
-    being_remove(&sim); /* 6 */
-    sim_social(&sim);
-    sim_indicators(&sim);
-    sim_time(&sim);
+    being_tidy(local_sim);
+    SIM_PROFILE(PROFILE_TIDY);
+    being_remove(local_sim); /* 6 */
+    SIM_PROFILE(PROFILE_REMOVE);
+    if (SIM_SCHEDULED(local_sim, SCHEDULE_SOCIAL))
+    {
+        sim_social(local_sim);
+    }
+    SIM_PROFILE(PROFILE_SOCIAL);
+    sim_indicators(local_sim);
+    SIM_PROFILE(PROFILE_INDICATORS);
+    sim_time(local_sim);
+}
 
+void sim_cycle(void)
+{
+#ifndef THREADED
+    sim_world_cycle(&sim);
 #endif
 }
 
@@ -1040,85 +2229,102 @@ void sim_cycle(void)
 
 #ifdef SMALL_LAND
 
-#define	MINIMAL_ALLOCATION	(sizeof(n_land)+(MAP_AREA)+(512*512)+(TERRAIN_WINDOW_AREA)+((sizeof(noble_being) + DOUBLE_BRAIN) * MIN_BEINGS)+1+(sizeof(n_uint)*2)+(INDICATORS_BUFFER_SIZE*sizeof(noble_indicators)))
+#define	MINIMAL_ALLOCATION	(sizeof(n_land)+(MAP_AREA)+(512*512)+(TERRAIN_WINDOW_AREA)+((sizeof(noble_being) + sizeof(noble_being_cold) + DOUBLE_BRAIN) * MIN_BEINGS)+1+(sizeof(n_uint)*2)+(INDICATORS_BUFFER_SIZE*sizeof(noble_indicators)))
 
 #else
 
 #ifdef BRAIN_ON
 
-#define	MINIMAL_ALLOCATION	(sizeof(n_land)+(MAP_AREA)+(2*HI_RES_MAP_AREA)+(HI_RES_MAP_AREA/8)+(512*512)+(TERRAIN_WINDOW_AREA)+((sizeof(noble_being) + DOUBLE_BRAIN) * MIN_BEINGS)+1+(sizeof(n_uint)*2)+(INDICATORS_BUFFER_SIZE*sizeof(noble_indicators)))
+#define	MINIMAL_ALLOCATION	(sizeof(n_land)+(MAP_AREA)+(2*HI_RES_MAP_AREA)+(HI_RES_MAP_AREA/8)+(512*512)+(TERRAIN_WINDOW_AREA)+((sizeof(noble_being) + sizeof(noble_being_cold) + DOUBLE_BRAIN) * MIN_BEINGS)+1+(sizeof(n_uint)*2)+(INDICATORS_BUFFER_SIZE*sizeof(noble_indicators)))
 
 #else
 
-#define	MINIMAL_ALLOCATION	(sizeof(n_land)+(MAP_AREA)+(2*HI_RES_MAP_AREA)+(HI_RES_MAP_AREA/8)+(512*512)+(TERRAIN_WINDOW_AREA)+((sizeof(noble_being)) * MIN_BEINGS)+1+(sizeof(n_uint)*2)+(INDICATORS_BUFFER_SIZE*sizeof(noble_indicators)))
+#define	MINIMAL_ALLOCATION	(sizeof(n_land)+(MAP_AREA)+(2*HI_RES_MAP_AREA)+(HI_RES_MAP_AREA/8)+(512*512)+(TERRAIN_WINDOW_AREA)+((sizeof(noble_being) + sizeof(noble_being_cold)) * MIN_BEINGS)+1+(sizeof(n_uint)*2)+(INDICATORS_BUFFER_SIZE*sizeof(noble_indicators)))
 
 #endif
 
 #endif
 
-static void sim_memory(n_uint offscreen_size)
+static n_int sim_memory(noble_simulation * local_sim, n_uint offscreen_size)
 {
     n_uint	current_location = 0;
     n_uint  memory_allocated = MAXIMUM_ALLOCATION;
     n_uint  lpx = 0;
 
-    offbuffer = io_new_range(offscreen_size + MINIMAL_ALLOCATION, &memory_allocated);
+    n_byte *memory = io_new_range(offscreen_size + MINIMAL_ALLOCATION, &memory_allocated);
+
+    if (memory == 0L)
+    {
+        return SHOW_ERROR("Simulation memory not available");
+    }
+
+    local_sim->memory = memory;
+    local_sim->braindisplay = 3;
+    local_sim->interpret = 0L;
+    local_sim->threads = 0;
+    sim_schedule_profile(&(local_sim->schedule), SCHEDULE_FULL);
+    local_sim->scheduled = 0;
+    local_sim->sleep_turn = 0;
 
     current_location = offscreen_size;
 
-    sim.land = (n_land *) & offbuffer[ current_location ];
+    local_sim->land = (n_land *) & memory[ current_location ];
 
     current_location += sizeof(n_land);
 
-    sim.land -> map = &offbuffer[ current_location ];
+    local_sim->land -> map = &memory[ current_location ];
 
     current_location += (MAP_AREA);
 
 #ifndef SMALL_LAND
 
-    sim.highres = &offbuffer[ current_location ];
+    local_sim->highres = &memory[ current_location ];
 
     current_location += (2 * HI_RES_MAP_AREA);
 
-    sim.highres_tide = (n_c_uint *) &offbuffer[ current_location ];
+    local_sim->highres_tide = (n_c_uint *) &memory[ current_location ];
 
     current_location += (HI_RES_MAP_AREA/8);
 
 #endif
 
-    sim.weather = (n_weather *) &offbuffer[ current_location ];
+    local_sim->weather = (n_weather *) &memory[ current_location ];
 
     current_location += sizeof(n_weather);
 
     memory_allocated -= (offscreen_size + current_location);
 #ifdef LARGE_SIM
-    sim.max = LARGE_SIM;
+    local_sim->max = LARGE_SIM;
 #else
 #ifdef BRAIN_ON
-    sim.max = memory_allocated / (sizeof(noble_being) + DOUBLE_BRAIN + (SOCIAL_SIZE * sizeof(social_link)) + (EPISODIC_SIZE * sizeof(episodic_memory)) + INDICATORS_BUFFER_SIZE * sizeof(noble_indicators));
+    local_sim->max = memory_allocated / (sizeof(noble_being) + sizeof(noble_being_cold) + DOUBLE_BRAIN + (SOCIAL_SIZE * sizeof(social_link)) + (EPISODIC_SIZE * sizeof(episodic_memory)) + INDICATORS_BUFFER_SIZE * sizeof(noble_indicators));
 #else
-    sim.max = memory_allocated / (sizeof(noble_being) + (SOCIAL_SIZE * sizeof(social_link)) + (EPISODIC_SIZE * sizeof(episodic_memory)) + INDICATORS_BUFFER_SIZE * sizeof(noble_indicators));
+    local_sim->max = memory_allocated / (sizeof(noble_being) + sizeof(noble_being_cold) + (SOCIAL_SIZE * sizeof(social_link)) + (EPISODIC_SIZE * sizeof(episodic_memory)) + INDICATORS_BUFFER_SIZE * sizeof(noble_indicators));
 #endif
 #endif
-    sim.beings = (noble_being *) & offbuffer[ current_location ];
-    current_location += sizeof(noble_being) * sim.max ;
+    local_sim->beings = (noble_being *) & memory[ current_location ];
+    current_location += sizeof(noble_being) * local_sim->max ;
+
+    local_sim->cold_base = (noble_being_cold *) & memory[ current_location ];
+    io_erase((n_byte *)local_sim->cold_base, local_sim->max * sizeof(noble_being_cold));
+    current_location += sizeof(noble_being_cold) * local_sim->max ;
 
 #ifdef BRAIN_ON
 
-    sim.brain_base = &offbuffer[ current_location  ];
-    io_erase(sim.brain_base, sim.max * DOUBLE_BRAIN);
+    local_sim->brain_base = &memory[ current_location  ];
+    io_erase(local_sim->brain_base, local_sim->max * DOUBLE_BRAIN);
 
-    current_location += (sim.max * DOUBLE_BRAIN);
+    current_location += (local_sim->max * DOUBLE_BRAIN);
 #endif
-    sim.social_base = (social_link *) &offbuffer[current_location];
-    io_erase((n_byte *)sim.social_base, sim.max * (SOCIAL_SIZE * sizeof(social_link)));
-    current_location += (sizeof(n_uint)*2) + (sim.max * (SOCIAL_SIZE * sizeof(social_link)));
-    sim.episodic_base = (episodic_memory *) &offbuffer[current_location];
-    io_erase((n_byte *)sim.episodic_base, sim.max * (EPISODIC_SIZE * sizeof(episodic_memory)));
-    current_location += (sizeof(n_uint)*2) + (sim.max * (EPISODIC_SIZE * sizeof(episodic_memory)));
-    while (lpx < sim.max)
-    {
-        noble_being * local = &(sim.beings[ lpx ]);
+    local_sim->social_base = (social_link *) &memory[current_location];
+    io_erase((n_byte *)local_sim->social_base, local_sim->max * (SOCIAL_SIZE * sizeof(social_link)));
+    current_location += (sizeof(n_uint)*2) + (local_sim->max * (SOCIAL_SIZE * sizeof(social_link)));
+    local_sim->episodic_base = (episodic_memory *) &memory[current_location];
+    io_erase((n_byte *)local_sim->episodic_base, local_sim->max * (EPISODIC_SIZE * sizeof(episodic_memory)));
+    current_location += (sizeof(n_uint)*2) + (local_sim->max * (EPISODIC_SIZE * sizeof(episodic_memory)));
+    while (lpx < local_sim->max)
+    {
+        noble_being * local = &(local_sim->beings[ lpx ]);
 #ifdef BRAIN_ON
         local->brain_memory_location = (n_byte2)lpx;
 #else
@@ -1126,10 +2332,58 @@ static void sim_memory(n_uint offscreen_size)
 #endif
         lpx ++;
     }
-    sim.indicators_base = (noble_indicators*)&offbuffer[ current_location  ];
-    io_erase((n_byte *)sim.indicators_base, INDICATORS_BUFFER_SIZE * sizeof(noble_indicators));
-    sim.indicator_index = 0;
-    sim.indicators_logging=0;
+    local_sim->indicators_base = (noble_indicators*)&memory[ current_location  ];
+    io_erase((n_byte *)local_sim->indicators_base, INDICATORS_BUFFER_SIZE * sizeof(noble_indicators));
+    local_sim->indicator_index = 0;
+    local_sim->indicators_logging=0;
+
+    local_sim->space_head = 0L;
+    local_sim->space_next = 0L;
+    (void)being_space_init(local_sim);
+
+    local_sim->name_index = 0L;
+    local_sim->female_index = 0L;
+    local_sim->name_next = 0L;
+    local_sim->name_last = 0L;
+    (void)being_index_init(local_sim);
+
+    local_sim->food_map = 0L;
+    (void)food_map_init(local_sim);
+    being_water_init(local_sim);
+
+    local_sim->senses = (noble_senses *)io_new(local_sim->max * sizeof(noble_senses));
+    local_sim->senses_num = 0;
+
+    local_sim->braincode_steps = 0L;
+#ifdef BRAINCODE_ON
+    local_sim->braincode_steps = (noble_braincode_steps *)io_new(local_sim->max * SOCIAL_SIZE * sizeof(noble_braincode_steps));
+    brain_braincode_reset(local_sim);
+#endif
+
+    local_sim->indicators_parts = (noble_indicators_part *)io_new((INDICATORS_PARTS + 1) * sizeof(noble_indicators_part));
+
+    local_sim->profile = (noble_profile *)io_new(sizeof(noble_profile));
+    if (local_sim->profile != 0L)
+    {
+        io_erase((n_byte *)local_sim->profile, sizeof(noble_profile));
+    }
+    local_sim->checkpoint = file_checkpoint_new();
+    if ((local_sim->profile == 0L) || (local_sim->checkpoint == 0L))
+    {
+        return SHOW_ERROR("Not enough memory for the simulation");
+    }
+
+    local_sim->brain_rest = 0L;
+    local_sim->slots = 0L;
+#ifdef BRAIN_ON
+    local_sim->brain_rest = (noble_brain_rest *)io_new(local_sim->max * sizeof(noble_brain_rest));
+    local_sim->slots = (noble_being_slot *)io_new(local_sim->max * sizeof(noble_being_slot));
+    if (local_sim->slots != 0L)
+    {
+        io_erase((n_byte *)local_sim->slots, local_sim->max * sizeof(noble_being_slot));
+    }
+#endif
+    return 0;
 }
 
 #ifndef SMALL_LAND
@@ -1157,55 +2411,149 @@ void sim_tide_block(n_byte * small_map, n_byte * map, n_c_uint * tide_block)
 
 #endif
 
-void * sim_init(KIND_OF_USE kind, n_uint randomise, n_uint offscreen_size, n_uint landbuffer_size)
+/* the tables shared by all the simulations are set up once, whichever thread makes the first simulation */
+static void sim_tables_init(void)
+{
+    (void)brain_cycle_init();
+    (void)weather_cycle_init();
+#ifdef BRAINCODE_ON
+    brain_dialogue_init();
+#endif
+}
+
+#ifndef	_WIN32
+
+static pthread_once_t sim_tables_once = PTHREAD_ONCE_INIT;
+
+static void sim_tables(void)
+{
+    (void)pthread_once(&sim_tables_once, sim_tables_init);
+}
+
+#else
+
+static void sim_tables(void)
+{
+    static n_byte tables_ready = 0;
+    if (tables_ready == 0)
+    {
+        sim_tables_init();
+        tables_ready = 1;
+    }
+}
+
+#endif
+
+static void sim_start(noble_simulation * local_sim, KIND_OF_USE kind, n_uint randomise, n_uint landbuffer_size)
 {
     n_byte2	local_random[2];
-    sim.delta_cycles = 0;
-    sim.count_cycles = 0;
-    sim.real_time = randomise;
-    sim.last_time = randomise;
+    local_sim->delta_cycles = 0;
+    local_sim->count_cycles = 0;
+    local_sim->real_time = randomise;
+    local_sim->last_time = randomise;
 
-    sim.ext_birth = 0L;
-    sim.ext_death = 0L;
+    local_sim->ext_birth = 0L;
+    local_sim->ext_death = 0L;
 #ifdef FIXED_RANDOM_SIM
     randomise = FIXED_RANDOM_SIM;
 #endif
-    if ((kind == KIND_START_UP) || (kind == KIND_MEMORY_SETUP))
+    /* the beings are replaced so the indexes are stale */
+    local_sim->space_num = NO_BEINGS_FOUND;
+    local_sim->index_num = NO_BEINGS_FOUND;
+
+    /* new and loaded beings have the memory at the location of their index */
+    being_slots_rebuild(local_sim, 1);
+
+    /* new and loaded brains are all cycled until they come to rest again */
+    if (local_sim->brain_rest != 0L)
     {
-        sim_memory(offscreen_size);
+        io_erase((n_byte *)local_sim->brain_rest, local_sim->max * sizeof(noble_brain_rest));
     }
+#ifdef BRAINCODE_ON
+    /* and their braincode is decoded again */
+    brain_braincode_reset(local_sim);
+#endif
     if ((kind != KIND_LOAD_FILE) && (kind != KIND_MEMORY_SETUP))
     {
         local_random[0] = (n_byte2)(randomise >> 16) & 0xffff;
         local_random[1] = (n_byte2)(randomise & 0xffff);
 
-        sim.land->genetics[0] = (n_byte2)(((math_random(local_random) & 255) << 8) | (math_random(local_random) & 255));
-        sim.land->genetics[1] = (n_byte2)(((math_random(local_random) & 255) << 8) | (math_random(local_random) & 255));
+        local_sim->land->genetics[0] = (n_byte2)(((math_random(local_random) & 255) << 8) | (math_random(local_random) & 255));
+        local_sim->land->genetics[1] = (n_byte2)(((math_random(local_random) & 255) << 8) | (math_random(local_random) & 255));
     }
 
     if (kind != KIND_MEMORY_SETUP)
     {
-        land_clear(sim.land, kind, AGE_OF_MATURITY);
+        land_clear(local_sim->land, kind, AGE_OF_MATURITY);
 #ifdef LAND_ON
-        land_init(sim.land , &offbuffer[landbuffer_size]);
+        land_init(local_sim->land , &(local_sim->memory[landbuffer_size]));
 #ifndef SMALL_LAND
-        sim_tide_block(sim.land->map, sim.highres, sim.highres_tide);
+        sim_tide_block(local_sim->land->map, local_sim->highres, local_sim->highres_tide);
 #endif
 #endif
+        food_map_rebuild(local_sim);
+        being_water_rebuild(local_sim);
         if (kind != KIND_LOAD_FILE)
         {
-            n_uint count_to = sim.max >> 2;
+            n_uint count_to = local_sim->max >> 2;
 #ifdef WEATHER_ON
-            weather_init(sim.weather, sim.land);
+            weather_init(local_sim->weather, local_sim->land);
 #endif
-            sim.num = 0;
-            while (sim.num < count_to)
+            local_sim->num = 0;
+            being_space_rebuild(local_sim);
+            being_index_rebuild(local_sim);
+            while (local_sim->num < count_to)
             {
                 (void)math_random(local_random);
-                (void)being_init(&sim, 0L, local_random[0], 1);
+                (void)being_init(local_sim, 0L, local_random[0], 1);
             }
         }
     }
+}
+
+static void sim_release(noble_simulation * local_sim)
+{
+    sim_workers_close(local_sim);
+    file_checkpoint_close(local_sim);
+    sim_indicators_log_close(local_sim);
+    if (local_sim->profile != 0L)
+    {
+        (void)sim_telemetry(local_sim, 0);
+        io_free((void *) local_sim->profile);
+        local_sim->profile = 0L;
+    }
+    being_space_free(local_sim);
+    being_index_free(local_sim);
+    food_map_free(local_sim);
+    being_water_free(local_sim);
+    io_free((void *) local_sim->senses);
+    local_sim->senses = 0L;
+    io_free((void *) local_sim->braincode_steps);
+    local_sim->braincode_steps = 0L;
+    io_free((void *) local_sim->indicators_parts);
+    local_sim->indicators_parts = 0L;
+    io_free((void *) local_sim->brain_rest);
+    local_sim->brain_rest = 0L;
+    io_free((void *) local_sim->slots);
+    local_sim->slots = 0L;
+    io_free((void *) local_sim->memory);
+    local_sim->memory = 0L;
+    interpret_cleanup(local_sim->interpret);
+}
+
+void * sim_init(KIND_OF_USE kind, n_uint randomise, n_uint offscreen_size, n_uint landbuffer_size)
+{
+    if ((kind == KIND_START_UP) || (kind == KIND_MEMORY_SETUP))
+    {
+        if (sim_memory(&sim, offscreen_size) != 0)
+        {
+            return 0L;
+        }
+        offbuffer = sim.memory;
+        sim_tables();
+    }
+
+    sim_start(&sim, kind, randomise, landbuffer_size);
 
 #ifdef THREADED
     if (thread_on == 0)
@@ -1215,6 +2563,7 @@ void * sim_init(KIND_OF_USE kind, n_uint randomise, n_uint offscreen_size, n_uin
     }
 #endif
 
+    sim.watched = 1;
     sim_set_select(0);
 
     return ((void *) offbuffer);
@@ -1229,14 +2578,109 @@ void sim_close(void)
 #ifdef THREADED
     sim_thread_close();
 #endif
-    io_free((void *) offbuffer);
-    interpret_cleanup(interpret);
+    sim_release(&sim);
+    offbuffer = 0L;
+}
+
+/**
+ * Creates a new simulation separate from the default one. Any number of these
+ * can be cycled at the same time on different threads. They have no ApeScript,
+ * no console watch and no graphics, and their indicators are not logged until
+ * their indicators_logging is set.
+ * @param randomise The seed of the new simulation
+ * @return The new simulation or 0L if there is not the memory for it
+ */
+noble_simulation * sim_world_new(n_uint randomise)
+{
+    noble_simulation * local_sim = (noble_simulation *)io_new(sizeof(noble_simulation));
+    if (local_sim == 0L)
+    {
+        return 0L;
+    }
+    io_erase((n_byte *)local_sim, sizeof(noble_simulation));
+    /* the land is made in a scratch area at the start of the memory */
+    if (sim_memory(local_sim, MAP_AREA) != 0)
+    {
+        io_free((void *)local_sim);
+        return 0L;
+    }
+    sim_tables();
+    sim_start(local_sim, KIND_START_UP, randomise, 0);
+    being_select(local_sim, 0);
+    return local_sim;
+}
+
+/**
+ * Cycles a simulation by one minute, timing it when it is profiled or
+ * publishes its telemetry.
+ * @param local_sim The simulation to cycle
+ */
+void sim_world_cycle(noble_simulation * local_sim)
+{
+    noble_profile * local_profile = local_sim->profile;
+    n_uint profile_start = 0;
+    n_byte timed = (n_byte)(local_profile->on || (local_profile->telemetry != 0L));
+
+    if (timed)
+    {
+        profile_start = io_nanoseconds();
+    }
+    if (local_profile->on)
+    {
+        local_profile->beings[local_profile->count % PROFILE_SAMPLES] = local_sim->num;
+    }
+
+    sim_cycle_phases(local_sim, timed);
+
+    if (timed)
+    {
+        (void)sim_profile_mark(local_profile, PROFILE_CYCLE, profile_start);
+    }
+    if (local_profile->telemetry != 0L)
+    {
+        sim_telemetry_publish(local_sim);
+    }
+    if (local_profile->on)
+    {
+        local_profile->count++;
+        if (local_profile->csv && ((local_profile->count % PROFILE_SAMPLES) == 0))
+        {
+            sim_profile_csv(local_sim);
+        }
+    }
+}
+
+/**
+ * Frees a simulation created with sim_world_new.
+ * @param local_sim The simulation to free
+ */
+void sim_world_free(noble_simulation * local_sim)
+{
+    if (local_sim == 0L)
+    {
+        return;
+    }
+    sim_release(local_sim);
+    io_free((void *)local_sim);
+}
+
+/**
+ * Selects a being of a simulation, telling the console when it watches the simulation.
+ * @param local_sim The simulation
+ * @param number The index of the being
+ */
+void sim_world_select(noble_simulation * local_sim, n_uint number)
+{
+    being_select(local_sim, number);
+    if (local_sim->watched)
+    {
+        console_external_watch(local_sim);
+    }
 }
 
 void sim_set_select(n_uint number)
 {
-    sim.select = number;
-    console_external_watch();
+    sim_world_select(&sim, number);
 }
 
 void sim_populations(n_uint	*total, n_uint * female, n_uint * male)
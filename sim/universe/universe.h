@@ -67,7 +67,9 @@
  what these operator sums represent.
  */
 
-static const n_byte	operators[17][6] =
+#define LAND_OPERATORS  (17)
+
+static const n_byte	operators[LAND_OPERATORS][6] =
 {
     /*AHWOUS*/
     "+.....", /* Area */
@@ -139,6 +141,8 @@ enum SECONDARY_APESCRIPT
 
     VARIABLE_TEST_Z,
     VARIABLE_IS_VISIBLE,
+    VARIABLE_WATER_DISTANCE,
+    VARIABLE_WATER_HEADING,
 
     VARIABLE_TIME,
     VARIABLE_DATE,
@@ -452,6 +456,21 @@ const static n_string interval_description[] = { "mins","hours","days","months",
 #define INDICATORS_FREQUENCY                  60
 #define INDICATORS_BUFFER_SIZE                24
 
+/* the columns of the indicator log, and the rows kept before they are written */
+#define INDICATORS_COLUMNS                    41
+#define INDICATORS_LOG_ROWS                   256
+/* rows are also written once they have waited this many milliseconds */
+#define INDICATORS_LOG_MILLISECONDS           10000
+
+/*
+ The binary indicator log is the signature, the column count and the bytes of
+ the column names as n_c_uint, then the names as a CSV header line. Each block
+ after that is a row count as n_c_uint, then each column in turn as a width
+ byte of 1, 2 or 4 and that many values of the width. Numbers are in the byte
+ order of the machine that wrote the log.
+ */
+#define INDICATORS_LOG_SIGNATURE              "NAINDIC1"
+
 /* nature in the range 0-15 from the genetics
    nurture in the range 0-255 from learned preferences.
    Resulting value is in the range 0-15 */
@@ -1142,6 +1161,41 @@ typedef struct
 #endif
 } social_link;
 
+/* the steps after this read past the end of the braincode so they are decoded each time they are reached */
+#define BRAINCODE_STEPS_CACHED  (BRAINCODE_SIZE - BRAINCODE_BYTES_PER_INSTRUCTION)
+
+/*! @struct
+ @field instruction The instruction.
+ @field constants The BRAINCODE_CONSTANT0_BIT and BRAINCODE_CONSTANT1_BIT of the first byte.
+ @field value The two values after the first byte.
+ @field address The address of each value within the two braincode programs of the dialogue.
+ @discussion The decoded instruction that starts at a location within the
+ braincode of a social link.
+ */
+typedef struct
+{
+    n_byte   instruction;
+    n_byte   constants;
+    n_byte   value[2];
+    n_byte   address[2];
+} noble_braincode_step;
+
+/*! @struct
+ @field decoded A bit for each step, set when the step is decoded and cleared when its bytes change.
+ @field step The step that starts at each location of the braincode.
+ @discussion The steps of the braincode of a social link are decoded as the
+ dialogue reaches them and kept until the bytes they were decoded from
+ change. The bits are kept apart from the steps so that marking the steps
+ written by the dialogue stays within one cache line.
+ */
+typedef struct
+{
+    n_c_uint             decoded[BRAINCODE_SIZE >> 5];
+    noble_braincode_step step[BRAINCODE_SIZE];
+} noble_braincode_steps;
+
+#define BRAINCODE_STEP_DECODED(steps, i)    ((steps)->decoded[(i) >> 5] & ((n_c_uint)1 << ((i) & 31)))
+
 
 /*! @struct
  @discussion Describes an episodic memory event
@@ -1292,6 +1346,7 @@ noble_immune_system;
  @field family_name_sd standard deviation of family names
  @field drives average drive values
  @field food Food types consumed
+ @field dormant_brains percentage of brains not cycled as they are at rest
  @discussion structure storing indicator values
  */
 typedef struct
@@ -1331,8 +1386,48 @@ typedef struct
     n_byte2 average_operators;
     n_byte2 average_conditionals;
     n_byte2 average_data;
+    n_byte2 dormant_brains;
 } noble_indicators;
 
+/* the beings are split into this many parts when the indicators are gathered */
+#define INDICATORS_PARTS (16)
+
+/*! @struct
+ @discussion the sums over one contiguous part of the beings from which the
+ indicators are worked out. The means are found from the sums of all the
+ parts before the deviations from them are summed in a second look.
+ */
+typedef struct
+{
+    n_uint age_days;
+    n_uint energy;
+    n_uint first_person;
+    n_uint intentions;
+    n_uint parasites;
+    n_uint dormant_brains;
+    n_uint family[2];
+    n_uint drives[DRIVES];
+    n_uint population_density[8*8];
+    n_uint positive_affect;
+    n_uint negative_affect;
+    n_uint social_links;
+    n_uint cohesion;
+    n_uint familiarity;
+    n_uint amorousness;
+    n_uint genome[8*CHROMOSOMES];
+#ifdef BRAINCODE_ON
+    n_uint braincode[BRAINCODE_SIZE*2];
+    n_uint braincode_kinds[5];
+#endif
+#ifdef IMMUNE_ON
+    n_uint antigens;
+    n_uint antibodies;
+#endif
+    n_uint family_sd;
+    n_uint genetics_sd;
+    n_uint ideology_sd;
+} noble_indicators_part;
+
 typedef struct
 {
     n_byte2	x;
@@ -1410,7 +1505,22 @@ typedef struct
 	n_uint generation[GENERATION_TOTAL];
 	/* temporary father generation value used during gestation */
 	n_uint father_generation;
+}
+noble_being;
 
+/*! @struct
+ @field territory Familiarity and names of the places the being knows.
+ @field immune_system Antigens and antibodies.
+ @field vessel The vascular system.
+ @field metabolism The metabolic substances.
+ @field braincode_register The braincode pspace registers.
+ @field brainprobe The probes between the brain and the braincode.
+ @discussion The larger parts of a being that the cycles over all the beings
+ don't read. They are kept at the brain memory location of the being, apart
+ from noble_being, and found with GET_COLD.
+ */
+typedef struct
+{
 #ifdef TERRITORY_ON
     noble_place territory[TERRITORY_DIMENSION*TERRITORY_DIMENSION];
 #endif
@@ -1426,7 +1536,124 @@ typedef struct
     noble_brain_probe brainprobe[BRAINCODE_PROBES];
 #endif
 }
-noble_being;
+noble_being_cold;
+
+/* a being as it is laid out in files, the being followed by its cold parts */
+typedef struct
+{
+    noble_being      being;
+    noble_being_cold cold;
+}
+noble_being_file;
+
+/*! @struct
+ @field opposite_sex Array index of the closest being of the opposite sex in sight.
+ @field same_sex Array index of the closest being of the same sex in sight.
+ @field opposite_sex_distance Squared distance to the opposite sex being.
+ @field same_sex_distance Squared distance to the same sex being.
+ @field beings_in_vicinity The number of beings nearby.
+ @field heard Non zero if a shout was heard.
+ @field shout The content and family names of the shout heard.
+ @discussion What a being senses of the other beings at the start of the being
+ cycle, before any of the beings act, when the beings are cycled with threads.
+ A being born during the cycle senses as it acts.
+ */
+typedef struct
+{
+    n_uint opposite_sex;
+    n_uint same_sex;
+    n_uint opposite_sex_distance;
+    n_uint same_sex_distance;
+    n_byte beings_in_vicinity;
+    n_byte heard;
+    n_byte shout[3];
+}
+noble_senses;
+
+#define BRAIN_ACTIVE    (0)
+#define BRAIN_SETTLING  (1)
+#define BRAIN_DORMANT   (2)
+
+/*! @struct
+ @field constants The brain constants used for the last brain cycle.
+ @field state BRAIN_ACTIVE, BRAIN_SETTLING when the last cycle left the brain
+ and the previous brain equal, or BRAIN_DORMANT when a cycle has not changed
+ the brain at all.
+ @discussion A dormant brain is at a fixed point of the brain cycle and is not
+ cycled until its constants change or something writes to it.
+ */
+typedef struct
+{
+    n_byte2 constants[3];
+    n_byte2 state;
+}
+noble_brain_rest;
+
+/* the generation bits of a being identity, which keep it from being NO_BEINGS_FOUND */
+#define BEING_ID_GENERATION  (0x7fff)
+
+/*! @struct
+ @field index The index of the being with this brain memory location, num or
+ more when no being alive has it.
+ @field generation Changes each time the being with this location dies, it is
+ part of the being identity.
+ @discussion There is one for each brain memory location.
+ */
+typedef struct
+{
+    n_uint index;
+    n_uint generation;
+}
+noble_being_slot;
+
+/* the phases of the cycle that can be run less often than every minute */
+enum SIM_SCHEDULE_PHASES
+{
+    SCHEDULE_WEATHER = 0,
+    SCHEDULE_SOCIAL,
+    SCHEDULE_EPISODIC,
+    SCHEDULE_METABOLISM,
+    SCHEDULE_IMMUNE,
+    SCHEDULE_INDICATORS,
+    SCHEDULE_SLEEP,
+    SCHEDULE_PHASES
+};
+
+/* the fidelity profiles, each a set of periods and offsets for all the phases */
+enum SIM_SCHEDULE_PROFILES
+{
+    SCHEDULE_FULL = 0,
+    SCHEDULE_FAST,
+    SCHEDULE_PROFILES
+};
+
+/* the longest period, a day in minutes */
+#define SCHEDULE_PERIOD_MAX     (TIME_DAY_MINUTES)
+
+/*! @struct
+ @field period The minutes between each run of the phase, 1 runs it every minute.
+ @field offset The minute within the period the phase runs on.
+ @discussion The periods are counted in minutes since the start of the land date,
+ so a schedule gives the same cycles after it is saved and loaded.
+ */
+typedef struct
+{
+    n_byte2 period[SCHEDULE_PHASES];
+    n_byte2 offset[SCHEDULE_PHASES];
+}
+noble_schedule;
+
+/* is the scheduled phase run this cycle */
+#define SIM_SCHEDULED(sim, phase)   (((sim)->scheduled >> (phase)) & 1)
+
+/* is this the minute a fully asleep being has its brain probes, brain and dialogue cycled, each has its turn once a sleep period and the minutes between are not made up */
+#define SIM_SLEEP_TURN(sim, bei)    (((bei)->brain_memory_location % (sim)->schedule.period[SCHEDULE_SLEEP]) == (sim)->sleep_turn)
+
+/* the state of a simulation kept in the translation unit that uses it */
+typedef struct noble_workers    noble_workers;
+typedef struct noble_checkpoint noble_checkpoint;
+typedef struct noble_log        noble_log;
+typedef struct noble_profile    noble_profile;
 
 typedef void (being_birth_event)(noble_being * born, noble_being * mother, void * sim);
 typedef void (being_death_event)(noble_being * deceased, void * sim);
@@ -1437,8 +1664,10 @@ typedef void (being_death_event)(noble_being * deceased, void * sim);
  @field beings The noble_being pointer.
  @field num The number of beings currently active.
  @field max The maximum number of beings that could be active.
- @field select The current selected ape being shown through the GUI.
+ @field select The identity, from being_id, of the selected ape being shown
+ through the GUI and watched from the console.
  @field someone_speaking Is a Noble Ape speaking?
+ @field watched The console watches this simulation and follows its selection.
  @discussion This is the highest level of collected Noble Ape Simulation stuff.
  It is primarily used by the GUI layer to address down into the Core layer.
  */
@@ -1452,8 +1681,9 @@ typedef struct
     n_uint	        num;
     n_uint	        max;
 
-    n_uint          select;	 /* used by gui */
+    n_uint          select;	 /* used by gui, a being identity */
     n_byte          someone_speaking;
+    n_byte          watched;
 
     n_uint          real_time;
     n_uint          last_time;
@@ -1463,14 +1693,55 @@ typedef struct
     n_byte        * brain_base;
     social_link   * social_base;
     episodic_memory * episodic_base;
+    noble_being_cold * cold_base; /* one for each brain memory location */
+
+    n_c_int       * food_map; /* land terms of each of the LAND_OPERATORS, MAP_AREA each */
+    n_byte        * water_field[LAND_TIDE_LEVELS]; /* made when first used, 2 * MAP_AREA each */
 
     n_uint          indicator_index;
     n_uint          indicators_logging;
+    n_byte          indicators_binary; /* the format of indicator logs opened from now on */
+    noble_log     * indicators_log;    /* made when the indicator log is opened */
     noble_indicators * indicators_base;
+    noble_indicators_part * indicators_parts; /* INDICATORS_PARTS and their total */
 
     being_birth_event * ext_birth;
     being_death_event * ext_death;
 
+    n_uint        * space_head; /* first being index in each spatial cell */
+    n_uint        * space_next; /* next being index in the same spatial cell */
+    n_uint          space_num;  /* beings indexed, NO_BEINGS_FOUND when stale */
+
+    n_uint        * name_index;   /* being index for each name */
+    n_uint        * name_next;    /* the next being with the same name, for each being */
+    n_uint        * name_last;    /* the last being with the name, for each slot of the name index */
+    n_uint        * female_index; /* being index for the genetics of each female */
+    n_uint          index_size;   /* slots in each index, a power of two */
+    n_uint          index_num;    /* beings indexed, NO_BEINGS_FOUND when stale */
+
+    n_uint          threads;    /* zero senses and cycles each being in turn on the calling thread */
+    noble_workers * workers;    /* the threads working the parts after the first, made by sim_threads */
+    noble_senses  * senses;
+    n_uint          senses_num; /* beings sensed at the start of the being cycle */
+
+    noble_braincode_steps * braincode_steps; /* for the braincode of each social link */
+
+    noble_brain_rest * brain_rest; /* one for each brain memory location */
+    noble_being_slot * slots;      /* one for each brain memory location */
+
+    n_c_uint        weather_rows[MAP_DIMENSION/(4*WEATHER_BLOCK)]; /* pressure from each pair of triangle blocks */
+
+    noble_schedule  schedule;
+    n_uint          scheduled;   /* bit for each SIM_SCHEDULE_PHASES run this cycle */
+    n_uint          sleep_turn;  /* the brain memory locations, modulo the sleep period, cycled in full this minute */
+
+    n_byte        * memory;      /* the single allocation the simulation lives in */
+    n_interpret   * interpret;   /* ApeScript run by the awake beings */
+    n_byte          braindisplay;
+
+    noble_profile    * profile;    /* the time each phase of the cycle took and the telemetry */
+    noble_checkpoint * checkpoint; /* the checkpoint being written in the background */
+
 #ifndef SMALL_LAND
     n_byte   *highres;
     n_c_uint *highres_tide;
@@ -1481,8 +1752,21 @@ noble_simulation;
 
 /* macros defined to ease in the vectorised code */
 
+#define GET_COLD(sim,bei) (&((sim)->cold_base[(bei)->brain_memory_location]))
+
+#ifdef TERRITORY_ON
+#define GET_T(sim,bei)   (GET_COLD(sim,bei)->territory)
+#endif
+#ifdef IMMUNE_ON
+#define GET_IM(sim,bei)  (&(GET_COLD(sim,bei)->immune_system))
+#endif
 #ifdef METABOLISM_ON
-#define	GET_MT(bei,index) ((bei)->metabolism[index])
+#define GET_V(sim,bei)   (GET_COLD(sim,bei)->vessel)
+#define	GET_MT(sim,bei,index) (GET_COLD(sim,bei)->metabolism[index])
+#endif
+#ifdef BRAINCODE_ON
+#define GET_BR(sim,bei)  (GET_COLD(sim,bei)->braincode_register)
+#define GET_BP(sim,bei)  (GET_COLD(sim,bei)->brainprobe)
 #endif
 #define GET_A(bei,index) ((bei)->attention[index])
 #define	GET_F(bei)	((bei)->facing)
@@ -1565,16 +1849,63 @@ n_int     sim_filein(n_byte * buff, n_uint len);
 n_byte *  sim_fileout(n_uint * len);
 
 /* This is the new way. Please continue forwards. */
-n_file *  file_out(void);
-n_int     file_in(n_file * input_file);
+n_file *  file_out(noble_simulation * local_sim);
+n_int     file_in(noble_simulation * local_sim, n_file * input_file);
 n_int     file_interpret(n_file * input_file);
 
 
 void	  sim_close(void);
 void	  sim_populations(n_uint	*total, n_uint * female, n_uint * male);
 
-n_int     file_bin_read(n_string name);
-n_int     file_bin_write(n_string name);
+n_int     file_bin_read(noble_simulation * local_sim, n_string name);
+n_int     file_bin_write(noble_simulation * local_sim, n_string name);
+
+/* the sections of a simulation snapshot */
+enum SNAPSHOT_SECTION_ID
+{
+    SNAPSHOT_SIMULATION = 1,
+    SNAPSHOT_LAND,
+    SNAPSHOT_MAP,
+    SNAPSHOT_WEATHER,
+    SNAPSHOT_BEINGS,
+    SNAPSHOT_SOCIAL,
+    SNAPSHOT_EPISODIC,
+    SNAPSHOT_BRAIN,
+    SNAPSHOT_INDICATORS,
+    SNAPSHOT_CHAIN,
+    SNAPSHOT_COLD,
+
+    /* the changed pages of a section, with the section id added */
+    SNAPSHOT_DELTA = 256
+};
+
+typedef struct
+{
+    n_uint num;
+    n_uint max;
+    n_uint select; /* the index of the selected being */
+    n_uint indicator_index;
+    noble_schedule schedule;
+}
+noble_snapshot_simulation;
+
+/* checkpoints are a base snapshot and numbered deltas of the same chain */
+typedef struct
+{
+    n_uint chain;
+    n_uint sequence;
+}
+noble_snapshot_chain;
+
+n_int     file_snapshot_write(noble_simulation * local_sim, n_string name);
+n_int     file_snapshot_read(noble_simulation * local_sim, n_string name);
+
+n_int     file_checkpoint_write(noble_simulation * local_sim, n_string name);
+noble_checkpoint * file_checkpoint_new(void);
+n_int     file_checkpoint_report(noble_simulation * local_sim, n_string output);
+n_int     file_checkpoint_busy(noble_simulation * local_sim, n_byte wait);
+void      file_checkpoint_close(noble_simulation * local_sim);
+n_int     file_checkpoint_compact(noble_simulation * local_sim, n_string name);
 
 noble_simulation * sim_sim(void);
 
@@ -1585,8 +1916,95 @@ void sim_healthy_carrier(void);
 void sim_realtime(n_uint time);
 
 void sim_set_select(n_uint number);
+void sim_world_select(noble_simulation * local_sim, n_uint number);
 
-void sim_debug_csv(n_file * fil, n_byte initial);
+#define SIM_THREADS_MAX  (64)
+
+typedef void (sim_work)(noble_simulation * local_sim, n_uint start, n_uint end);
+
+void sim_parallel(noble_simulation * local_sim, sim_work * function, n_uint total);
+void sim_weather(noble_simulation * local_sim);
+void sim_threads(noble_simulation * local_sim, n_uint count);
+
+void     sim_schedule_profile(noble_schedule * schedule, n_int profile);
+void     sim_schedule_check(noble_schedule * schedule);
+n_int    sim_schedule_set(noble_simulation * local_sim, n_int phase, n_uint period, n_uint offset);
+n_string sim_schedule_name(n_int phase);
+n_int    sim_schedule_find(n_string name);
+
+noble_simulation * sim_world_new(n_uint randomise);
+void sim_world_cycle(noble_simulation * local_sim);
+void sim_world_free(noble_simulation * local_sim);
+
+enum SIM_PROFILE_PHASES
+{
+    PROFILE_LAND = 0,
+    PROFILE_BEING,
+    PROFILE_WEATHER,
+    PROFILE_BRAIN,
+    PROFILE_DIALOGUE,
+    PROFILE_TIDY,
+    PROFILE_REMOVE,
+    PROFILE_SOCIAL,
+    PROFILE_INDICATORS,
+    PROFILE_CYCLE,
+    PROFILE_PHASES
+};
+
+/* the number of cycles the profile statistics are taken over */
+#define PROFILE_SAMPLES  (128)
+
+/* the shared memory the running simulation publishes its telemetry to */
+#define TELEMETRY_NAME       "/nobleape_telemetry"
+#define TELEMETRY_SIGNATURE  "NATELEM1"
+
+/*! @struct
+ @field signature TELEMETRY_SIGNATURE once the telemetry is ready to read.
+ @field bytes The size of this structure, a reader built differently must not read it.
+ @field sequence Odd while the simulation is writing, read it before and after copying
+ the rest and only use the copy when both are the same even number.
+ @field cycles The cycles published.
+ @field date The land date.
+ @field time The land time.
+ @field population The beings alive.
+ @field max The most beings there could be.
+ @field phase Nanoseconds each phase of the last cycle took.
+ @field indicator_index The index of the next indicators, the ones before it are complete.
+ @field indicators_complete The complete indicators published.
+ @field indicators A copy of the simulation indicators ring.
+ @discussion Written once a cycle by the simulation and read by other processes
+ without either waiting on the other.
+ */
+typedef struct
+{
+    n_byte   signature[8];
+    n_uint   bytes;
+    volatile n_uint sequence;
+    n_uint   cycles;
+    n_uint   date;
+    n_uint   time;
+    n_uint   population;
+    n_uint   max;
+    n_uint   phase[PROFILE_PHASES];
+    n_uint   indicator_index;
+    n_uint   indicators_complete;
+    noble_indicators indicators[INDICATORS_BUFFER_SIZE];
+} noble_telemetry;
+
+void sim_profile(noble_simulation * local_sim, n_byte on, n_byte csv);
+n_int sim_telemetry(noble_simulation * local_sim, n_byte on);
+n_int sim_telemetry_read(noble_telemetry * shared, noble_telemetry * copy);
+
+n_string sim_indicators_log_name(n_int column);
+void sim_indicators_log_format(noble_simulation * local_sim, n_byte binary);
+void sim_indicators_log_flush(noble_simulation * local_sim);
+void sim_indicators_log_close(noble_simulation * local_sim);
+void sim_indicators_values(noble_indicators * indicators, n_c_uint * values);
+void sim_profile_output(noble_simulation * local_sim, n_console_output output_function);
+n_string sim_profile_name(n_int phase);
+n_uint sim_profile_statistics(noble_simulation * local_sim, n_int phase, n_uint * statistics);
+
+void sim_debug_csv(noble_simulation * local_sim, n_file * fil, n_byte initial);
 
 void sim_braindisplay(n_byte newval);
 
@@ -1623,10 +2041,18 @@ n_int console_top(void * ptr, n_string response, n_console_output output_functio
 n_int console_epic(void * ptr, n_string response, n_console_output output_function);
 n_int console_file(void * ptr, n_string response, n_console_output output_function);
 n_int console_event(void * ptr, n_string response, n_console_output output_function);
+n_int console_threads(void * ptr, n_string response, n_console_output output_function);
+n_int console_schedule(void * ptr, n_string response, n_console_output output_function);
+n_int console_profile(void * ptr, n_string response, n_console_output output_function);
+n_int console_telemetry(void * ptr, n_string response, n_console_output output_function);
 
 
 n_int console_save(void * ptr, n_string response, n_console_output output_function);
 n_int console_open(void * ptr, n_string response, n_console_output output_function);
+n_int console_snapshot(void * ptr, n_string response, n_console_output output_function);
+n_int console_restore(void * ptr, n_string response, n_console_output output_function);
+n_int console_checkpoint(void * ptr, n_string response, n_console_output output_function);
+n_int console_compact(void * ptr, n_string response, n_console_output output_function);
 n_int console_script(void * ptr, n_string response, n_console_output output_function);
 
 n_int console_quit(void * ptr, n_string response, n_console_output output_function);
@@ -1670,9 +2096,13 @@ const static noble_console_command control_commands[] =
 
     {&console_open,          "open",           "[file]",               "Load a simulation file"},
     {&console_open,          "load",           "",                     ""},
+    {&console_restore,       "restore",        "[file]",               "Load a binary snapshot of the simulation"},
 #endif
     {&console_script,        "script",         "[file]",               "Load an ApeScript simulation file"},
     {&console_save,          "save",           "[file]",               "Save a simulation file"},
+    {&console_snapshot,      "snapshot",       "[file]",               "Save a binary snapshot of the simulation"},
+    {&console_checkpoint,    "checkpoint",     "[file] (time format)|off", "Snapshot in the background, then deltas to it, every time interval"},
+    {&console_compact,       "compact",        "[file]",               "Fold the checkpoint deltas into the checkpoint file"},
 
     {&console_quit,               "quit",           "",                     "Quits the console"},
     {&console_quit,               "exit",           "",                     ""},
@@ -1695,6 +2125,7 @@ const static noble_console_command control_commands[] =
 
     {&console_speak,         "speak",          "[file]",               "Create an AIFF file of Noble Ape speech"},
     {&console_alphabet,      "alpha",          "[file]",               "Create an AIFF file of Noble Ape alphabet"},
+    {&console_profile,       "profile",        "on|csv|off",           "Time each phase of the simulation cycle, show with no arguments"},
     {&console_file,          "file",           "[(component)]",        "Information on the file format"},
     {&console_run,           "run",            "(time format)|forever","Simulate for a given number of days or forever"},
     {&console_step,          "step",           "",                     "Run for a single logging interval"},
@@ -1702,7 +2133,10 @@ const static noble_console_command control_commands[] =
     {&console_epic,          "epic",           "",                     "List the most talked about apes"},
     {&console_interval,      "interval",       "(days)",               "Set the simulation logging interval in days"},
     {&console_event,         "event",          "on|social|off",        "Episodic events (all) on, social on or all off"},
-    {&console_logging,       "logging",        "on|off",               "Turn logging of images and data on or off"},
+    {&console_threads,       "threads",        "(number)",             "Number of threads used to cycle the beings, 0 for none"},
+    {&console_schedule,      "schedule",       "full|fast|(phase) (minutes) (offset)", "How often the slowly changing phases run, show with no arguments"},
+    {&console_telemetry,     "telemetry",      "on|off",               "Publish the indicators and phase timings to shared memory"},
+    {&console_logging,       "logging",        "on|off|csv|binary",    "Turn logging of images and data on or off, or set the indicator format"},
     {&console_logging,       "log",            "",                     ""},
     {&console_simulation,    "simulation",     "",                     ""},
     {&console_simulation,    "sim",            "",                     "Show simulation parameters"},
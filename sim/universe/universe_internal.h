@@ -45,6 +45,7 @@
 #define USE_FIL_BEI
 #define USE_FIL_SOE
 #define USE_FIL_EPI
+#define USE_FIL_SCH
 #undef USE_FIL_WEA
 #undef USE_FIL_BRA
 
@@ -135,7 +136,7 @@
 
 #define OFFSET_BRAINCODE	(OFFSET_METABOLISM+METABOLISM_BYTES)
 
-#define	NON_PTR_BEING		(sizeof(noble_being))
+#define	NON_PTR_BEING		(sizeof(noble_being_file))
 #define	NON_PTR_LAND		(11)
 
 #define	LARGEST_INIT_PTR	((NON_PTR_BEING > NON_PTR_LAND) ? NON_PTR_BEING : NON_PTR_LAND)
@@ -148,6 +149,7 @@
 #define FIL_WEA (0x60)
 #define FIL_BRA (0x70)
 #define FIL_END (0x80)
+#define FIL_SCH (0x90)
 
 
 const static noble_file_entry noble_file_format[]=
@@ -172,6 +174,12 @@ const static noble_file_entry noble_file_format[]=
     {{'p', 'r', 'e', 's', 's', '='}, FIL_WEA | FILE_TYPE_BYTE,    sizeof(n_c_int),    0},
 #endif
 
+#ifdef USE_FIL_SCH
+    {{'s', 'c', 'h', 'e', 'd', '{'}, FIL_SCH,  0, 0, "Schedule of the cycle phases"},
+    {{'p', 'e', 'r', 'i', 'o', '='}, FIL_SCH | FILE_TYPE_BYTE2, SCHEDULE_PHASES, 0, "Minutes between each run of the phases"},
+    {{'p', 'h', 'a', 's', 'e', '='}, FIL_SCH | FILE_TYPE_BYTE2, SCHEDULE_PHASES, (SCHEDULE_PHASES*2), "Minute within the period each phase runs on"},
+#endif
+
 #ifndef REDUCE_FILE /* FILE_TYPE_PACKED has a different form - no offset and the number is the size of the PACKED_DATA_BLOCK units */
     /*	{{'a', 't', 'm', 'o', 's', '='}, FIL_WEA | DONTFILE_TYPE_PACKED, ((sizeof(n_c_int) * MAP_AREA) / (PACKED_DATA_BLOCK*2)), 1},*/
 #endif
@@ -317,7 +325,7 @@ n_int sketch_output(void * vcode, n_byte * kind, n_int * number);
 void sim_end_conditions(void * code, void * structure, n_int identifier);
 void sim_start_conditions(void * code, void * structure, n_int identifier);
 
-void console_external_watch(void);
+void console_external_watch(noble_simulation * local_sim);
 
 n_int console_executing(void);
 